@@ -0,0 +1,246 @@
+/**
+ * @file AllocationTracker.cpp
+ * @brief Implementation of the allocation counters and, with MOMMYGLIDER_ALLOC_TRACKING, of the
+ * counting global operator new/delete and, in debug builds, of the CRT allocation hook.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#if defined(MOMMYGLIDER_ALLOC_TRACKING) && defined(_WIN32) && defined(_DEBUG)
+#include <crtdbg.h>
+#define MOMMYGLIDER_CRT_ALLOC_HOOK
+#endif
+#include "AllocationTracker.h"
+#include "MetricsServer.h"
+
+namespace {
+
+    // Over-budget frames reported one by one per stage; later ones are only counted
+    constexpr uint64_t MAX_REPORTS = 10;
+
+    struct StageStats {
+        std::atomic<uint64_t> frames{ 0 };         // Frames seen, warm-up included
+        std::atomic<uint64_t> checked{ 0 };        // Frames compared with the budget
+        std::atomic<uint64_t> overBudget{ 0 };
+        std::atomic<uint64_t> maxAllocations{ 0 }; // Worst checked frame
+    };
+
+    const char* const STAGE_NAMES[] = { "capture", "tick" };
+    static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<int>(AllocationTracker::Stage::Count),
+        "Every stage needs a name");
+
+    StageStats stages[static_cast<int>(AllocationTracker::Stage::Count)];
+
+    // Written by configure() before `configured` is released
+    uint64_t frameBudget = 0;
+    uint64_t warmup = 0;
+    uint64_t target = 0;
+    std::atomic<bool> configured{ false };
+
+    // Plain thread_local integer: operator new may run before or after any constructor
+    thread_local uint64_t allocationCount = 0;
+
+#ifdef MOMMYGLIDER_CRT_ALLOC_HOOK
+    // The debug CRT reports every malloc, calloc, realloc and _aligned_malloc to the hook,
+    // operator new's included, so nothing else counts in this build
+    constexpr bool COUNTED_BY_CRT = true;
+
+    int __cdecl countCrtAllocation(int allocType, void*, size_t, int, long, const unsigned char*, int) {
+        if (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC) {
+            ++allocationCount;
+        }
+        return TRUE;
+    }
+
+    // Installed during static initialization; earlier allocations fall before any frame
+    const _CRT_ALLOC_HOOK previousCrtHook = _CrtSetAllocHook(countCrtAllocation);
+#else
+    constexpr bool COUNTED_BY_CRT = false;
+#endif
+
+} // namespace
+
+#ifdef MOMMYGLIDER_ALLOC_TRACKING
+
+namespace {
+
+    void* allocate(size_t size) {
+        if (!COUNTED_BY_CRT) {
+            ++allocationCount;
+        }
+        return std::malloc(size ? size : 1);
+    }
+
+    void* allocateAligned(size_t size, std::align_val_t alignment) {
+        if (!COUNTED_BY_CRT) {
+            ++allocationCount;
+        }
+        size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc wants a multiple of the alignment
+        return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+    }
+
+    void release(void* ptr) {
+        std::free(ptr);
+    }
+
+    void releaseAligned(void* ptr) {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (void* block = allocate(size)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* block = allocateAligned(size, alignment)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { releaseAligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(ptr); }
+
+#endif // MOMMYGLIDER_ALLOC_TRACKING
+
+uint64_t AllocationTracker::threadAllocations() {
+    return allocationCount;
+}
+
+void AllocationTracker::countSystemAllocation() {
+    if (ENABLED && !COUNTED_BY_CRT) {
+        ++allocationCount;
+    }
+}
+
+void AllocationTracker::configure(uint64_t budget, uint64_t warmupFrames, uint64_t checkedFrames) {
+    frameBudget = budget;
+    warmup = warmupFrames;
+    target = checkedFrames;
+    configured.store(true, std::memory_order_release);
+}
+
+void AllocationTracker::checkFrame(Stage stage, uint64_t allocations) {
+    if (!configured.load(std::memory_order_acquire)) {
+        return;
+    }
+    StageStats& stats = stages[static_cast<int>(stage)];
+    if (stats.frames.fetch_add(1, std::memory_order_relaxed) < warmup) {
+        return;
+    }
+    stats.checked.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t worst = stats.maxAllocations.load(std::memory_order_relaxed);
+    while (allocations > worst && !stats.maxAllocations.compare_exchange_weak(worst, allocations, std::memory_order_relaxed)) {
+    }
+    if (allocations <= frameBudget) {
+        return;
+    }
+    if (stats.overBudget.fetch_add(1, std::memory_order_relaxed) < MAX_REPORTS) {
+        std::cerr << "Warning: A " << STAGE_NAMES[static_cast<int>(stage)] << " frame made " << allocations
+            << " heap allocations (budget " << frameBudget << ").\n";
+    }
+}
+
+bool AllocationTracker::finished() {
+    if (!configured.load(std::memory_order_acquire) || target == 0) {
+        return false;
+    }
+    for (const StageStats& stats : stages) {
+        if (stats.checked.load(std::memory_order_relaxed) < target) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AllocationTracker::passed() {
+    for (const StageStats& stats : stages) {
+        if (stats.overBudget.load(std::memory_order_relaxed) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AllocationTracker::report() {
+    for (int stage = 0; stage < static_cast<int>(Stage::Count); ++stage) {
+        const StageStats& stats = stages[stage];
+        std::cout << "Allocation check, " << STAGE_NAMES[stage] << ": "
+            << stats.checked.load(std::memory_order_relaxed) << " frames checked, "
+            << stats.overBudget.load(std::memory_order_relaxed) << " over the budget of " << frameBudget
+            << ", worst frame " << stats.maxAllocations.load(std::memory_order_relaxed) << " allocations.\n";
+    }
+    std::cout << (passed() ? "Allocation check passed.\n" : "Allocation check FAILED.\n");
+}
+
+void AllocationTracker::collectMetrics(MetricsWriter& metrics) {
+    if (!configured.load(std::memory_order_acquire)) {
+        return;
+    }
+    metrics.gauge("mommyglider_alloc_frame_budget", "Heap allocations allowed per checked frame.",
+        static_cast<double>(frameBudget));
+    for (int stage = 0; stage < static_cast<int>(Stage::Count); ++stage) {
+        const StageStats& stats = stages[stage];
+        std::string label = std::string("stage=\"") + STAGE_NAMES[stage] + "\"";
+        metrics.counter("mommyglider_alloc_frames_checked_total", "Frames compared with the allocation budget after warm-up.",
+            static_cast<double>(stats.checked.load(std::memory_order_relaxed)), label);
+        metrics.counter("mommyglider_alloc_frames_over_budget_total", "Checked frames that made more heap allocations than the budget.",
+            static_cast<double>(stats.overBudget.load(std::memory_order_relaxed)), label);
+        metrics.gauge("mommyglider_alloc_frame_max", "Most heap allocations made by one checked frame.",
+            static_cast<double>(stats.maxAllocations.load(std::memory_order_relaxed)), label);
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file AllocationTracker.h
+ * @brief Heap allocation counting for proving that capture, decode and tick stop allocating.
+ *
+ * Built with MOMMYGLIDER_ALLOC_TRACKING, AllocationTracker.cpp replaces the global operator
+ * new/delete and counts every allocation on the allocating thread; LuaAllocator adds the blocks it
+ * takes from malloc. Lua blocks served from the allocator's free lists are not heap allocations and
+ * are not counted. The capture thread and the script engine check each frame's count against a
+ * budget once configure() is called: after the warm-up frames, a frame over the budget is reported
+ * and fails the run. Without the define nothing is replaced and every count is 0.
+ *
+ * What is counted depends on the CRT. With the debug CRT (_DEBUG on Windows) an allocation hook
+ * counts every malloc, calloc, realloc and _aligned_malloc, including those inside operator new and
+ * those made by third-party code. Release builds and other platforms have no such hook: there only
+ * operator new and LuaAllocator are counted, and a direct malloc or _aligned_malloc elsewhere goes
+ * unseen. No build sees HeapAlloc, VirtualAlloc or other Win32 heaps. Run the check on a Debug
+ * build to cover the C heap.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstdint>
+
+class MetricsWriter;
+
+/**
+ * @class AllocationTracker
+ * @brief Process-wide allocation counters and the per-frame budget check.
+ */
+class AllocationTracker {
+public:
+#ifdef MOMMYGLIDER_ALLOC_TRACKING
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    /**
+     * @brief Pipeline stage a frame's allocations are charged to.
+     */
+    enum class Stage {
+        Capture,    ///< Screen copy and decode of one frame, on the capture and decode threads
+        Tick,       ///< One script tick, including scheduler tasks and the capture interest update
+        Count
+    };
+
+    /**
+     * @brief Heap allocations made by the calling thread so far.
+     */
+    static uint64_t threadAllocations();
+
+    /**
+     * @brief Counts a malloc/realloc made outside operator new, e.g. by LuaAllocator. A no-op where
+     * the CRT hook already counts it.
+     */
+    static void countSystemAllocation();
+
+    /**
+     * @brief Starts checking frames.
+     * @param budget Heap allocations allowed per frame of each stage.
+     * @param warmupFrames Frames of each stage that are not checked, while caches and pools fill.
+     * @param checkedFrames Frames of each stage to check before finished() is true; 0 checks forever.
+     */
+    static void configure(uint64_t budget, uint64_t warmupFrames, uint64_t checkedFrames);
+
+    /**
+     * @brief Charges one frame's allocations to `stage`; over-budget frames are reported.
+     */
+    static void checkFrame(Stage stage, uint64_t allocations);
+
+    /**
+     * @brief True once every stage checked its configured number of frames.
+     */
+    static bool finished();
+
+    /**
+     * @brief True if no checked frame exceeded the budget.
+     */
+    static bool passed();
+
+    /**
+     * @brief Prints the frames checked, the frames over budget and the worst frame of each stage.
+     */
+    static void report();
+
+    static void collectMetrics(MetricsWriter& metrics);
+};
+
+#endif // ALLOCATIONTRACKER_H
@@ -0,0 +1,253 @@
+/**
+ * @file BytecodeCache.cpp
+ * @brief Implementation of the Lua bytecode cache.
+ *
+ * The source is still read on every load to verify its hash, so a cache hit costs one file
+ * read, one hash and one mapped undump instead of a full parse.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <windows.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include "BytecodeCache.h"
+#include "MetricsServer.h"
+#include "Util.h"
+extern "C" {
+#include "lauxlib.h"
+}
+
+namespace {
+    constexpr char CACHE_MAGIC[8] = "MGLUAC1";
+}
+
+// Constructor
+BytecodeCache::BytecodeCache(const std::string& cacheDirectory) : directory(cacheDirectory) {}
+
+int BytecodeCache::load(lua_State* L, const std::string& filePath) {
+    int64_t start = monotonicNanos();
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file) {
+        return luaL_loadfile(L, filePath.c_str()); // Let Lua report the error
+    }
+    std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Match luaL_loadfile: skip a UTF-8 BOM and a leading '#' line, keeping line numbers
+    size_t offset = 0;
+    if (source.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        offset = 3;
+    }
+    if (offset < source.size() && source[offset] == '#') {
+        while (offset < source.size() && source[offset] != '\n') {
+            ++offset;
+        }
+    }
+    const char* text = source.data() + offset;
+    size_t textSize = source.size() - offset;
+
+    std::error_code error;
+    auto mtime = std::filesystem::last_write_time(filePath, error);
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.luaVersion = LUA_VERSION_RELEASE_NUM;
+    header.sourceHash = hashSource(text, textSize);
+    header.sourceSize = textSize;
+    header.sourceMtime = error ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count());
+
+    std::string chunkName = "@" + filePath;
+    std::string cachePath = cachePathFor(filePath);
+
+    if (loadShared(L, cachePath, chunkName, header)) {
+        sharedHits.fetch_add(1, std::memory_order_relaxed);
+        loadNs.fetch_add(static_cast<uint64_t>(monotonicNanos() - start), std::memory_order_relaxed);
+        return LUA_OK;
+    }
+
+    if (loadCached(L, cachePath, chunkName, header)) {
+        hits.fetch_add(1, std::memory_order_relaxed);
+        loadNs.fetch_add(static_cast<uint64_t>(monotonicNanos() - start), std::memory_order_relaxed);
+        return LUA_OK;
+    }
+
+    misses.fetch_add(1, std::memory_order_relaxed);
+    int status = luaL_loadbufferx(L, text, textSize, chunkName.c_str(), "t");
+    if (status == LUA_OK) {
+        std::string bytecode;
+        if (lua_dump(L, writeChunk, &bytecode, 0) == 0) {
+            header.payloadSize = static_cast<uint32_t>(bytecode.size());
+            store(cachePath, header, bytecode);
+            share(cachePath, header, std::move(bytecode));
+        }
+    }
+    loadNs.fetch_add(static_cast<uint64_t>(monotonicNanos() - start), std::memory_order_relaxed);
+    return status;
+}
+
+/**
+ * @brief Loads a chunk another state already read or compiled, if it matches the current source.
+ *
+ * @return True if the chunk was pushed onto the stack.
+ */
+bool BytecodeCache::loadShared(lua_State* L, const std::string& cachePath, const std::string& chunkName, const CacheHeader& expected) {
+    std::shared_ptr<const SharedChunk> chunk;
+    {
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        auto it = shared.find(cachePath);
+        if (it == shared.end()) {
+            return false;
+        }
+        chunk = it->second;
+    }
+    if (!sameSource(chunk->header, expected)) {
+        return false;
+    }
+    if (luaL_loadbufferx(L, chunk->bytecode.data(), chunk->bytecode.size(), chunkName.c_str(), "b") != LUA_OK) {
+        lua_pop(L, 1);
+        return false;
+    }
+    return true;
+}
+
+void BytecodeCache::share(const std::string& cachePath, const CacheHeader& header, std::string bytecode) {
+    auto chunk = std::make_shared<SharedChunk>();
+    chunk->header = header;
+    chunk->bytecode = std::move(bytecode);
+
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    shared[cachePath] = std::move(chunk);
+}
+
+/**
+ * @brief Maps a cached chunk and loads it if its header matches the current source.
+ *
+ * @return True if the chunk was pushed onto the stack.
+ */
+bool BytecodeCache::loadCached(lua_State* L, const std::string& cachePath, const std::string& chunkName, const CacheHeader& expected) {
+    HANDLE file = CreateFileA(cachePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(CacheHeader))) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+
+    const char* view = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (!view) {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, view, sizeof(header));
+
+    bool loaded = false;
+    if (sameSource(header, expected) &&
+        header.payloadSize == fileSize.QuadPart - static_cast<LONGLONG>(sizeof(CacheHeader))) {
+        if (luaL_loadbufferx(L, view + sizeof(CacheHeader), header.payloadSize, chunkName.c_str(), "b") == LUA_OK) {
+            loaded = true;
+            share(cachePath, header, std::string(view + sizeof(CacheHeader), header.payloadSize));
+        }
+        else {
+            std::cerr << "Discarding unreadable bytecode cache " << cachePath << ": " << lua_tostring(L, -1) << "\n";
+            lua_pop(L, 1);
+        }
+    }
+
+    // lua_load copies everything it needs, so the view can go immediately
+    UnmapViewOfFile(view);
+    return loaded;
+}
+
+/**
+ * @brief Writes a compiled chunk atomically, so a concurrent reader never sees half a file.
+ */
+void BytecodeCache::store(const std::string& cachePath, const CacheHeader& header, const std::string& bytecode) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // Clients loading the same script at once each write their own temporary file
+    std::ostringstream thread;
+    thread << std::this_thread::get_id();
+    std::string temporaryPath = cachePath + "." + thread.str() + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Error: Unable to write bytecode cache " << temporaryPath << "\n";
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+        if (!out) {
+            std::cerr << "Error: Unable to write bytecode cache " << temporaryPath << "\n";
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error) {
+        std::cerr << "Error: Unable to replace bytecode cache " << cachePath << ": " << error.message() << "\n";
+        std::filesystem::remove(temporaryPath, error);
+    }
+}
+
+std::string BytecodeCache::cachePathFor(const std::string& filePath) const {
+    std::string name = filePath;
+    for (char& c : name) {
+        if (c == '/' || c == '\\' || c == ':') {
+            c = '_';
+        }
+    }
+    return directory + "/" + name + ".luac";
+}
+
+bool BytecodeCache::sameSource(const CacheHeader& cached, const CacheHeader& expected) {
+    return std::memcmp(cached.magic, expected.magic, sizeof(cached.magic)) == 0 &&
+        cached.luaVersion == expected.luaVersion &&
+        cached.sourceHash == expected.sourceHash &&
+        cached.sourceSize == expected.sourceSize &&
+        cached.sourceMtime == expected.sourceMtime;
+}
+
+uint64_t BytecodeCache::hashSource(const char* data, size_t size) {
+    // FNV-1a, 64-bit
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+int BytecodeCache::writeChunk(lua_State* L, const void* data, size_t size, void* ud) {
+    static_cast<std::string*>(ud)->append(static_cast<const char*>(data), size);
+    return 0;
+}
+
+void BytecodeCache::collectMetrics(MetricsWriter& metrics) const {
+    metrics.counter("mommyglider_bytecode_cache_hits_total", "Scripts loaded from precompiled bytecode.",
+        static_cast<double>(hits.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_bytecode_cache_shared_hits_total", "Scripts loaded from bytecode another client's state already read.",
+        static_cast<double>(sharedHits.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_bytecode_cache_misses_total", "Scripts compiled from source because the cache was missing or stale.",
+        static_cast<double>(misses.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_bytecode_load_seconds_total", "Time spent loading scripts, including hashing and compiling.",
+        loadNs.load(std::memory_order_relaxed) / 1e9);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file BytecodeCache.h
+ * @brief On-disk cache of precompiled Lua chunks for the Interface scripts.
+ *
+ * Each script is compiled once with lua_dump and stored next to a header holding the source's
+ * content hash, size and modification time. Later loads memory-map the cached chunk and hand it
+ * to luaL_loadbufferx, skipping the lexer and parser; any mismatch falls back to the source.
+ * Chunks are also kept in memory, so the engines of several clients sharing one cache undump the
+ * same bytes instead of each mapping or compiling the file.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef BYTECODECACHE_H
+#define BYTECODECACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+extern "C" {
+#include "lua.h"
+}
+
+class MetricsWriter;
+
+/**
+ * @class BytecodeCache
+ * @brief Loads Lua files through a content-addressed bytecode cache.
+ */
+class BytecodeCache {
+public:
+    /**
+     * @brief Creates a cache storing compiled chunks in the given directory.
+     * @param cacheDirectory Directory for .luac files; created on first write.
+     */
+    explicit BytecodeCache(const std::string& cacheDirectory);
+
+    /**
+     * @brief Drop-in replacement for luaL_loadfile. Safe to call from several threads.
+     *
+     * Pushes the compiled chunk (or an error message) onto the stack.
+     *
+     * @param L Lua state to load into.
+     * @param filePath Path of the Lua source file.
+     * @return LUA_OK or a Lua error code, as luaL_loadfile.
+     */
+    int load(lua_State* L, const std::string& filePath);
+
+    /**
+     * @brief Reports hit/miss counts and time spent loading.
+     * @param metrics Writer collecting the samples.
+     */
+    void collectMetrics(MetricsWriter& metrics) const;
+
+private:
+    /**
+     * @brief Header written in front of every cached chunk.
+     */
+    struct CacheHeader {
+        char magic[8];          ///< "MGLUAC1"
+        uint32_t luaVersion;    ///< LUA_VERSION_RELEASE_NUM of the compiler
+        uint32_t payloadSize;   ///< Bytes of lua_dump output following the header
+        uint64_t sourceHash;    ///< FNV-1a of the source text
+        uint64_t sourceSize;    ///< Source size in bytes
+        int64_t sourceMtime;    ///< Source last-write time, filesystem clock ticks
+    };
+
+    /**
+     * @brief Compiled chunk kept in memory for other states loading the same script.
+     */
+    struct SharedChunk {
+        CacheHeader header;
+        std::string bytecode;
+    };
+
+    std::string cachePathFor(const std::string& filePath) const;
+    bool loadShared(lua_State* L, const std::string& cachePath, const std::string& chunkName, const CacheHeader& expected);
+    void share(const std::string& cachePath, const CacheHeader& header, std::string bytecode);
+    bool loadCached(lua_State* L, const std::string& cachePath, const std::string& chunkName, const CacheHeader& expected);
+    void store(const std::string& cachePath, const CacheHeader& header, const std::string& bytecode);
+
+    static bool sameSource(const CacheHeader& cached, const CacheHeader& expected);
+    static uint64_t hashSource(const char* data, size_t size);
+    static int writeChunk(lua_State* L, const void* data, size_t size, void* ud);
+
+    std::string directory;
+    std::mutex sharedMutex;
+    std::map<std::string, std::shared_ptr<const SharedChunk>> shared; ///< Keyed by cache path
+    std::atomic<uint64_t> sharedHits{ 0 };
+    std::atomic<uint64_t> hits{ 0 };
+    std::atomic<uint64_t> misses{ 0 };
+    std::atomic<uint64_t> loadNs{ 0 };
+};
+
+#endif // BYTECODECACHE_H
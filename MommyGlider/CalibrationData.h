@@ -6,7 +6,8 @@ struct CalibrationData {
     float refY;
     int pixelSize;
     int spacing;
-
+    int originX = 0;    // Screen position of the game's client area, for windowed clients
+    int originY = 0;
 };
 
 #pragma once
\ No newline at end of file
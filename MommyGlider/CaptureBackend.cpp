@@ -0,0 +1,39 @@
+/**
+ * @file CaptureBackend.cpp
+ * @brief Selection of the screen capture backend.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include "CaptureBackend.h"
+#include "GdiCapture.h"
+#include "X11Capture.h"
+
+std::unique_ptr<CaptureBackend> CaptureBackend::create(const std::string& name) {
+    std::string selected = name;
+    if (selected.empty()) {
+#ifdef MOMMYGLIDER_X11
+        // Under Wine the game is drawn on an X display; reading it there skips GDI emulation
+        const char* display = std::getenv("DISPLAY");
+        selected = display && *display ? "x11" : "gdi";
+#else
+        selected = "gdi";
+#endif
+    }
+
+#ifdef _WIN32
+    if (selected == "gdi") {
+        return std::make_unique<GdiCapture>();
+    }
+#endif
+#ifdef MOMMYGLIDER_X11
+    if (selected == "x11") {
+        return std::make_unique<X11Capture>();
+    }
+#endif
+    std::cerr << "Error: Capture backend \"" << selected << "\" is not available in this build.\n";
+    return nullptr;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file CaptureBackend.h
+ * @brief Screen copy used by CaptureSource: GDI on Windows, MIT-SHM on an X11 display.
+ *
+ * A backend owns the buffer the strips are decoded from. It is opened, used and closed on the
+ * capture thread only.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef CAPTUREBACKEND_H
+#define CAPTUREBACKEND_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @class CaptureBackend
+ * @brief Copies screen rectangles into a persistent 32-bit (0x00RRGGBB) pixel buffer.
+ */
+class CaptureBackend {
+public:
+    virtual ~CaptureBackend() = default;
+
+    /**
+     * @brief Creates the backend named `name` ("gdi" or "x11"), or the platform default if empty.
+     * @return Null if the name is unknown or the backend was not compiled in; the error has been reported.
+     */
+    static std::unique_ptr<CaptureBackend> create(const std::string& name);
+
+    /**
+     * @brief Name used in logs and as the `backend` metric label.
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Connects to the screen. Called once, on the capture thread.
+     * @return False if the screen cannot be captured; the error has been reported.
+     */
+    virtual bool open() = 0;
+
+    /**
+     * @brief Makes the buffer hold at least width x height pixels, keeping it if it already does.
+     */
+    virtual bool resize(int width, int height) = 0;
+
+    /**
+     * @brief Copies the screen rectangle at (x, y) to (bufferX, bufferY) in the buffer.
+     *
+     * Backends that cannot place a copy (copiesRegions() false) only accept a copy of the whole
+     * rectangle passed to the last resize() at (0, 0).
+     */
+    virtual bool copy(int x, int y, int width, int height, int bufferX, int bufferY) = 0;
+
+    /**
+     * @brief Whether copy() can fill any part of the buffer, so regions of interest can be copied alone.
+     */
+    virtual bool copiesRegions() const = 0;
+
+    /**
+     * @brief Waits until the copies issued so far are visible in pixels().
+     */
+    virtual void finish() {}
+
+    /**
+     * @brief Top-down rows of the buffer, stride() pixels apart.
+     */
+    virtual const uint32_t* pixels() const = 0;
+    virtual int stride() const = 0;
+};
+
+#endif // CAPTUREBACKEND_H
@@ -0,0 +1,205 @@
+/**
+ * @file CaptureSource.cpp
+ * @brief Implementation of the shared single-grab capture thread.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <algorithm>
+#include <execution>
+#include <iostream>
+#include "AllocationTracker.h"
+#include "CaptureSource.h"
+#include "Memory.h"
+#include "MetricsServer.h"
+#include "Util.h"
+
+// Constructor
+CaptureSource::CaptureSource(std::chrono::milliseconds captureInterval, const std::string& backendName)
+    : interval(captureInterval), backend(CaptureBackend::create(backendName)) {
+    backendLabel = std::string("backend=\"") + (backend ? backend->name() : "none") + "\"";
+    captureThread = std::thread(&CaptureSource::captureLoop, this);
+}
+
+// Destructor
+CaptureSource::~CaptureSource() {
+    stopThread = true;
+    if (captureThread.joinable()) {
+        captureThread.join();
+    }
+}
+
+void CaptureSource::addStrip(Memory* memory, const std::vector<Panel>& panels) {
+    std::lock_guard<std::mutex> lock(stripsMutex);
+    strips.push_back({ memory, panels });
+}
+
+void CaptureSource::removeStrip(Memory* memory) {
+    std::lock_guard<std::mutex> lock(stripsMutex);
+    strips.erase(std::remove_if(strips.begin(), strips.end(), [memory](const Strip& strip) { return strip.memory == memory; }), strips.end());
+}
+
+bool CaptureSource::isDue(const Panel& panel) const {
+    return frame % static_cast<uint64_t>(std::max(panel.interval, 1)) == 0;
+}
+
+void CaptureSource::captureLoop() {
+    // Without a screen to copy from, every frame is reported as a failed grab
+    bool opened = backend && backend->open();
+    if (opened) {
+        std::cout << "Capturing the screen with the " << backend->name() << " backend.\n";
+    }
+
+    while (!stopThread) {
+        {
+            std::lock_guard<std::mutex> lock(stripsMutex);
+            // Union of the panels due this frame
+            bool first = true;
+            RECT box = {};
+            for (const Strip& strip : strips) {
+                for (const Panel& panel : strip.panels) {
+                    if (!isDue(panel)) {
+                        continue;
+                    }
+                    if (first) {
+                        box = panel.area;
+                        first = false;
+                    }
+                    box.left = std::min(box.left, panel.area.left);
+                    box.top = std::min(box.top, panel.area.top);
+                    box.right = std::max(box.right, panel.area.right);
+                    box.bottom = std::max(box.bottom, panel.area.bottom);
+                }
+            }
+            if (!first && !opened) {
+                for (const Strip& strip : strips) {
+                    strip.memory->captureFailed();
+                }
+            }
+            else if (!first) {
+                int width = box.right - box.left;
+                int height = box.bottom - box.top;
+
+                if (width > 0 && height > 0 && backend->resize(width, height)) {
+                    uint64_t allocationsBefore = AllocationTracker::threadAllocations();
+
+                    // Regions of interest, unless this is a full refresh or some Memory has none yet
+                    std::vector<Published<CaptureInterest>::Reader>& interests = frameInterests;
+                    interests.resize(strips.size());
+                    bool regionsOnly = backend->copiesRegions() && frame % FULL_REFRESH_INTERVAL != 0;
+                    for (size_t i = 0; i < strips.size() && regionsOnly; ++i) {
+                        interests[i] = strips[i].memory->captureInterest();
+                        regionsOnly = static_cast<bool>(interests[i]);
+                    }
+                    if (!regionsOnly) {
+                        for (auto& held : interests) {
+                            held.release();
+                        }
+                    }
+
+                    int64_t start = monotonicNanos();
+                    uint64_t pixelsCopied = static_cast<uint64_t>(width) * height;
+                    bool copied = regionsOnly ? copySpans(box, interests, pixelsCopied)
+                        : backend->copy(box.left, box.top, width, height, 0, 0);
+                    backend->finish();
+                    int64_t captureTime = monotonicNanos();
+                    lastGrabNs.store(static_cast<uint64_t>(captureTime - start), std::memory_order_relaxed);
+
+                    if (!copied) {
+                        std::cerr << "Error: Screen copy failed (" << backend->name() << "). Check coordinates and device contexts." << std::endl;
+                        for (const Strip& strip : strips) {
+                            strip.memory->captureFailed();
+                        }
+                    }
+                    else {
+                        grabs.fetch_add(1, std::memory_order_relaxed);
+                        grabbedPixels.store(pixelsCopied, std::memory_order_relaxed);
+                        totalGrabNs.fetch_add(static_cast<uint64_t>(captureTime - start), std::memory_order_relaxed);
+
+                        // Strips only read the shared buffer and write their own store
+                        const uint32_t* pixels = backend->pixels();
+                        size_t stride = static_cast<size_t>(backend->stride());
+                        // Decodes may run on other threads, so each one counts its own allocations
+                        uint64_t frameAllocations = AllocationTracker::threadAllocations() - allocationsBefore;
+                        std::atomic<uint64_t> decodeAllocations{ 0 };
+                        auto decode = [&](const Strip& strip) {
+                            uint64_t decodeBefore = AllocationTracker::threadAllocations();
+                            const CaptureInterest* interest = interests[&strip - strips.data()].get();
+                            const uint32_t* origins[PANEL_COUNT] = {};
+                            for (size_t i = 0; i < strip.panels.size() && i < PANEL_COUNT; ++i) {
+                                const RECT& area = strip.panels[i].area;
+                                if (isDue(strip.panels[i])) {
+                                    origins[i] = pixels + static_cast<size_t>(area.top - box.top) * stride + (area.left - box.left);
+                                }
+                            }
+                            strip.memory->decodeFrame(origins, captureTime, interest);
+                            decodeAllocations.fetch_add(AllocationTracker::threadAllocations() - decodeBefore, std::memory_order_relaxed);
+                        };
+                        if (strips.size() == 1) {
+                            decode(strips.front());
+                        }
+                        else {
+                            std::for_each(std::execution::par, strips.begin(), strips.end(), decode);
+                        }
+                        lastDecodeNs.store(static_cast<uint64_t>(monotonicNanos() - captureTime), std::memory_order_relaxed);
+                        AllocationTracker::checkFrame(AllocationTracker::Stage::Capture, frameAllocations + decodeAllocations.load());
+                    }
+                    // Not held across the sleep, so the script engine can free regions it replaced
+                    for (auto& held : interests) {
+                        held.release();
+                    }
+                }
+            }
+            ++frame;
+        }
+        std::this_thread::sleep_for(interval);
+    }
+
+    // The backend's display connection belongs to this thread
+    backend.reset();
+}
+
+/**
+ * @brief Copies the column spans of every due panel into the buffer, at their place in `box`.
+ *
+ * @param pixelsCopied Receives the number of pixels copied.
+ * @return False if any copy failed.
+ */
+bool CaptureSource::copySpans(const RECT& box, const std::vector<Published<CaptureInterest>::Reader>& interests, uint64_t& pixelsCopied) {
+    pixelsCopied = 0;
+    bool copied = true;
+    for (size_t i = 0; i < strips.size(); ++i) {
+        const Strip& strip = strips[i];
+        for (size_t panel = 0; panel < strip.panels.size() && panel < PANEL_COUNT; ++panel) {
+            const RECT& area = strip.panels[panel].area;
+            if (!isDue(strip.panels[panel])) {
+                continue;
+            }
+            int height = area.bottom - area.top;
+            for (const ColumnSpan& span : interests[i]->spans[panel]) {
+                int left = area.left + span.left;
+                int width = std::min(span.right, static_cast<int>(area.right - area.left)) - span.left;
+                if (width <= 0) {
+                    continue;
+                }
+                copied &= backend->copy(left, area.top, width, height, left - box.left, area.top - box.top);
+                pixelsCopied += static_cast<uint64_t>(width) * height;
+            }
+        }
+    }
+    return copied;
+}
+
+void CaptureSource::collectMetrics(MetricsWriter& metrics) const {
+    metrics.counter("mommyglider_capture_grabs_total", "Screen copies covering every registered strip.",
+        static_cast<double>(grabs.load(std::memory_order_relaxed)), backendLabel);
+    metrics.gauge("mommyglider_capture_grab_pixels", "Pixels copied by the last grab (union of all strips, or their regions of interest).",
+        static_cast<double>(grabbedPixels.load(std::memory_order_relaxed)), backendLabel);
+    metrics.gauge("mommyglider_capture_grab_seconds", "Duration of the last screen copy.",
+        lastGrabNs.load(std::memory_order_relaxed) / 1e9, backendLabel);
+    metrics.counter("mommyglider_capture_grab_seconds_total", "Time spent in successful screen copies; divide by the grabs for the cost per frame.",
+        totalGrabNs.load(std::memory_order_relaxed) / 1e9, backendLabel);
+    metrics.gauge("mommyglider_capture_decode_seconds", "Time to decode every strip of the last grab.",
+        lastDecodeNs.load(std::memory_order_relaxed) / 1e9);
+}
@@ -0,0 +1,103 @@
+/**
+ * @file CaptureSource.h
+ * @brief One screen grab per frame for every registered pixel strip.
+ *
+ * Each Memory registers the screen rectangles of its panels (one per offset rate class). The
+ * capture thread copies the union of all rectangles due this frame with a single screen copy of
+ * its CaptureBackend (a BitBlt into a DIB section, or XShmGetImage under Wine), then decodes the
+ * strips in parallel straight from the backend's buffer, each into its own Memory's snapshot store. The GDI and compositor cost is paid once per frame, however many
+ * clients are tiled on the screen, and panels refreshed every Nth frame cost nothing in between.
+ *
+ * Once every Memory has a region of interest and the backend can place partial copies, only the
+ * column spans are copied, one copy per span; every FULL_REFRESH_INTERVAL frames the whole union is copied and decoded again so
+ * offsets scripts start reading have a current value.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef CAPTURESOURCE_H
+#define CAPTURESOURCE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <windows.h>
+
+#include "CaptureBackend.h"
+#include "Memory.h"
+
+class MetricsWriter;
+
+/**
+ * @class CaptureSource
+ * @brief Capture thread shared by the Memory instances of several clients.
+ */
+class CaptureSource {
+public:
+    static constexpr uint64_t FULL_REFRESH_INTERVAL = 16; ///< Frames between whole-strip grabs
+
+    /**
+     * @param interval Time between grabs.
+     * @param backend Name of the CaptureBackend ("gdi", "x11"), or empty for the platform default.
+     */
+    explicit CaptureSource(std::chrono::milliseconds interval = std::chrono::milliseconds(250), const std::string& backend = "");
+    ~CaptureSource();
+    CaptureSource(const CaptureSource&) = delete;
+    CaptureSource& operator=(const CaptureSource&) = delete;
+
+    /**
+     * @brief Pixel row of one rate class.
+     */
+    struct Panel {
+        RECT area;      ///< Rectangle in screen coordinates
+        int interval;   ///< Captured on every interval-th frame
+    };
+
+    /**
+     * @brief Starts decoding `panels` into `memory` from the next frame on.
+     * @param panels Indexed by OffsetRate, at most PANEL_COUNT.
+     */
+    void addStrip(Memory* memory, const std::vector<Panel>& panels);
+
+    /**
+     * @brief Stops decoding into `memory`. Returns once no frame is using it any more.
+     */
+    void removeStrip(Memory* memory);
+
+    void collectMetrics(MetricsWriter& metrics) const;
+
+private:
+    struct Strip {
+        Memory* memory;
+        std::vector<Panel> panels;
+    };
+
+    void captureLoop();
+    bool copySpans(const RECT& box, const std::vector<Published<CaptureInterest>::Reader>& interests, uint64_t& pixelsCopied);
+    bool isDue(const Panel& panel) const;
+
+    std::chrono::milliseconds interval;
+    std::mutex stripsMutex;             ///< Held while a frame is grabbed and decoded
+    std::vector<Strip> strips;
+
+    // Owned by the capture thread
+    std::unique_ptr<CaptureBackend> backend; ///< Null if the requested backend is not available
+    std::string backendLabel;           ///< `backend` label of the capture metrics
+    uint64_t frame = 0;                 ///< Grabs attempted, selects the panels due
+    std::vector<Published<CaptureInterest>::Reader> frameInterests; ///< Per strip, reused so a frame does not allocate
+
+    std::atomic<uint64_t> grabs{ 0 };
+    std::atomic<uint64_t> grabbedPixels{ 0 }; ///< Area of the last union rectangle
+    std::atomic<uint64_t> lastGrabNs{ 0 };
+    std::atomic<uint64_t> totalGrabNs{ 0 };
+    std::atomic<uint64_t> lastDecodeNs{ 0 };
+    std::atomic<bool> stopThread{ false };
+    std::thread captureThread;
+};
+
+#endif // CAPTURESOURCE_H
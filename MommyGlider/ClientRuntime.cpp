@@ -0,0 +1,145 @@
+/**
+ * @file ClientRuntime.cpp
+ * @brief Implementation of the multi-client runtime.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "AllocationTracker.h"
+#include "ClientRuntime.h"
+#include "MetricsServer.h"
+
+#pragma comment(lib, "Synchronization.lib")
+
+// Constructor
+ClientRuntime::ClientRuntime(const CalibrationData& calibration, const std::string& bytecodeDirectory, const std::string& captureBackend)
+    : baseCalibration(calibration), bytecodeCache(bytecodeDirectory), captureSource(std::chrono::milliseconds(250), captureBackend) {}
+
+// Destructor
+ClientRuntime::~ClientRuntime() {
+    requestStop();
+}
+
+void ClientRuntime::enableHotReload(const std::string& directory) {
+    if (scriptWatcher) {
+        return;
+    }
+    std::vector<LuaEngine*> engines;
+    for (Client& client : clients) {
+        engines.push_back(client.engine.get());
+    }
+    scriptWatcher = std::make_unique<ScriptWatcher>(directory, std::move(engines));
+}
+
+size_t ClientRuntime::discoverClients() {
+    std::vector<HWND> windows = Controller::findGameWindows();
+    if (windows.empty()) {
+        std::cerr << "No game window found; starting a single client on the full screen.\n";
+        windows.push_back(NULL);
+    }
+    for (HWND window : windows) {
+        addClient(window);
+    }
+    std::cout << "Driving " << clients.size() << " client(s).\n";
+    return clients.size();
+}
+
+void ClientRuntime::addClient(HWND window) {
+    Client& client = clients.emplace_back();
+    client.id = static_cast<int>(clients.size()) - 1;
+    client.window = window;
+    client.memory = std::make_unique<Memory>(calibrationFor(window), &framesPublished, &captureSource);
+    client.controller = std::make_unique<Controller>(window);
+    client.engine = std::make_unique<LuaEngine>(*client.memory, *client.controller, bytecodeCache);
+    client.memory->setFlightRecorder(&recorder, client.id);
+    client.controller->setFlightRecorder(&recorder, client.id);
+    client.engine->setFlightRecorder(&recorder, client.id);
+}
+
+/**
+ * @brief Calibration of one window: the shared UI layout, sized and offset to its client area.
+ */
+CalibrationData ClientRuntime::calibrationFor(HWND window) const {
+    CalibrationData calibration = baseCalibration;
+    RECT area;
+    POINT origin = { 0, 0 };
+    if (window && GetClientRect(window, &area) && ClientToScreen(window, &origin) &&
+        area.right > area.left && area.bottom > area.top) {
+        calibration.screenWidth = area.right - area.left;
+        calibration.screenHeight = area.bottom - area.top;
+        calibration.originX = origin.x;
+        calibration.originY = origin.y;
+    }
+    return calibration;
+}
+
+void ClientRuntime::run(const std::string& tickFunction, int workers) {
+    if (clients.empty()) {
+        return;
+    }
+    workerCount = workers < 1 ? 1 : workers;
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workerCount; ++i) {
+        threads.emplace_back(&ClientRuntime::work, this, tickFunction);
+    }
+    work(tickFunction);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ClientRuntime::requestStop() {
+    stopRequested = true;
+    // Wake workers waiting for a frame
+    framesPublished.fetch_add(1, std::memory_order_release);
+    WakeByAddressAll(&framesPublished);
+}
+
+void ClientRuntime::work(const std::string& tickFunction) {
+    while (!stopRequested) {
+        // Read before scanning: a frame published during the scan makes the wait return at once
+        uint64_t epoch = framesPublished.load(std::memory_order_acquire);
+        bool worked = false;
+        int64_t untilTimer = 1000;
+
+        for (size_t scanned = 0; scanned < clients.size(); ++scanned) {
+            Client& client = clients[nextClient.fetch_add(1, std::memory_order_relaxed) % clients.size()];
+            bool idle = false;
+            if (!client.busy.compare_exchange_strong(idle, true, std::memory_order_acquire)) {
+                continue; // Another worker is ticking it
+            }
+            worked |= client.engine->tick(tickFunction);
+            int64_t clientTimer = client.engine->msUntilNextTimer();
+            client.busy.store(false, std::memory_order_release);
+
+            if (clientTimer >= 0 && clientTimer < untilTimer) {
+                untilTimer = clientTimer;
+            }
+        }
+
+        if (!worked) {
+            WaitOnAddress(&framesPublished, &epoch, sizeof(epoch), static_cast<DWORD>(untilTimer));
+        }
+    }
+}
+
+void ClientRuntime::collectMetrics(MetricsWriter& metrics) const {
+    metrics.gauge("mommyglider_clients", "Game windows driven by this process.", static_cast<double>(clients.size()));
+    metrics.gauge("mommyglider_runtime_workers", "Worker threads ticking the clients.", workerCount.load());
+    bytecodeCache.collectMetrics(metrics);
+    captureSource.collectMetrics(metrics);
+    AllocationTracker::collectMetrics(metrics);
+    recorder.collectMetrics(metrics);
+
+    for (const Client& client : clients) {
+        metrics.setCommonLabels("client=\"" + std::to_string(client.id) + "\"");
+        client.memory->collectMetrics(metrics);
+        client.engine->collectMetrics(metrics);
+        client.controller->collectMetrics(metrics);
+    }
+    metrics.setCommonLabels("");
+}
@@ -0,0 +1,114 @@
+/**
+ * @file ClientRuntime.h
+ * @brief Drives several game windows from one process.
+ *
+ * Every visible WoW window becomes a client with its own snapshot store (Memory), input queue
+ * (Controller) and Lua state (LuaEngine). One CaptureSource grabs all clients' strips per frame. A fixed pool of workers ticks
+ * whichever clients have a new frame or a due timer; a client is only ever ticked by one worker at
+ * a time, so each engine still sees a single thread. Compiled script bytecode is shared through
+ * one BytecodeCache.
+ *
+ * Capture reads the screen, so the windows must not overlap.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef CLIENTRUNTIME_H
+#define CLIENTRUNTIME_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <windows.h>
+#include "BytecodeCache.h"
+#include "CalibrationData.h"
+#include "CaptureSource.h"
+#include "Controller.h"
+#include "FlightRecorder.h"
+#include "LuaEngine.h"
+#include "Memory.h"
+#include "ScriptWatcher.h"
+
+class MetricsWriter;
+
+/**
+ * @brief Pipeline of one game window.
+ */
+struct Client {
+    int id;                                 ///< Index, used as the `client` metrics label
+    HWND window;                            ///< Game window, or null if none was found
+    std::unique_ptr<Memory> memory;
+    std::unique_ptr<Controller> controller;
+    std::unique_ptr<LuaEngine> engine;
+    std::atomic<bool> busy{ false };        ///< Held by the worker ticking this client
+};
+
+/**
+ * @class ClientRuntime
+ * @brief Owns the clients and the worker pool ticking them.
+ */
+class ClientRuntime {
+public:
+    /**
+     * @param calibration UI layout shared by every client; screen size and origin are taken from each window.
+     * @param bytecodeDirectory Directory of the shared bytecode cache.
+     * @param captureBackend CaptureBackend name ("gdi", "x11"), or empty for the platform default.
+     */
+    ClientRuntime(const CalibrationData& calibration, const std::string& bytecodeDirectory, const std::string& captureBackend = "");
+    ~ClientRuntime();
+
+    /**
+     * @brief Creates a client for every visible WoW window, or a single client if none is found.
+     * @return Number of clients.
+     */
+    size_t discoverClients();
+
+    size_t clientCount() const { return clients.size(); }
+    Client& client(size_t index) { return clients[index]; }
+
+    // Recent frames, ticks and actions of every client
+    FlightRecorder& flightRecorder() { return recorder; }
+
+    /**
+     * @brief Reloads every client's scripts when a .lua file under `directory` changes, from one
+     *        shared watcher thread. Call after the scripts have been executed.
+     */
+    void enableHotReload(const std::string& directory);
+
+    /**
+     * @brief Ticks the clients on `workers` threads, including the calling one, until requestStop().
+     * @param tickFunction Name of the global Lua function to call each frame.
+     */
+    void run(const std::string& tickFunction, int workers);
+
+    /**
+     * @brief Asks run() to return after the current ticks.
+     */
+    void requestStop();
+
+    /**
+     * @brief Reports every client's capture, script and input metrics, labelled with `client`.
+     */
+    void collectMetrics(MetricsWriter& metrics) const;
+
+private:
+    void addClient(HWND window);
+    CalibrationData calibrationFor(HWND window) const;
+    void work(const std::string& tickFunction);
+
+    CalibrationData baseCalibration;
+    BytecodeCache bytecodeCache;
+    std::atomic<uint64_t> framesPublished{ 0 }; ///< Bumped for every decoded frame; workers wait on it
+    FlightRecorder recorder;                    ///< Declared before the clients, which record into it
+    CaptureSource captureSource;                ///< Single screen grab for every client's strip
+    std::deque<Client> clients;                 ///< Deque keeps clients in place as they are added
+    std::unique_ptr<ScriptWatcher> scriptWatcher; ///< Declared after the clients, so it stops before their engines go
+    std::atomic<size_t> nextClient{ 0 };        ///< Round-robin start so no client is always scanned last
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<int> workerCount{ 0 };
+};
+
+#endif // CLIENTRUNTIME_H
@@ -26,10 +26,14 @@
  */
 
 #include "Controller.h"
+#include <cstring>
 #include <iostream>
+#include <mutex>
 #include <windows.h>
 #include "Util.h"
 #include "CalibrationData.h"
+#include "FlightRecorder.h"
+#include "MetricsServer.h"
 
  // Helper function to find the WoW game window
 HWND Controller::findGameWindow() {
@@ -40,11 +44,93 @@ HWND Controller::findGameWindow() {
     return hwnd;
 }
 
+// Enumerate every visible WoW window
+std::vector<HWND> Controller::findGameWindows() {
+    std::vector<HWND> windows;
+    EnumWindows([](HWND hwnd, LPARAM param) -> BOOL {
+        char title[64];
+        if (IsWindowVisible(hwnd) && GetWindowTextA(hwnd, title, sizeof(title)) > 0 && strcmp(title, "World of Warcraft") == 0) {
+            reinterpret_cast<std::vector<HWND>*>(param)->push_back(hwnd);
+        }
+        return TRUE;
+    }, reinterpret_cast<LPARAM>(&windows));
+    return windows;
+}
+
 // Constructor
-Controller::Controller() : gameWindow(findGameWindow()) {}
+Controller::Controller(HWND window) : gameWindow(window ? window : findGameWindow()) {
+    inputThread = std::thread(&Controller::deliverInputs, this);
+}
+
+// Destructor
+Controller::~Controller() {
+    stopping = true;
+    inputSignal.fetch_add(1, std::memory_order_release);
+    WakeByAddressSingle(&inputSignal);
+    inputThread.join();
+}
+
+// Queue an input; pendingActions counts it until it has been delivered or dropped
+void Controller::enqueue(InputType type, int key, int x, int y) const {
+    pendingActions.fetch_add(1, std::memory_order_relaxed);
+    uint64_t tail = inputTail.load(std::memory_order_relaxed);
+    uint64_t head = inputHead.load(std::memory_order_acquire);
+    while (tail - head >= MAX_QUEUED_INPUTS) {
+        // The input thread is stalled (e.g. a key held by CapsLock); the oldest action is the stalest
+        if (inputHead.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel)) {
+            pendingActions.fetch_sub(1, std::memory_order_relaxed);
+            actionsDropped.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+    InputSlot& slot = inputRing[tail % MAX_QUEUED_INPUTS];
+    slot.type.store(static_cast<uint32_t>(type), std::memory_order_relaxed);
+    slot.key.store(key, std::memory_order_relaxed);
+    slot.x.store(x, std::memory_order_relaxed);
+    slot.y.store(y, std::memory_order_relaxed);
+    inputTail.store(tail + 1, std::memory_order_release);
+
+    inputSignal.fetch_add(1, std::memory_order_release);
+    WakeByAddressSingle(&inputSignal);
+}
+
+// Deliver queued inputs in order
+void Controller::deliverInputs() {
+    while (true) {
+        // Read before checking the ring: a push after the check changes it, so the wait returns at once
+        uint32_t signal = inputSignal.load(std::memory_order_acquire);
+        if (stopping) {
+            return;
+        }
+        uint64_t head = inputHead.load(std::memory_order_acquire);
+        if (head == inputTail.load(std::memory_order_acquire)) {
+            WaitOnAddress(&inputSignal, &signal, sizeof(signal), INFINITE);
+            continue;
+        }
+
+        const InputSlot& slot = inputRing[head % MAX_QUEUED_INPUTS];
+        InputType type = static_cast<InputType>(slot.type.load(std::memory_order_relaxed));
+        int key = slot.key.load(std::memory_order_relaxed);
+        int x = slot.x.load(std::memory_order_relaxed);
+        int y = slot.y.load(std::memory_order_relaxed);
+        // Fails if the producer dropped this input meanwhile; the copy may then be torn and is discarded
+        if (!inputHead.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        if (type == InputType::KeyPress) {
+            simulateKeyPress(static_cast<WORD>(key), true);
+        }
+        else {
+            simulateClickAt(x, y);
+            std::cout << "Clicked at Monitor Coords: (" << x << ", " << y << ")\n";
+        }
+        pendingActions.fetch_sub(1, std::memory_order_relaxed);
+        actionsSent.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
 #include <random>
-#include <thread>
 
 void Controller::simulateKeyPress(WORD key, bool useBackgroundInjection = true) const {
     if (!gameWindow) {
@@ -116,6 +202,21 @@ void Controller::simulateKeyPress(WORD key, bool useBackgroundInjection = true)
 
 
 
+namespace {
+    // The cursor is global: every Controller's input thread moves it, so mouse input is sent under one lock
+    std::mutex mouseMutex;
+
+    // Absolute SendInput coordinates of a monitor pixel
+    INPUT absoluteMove(int x, int y) {
+        INPUT input = {};
+        input.type = INPUT_MOUSE;
+        input.mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE;
+        input.mi.dx = static_cast<LONG>((x * 65535) / GetSystemMetrics(SM_CXSCREEN));
+        input.mi.dy = static_cast<LONG>((y * 65535) / GetSystemMetrics(SM_CYSCREEN));
+        return input;
+    }
+}
+
 // Simulate a mouse click
 void Controller::simulateMouseClick(DWORD button) const {
     INPUT inputs[2] = {}; // Array for press and release events
@@ -129,20 +230,32 @@ void Controller::simulateMouseClick(DWORD button) const {
     inputs[1].mi.dwFlags = button;
 
     // Send both events
+    std::lock_guard<std::mutex> lock(mouseMutex);
     SendInput(2, inputs, sizeof(INPUT));
 } 
 
 
 // Simulate mouse movement to a specific position
 void Controller::simulateMouseMovement(int x, int y) const {
-    INPUT input = {};
-    input.type = INPUT_MOUSE;
-    input.mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE;
-    input.mi.dx = static_cast<LONG>((x * 65535) / GetSystemMetrics(SM_CXSCREEN));
-    input.mi.dy = static_cast<LONG>((y * 65535) / GetSystemMetrics(SM_CYSCREEN));
+    INPUT input = absoluteMove(x, y);
+    std::lock_guard<std::mutex> lock(mouseMutex);
     SendInput(1, &input, sizeof(INPUT));
 }
 
+// Move and click in one SendInput call, so no other client's input lands between them
+void Controller::simulateClickAt(int x, int y) const {
+    INPUT inputs[3] = { absoluteMove(x, y), {}, {} };
+    inputs[1].type = INPUT_MOUSE;
+    inputs[1].mi.dwFlags = MOUSEEVENTF_LEFTDOWN;
+    inputs[2].type = INPUT_MOUSE;
+    inputs[2].mi.dwFlags = MOUSEEVENTF_LEFTUP;
+
+    std::lock_guard<std::mutex> lock(mouseMutex);
+    if (SendInput(3, inputs, sizeof(INPUT)) != 3) {
+        std::cerr << "[ERROR] Failed to send click at: (" << x << ", " << y << ")\n";
+    }
+}
+
 // Check if WoW is in the foreground
 bool Controller::isWoWInForeground() const {
     HWND hwnd = GetForegroundWindow();
@@ -156,18 +269,17 @@ void Controller::clickAtMonitorCoords(int screenX, int screenY) const {
         return;
     }
 
+    if (flightRecorder) {
+        flightRecorder->recordClick(flightClient, screenX, screenY);
+    }
     // Simulate mouse movement and click
-    simulateMouseMovement(screenX, screenY);
-    simulateMouseClick(MOUSEEVENTF_LEFTDOWN);
-    simulateMouseClick(MOUSEEVENTF_LEFTUP);
-
-    std::cout << "Clicked at Monitor Coords: (" << screenX << ", " << screenY << ")\n";
+    enqueue(InputType::Click, 0, screenX, screenY);
 }
 
 // Simulate a click at UI coordinates
 void Controller::clickAtUICoords(float uiX, float uiY, const CalibrationData& calibration) const {
     auto [screenX, screenY] = translateToMonitorCoords(uiX, uiY, calibration);
-    clickAtMonitorCoords(screenX, screenY);
+    clickAtMonitorCoords(screenX + calibration.originX, screenY + calibration.originY);
 }
 
 // Press a keyboard key
@@ -176,7 +288,15 @@ void Controller::pressKey(WORD key) const {
         std::cerr << "Game window not found. Skipping key press.\n";
         return;
     }
-    simulateKeyPress(key);
+    if (flightRecorder) {
+        flightRecorder->recordKeyPress(flightClient, key);
+    }
+    enqueue(InputType::KeyPress, key, 0, 0);
+}
+
+void Controller::setFlightRecorder(FlightRecorder* recorder, int client) {
+    flightRecorder = recorder;
+    flightClient = client;
 }
 
 // Ensure WoW window is active
@@ -189,4 +309,14 @@ void Controller::focusGameWindow() {
     }
 }
 
+// Report input metrics
+void Controller::collectMetrics(MetricsWriter& metrics) const {
+    metrics.gauge("mommyglider_input_queue_depth", "Inputs waiting to be delivered to the game window.",
+        pendingActions.load(std::memory_order_relaxed));
+    metrics.counter("mommyglider_actions_sent_total", "Key presses and clicks delivered to the game window.",
+        static_cast<double>(actionsSent.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_actions_dropped_total", "Stale inputs dropped because the input queue was full.",
+        static_cast<double>(actionsDropped.load(std::memory_order_relaxed)));
+}
+
 // Additional functions like leftClick(), rightClick(), mouse4Click(), etc., can remain the same.
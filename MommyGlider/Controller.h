@@ -12,20 +12,64 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
 #include <windows.h>
 #include "CalibrationData.h"
 
+class FlightRecorder;
+class MetricsWriter;
+
 class Controller {
+public:
+    // Queued inputs beyond this drop the oldest; a stalled key press must not replay stale actions later
+    static constexpr size_t MAX_QUEUED_INPUTS = 8;
+
 private:
     HWND gameWindow; // Handle to the WoW game window
+    mutable std::atomic<uint64_t> actionsSent{ 0 };  // Key presses and clicks delivered to the game
+    mutable std::atomic<int> pendingActions{ 0 };    // Inputs queued or being delivered
+    mutable std::atomic<uint64_t> actionsDropped{ 0 };  // Stale inputs dropped from a full queue
+
+    // One queued key press or click; fields are atomics because a full ring overwrites the slot
+    // the input thread may be reading, which then fails to claim it and discards the copy
+    enum class InputType : uint32_t { KeyPress, Click };
+    struct InputSlot {
+        std::atomic<uint32_t> type{ 0 };
+        std::atomic<int32_t> key{ 0 };
+        std::atomic<int32_t> x{ 0 };
+        std::atomic<int32_t> y{ 0 };
+    };
+
+    // Inputs are delivered on their own thread so a held key never stalls a script tick. The
+    // engine ticking this client is the only producer; queueing neither locks nor allocates.
+    mutable InputSlot inputRing[MAX_QUEUED_INPUTS];
+    mutable std::atomic<uint64_t> inputHead{ 0 };    // Next input to deliver; advanced by the input thread or a drop
+    mutable std::atomic<uint64_t> inputTail{ 0 };    // Next free slot; advanced by the producer
+    mutable std::atomic<uint32_t> inputSignal{ 0 };  // Bumped after every push and on stop; the input thread waits on it
+    std::atomic<bool> stopping{ false };
+    std::thread inputThread;
+    FlightRecorder* flightRecorder = nullptr;  // Records every queued action, if set
+    int flightClient = 0;
 
     HWND findGameWindow();                      // Helper to find the WoW game window
+    void enqueue(InputType type, int key, int x, int y) const; // Queue an input for the input thread
+    void deliverInputs();                       // Input thread loop
     void simulateKeyPress(WORD key, bool useBackgroundInjection) const;      // Simulate a keyboard key press
     void simulateMouseClick(DWORD button) const; // Simulate a mouse click
     void simulateMouseMovement(int x, int y) const; // Simulate mouse movement
+    void simulateClickAt(int x, int y) const;    // Move and left click as one uninterrupted input batch
 
 public:
-    Controller();                              // Constructor
+    explicit Controller(HWND window = NULL);   // Drive the given window, or find the WoW window
+    ~Controller();                             // Stops the input thread, dropping queued inputs
+
+    // Every visible WoW window, for driving several clients from one process
+    static std::vector<HWND> findGameWindows();
+
+    HWND window() const { return gameWindow; }
 
     // Check if WoW is the foreground window
     bool isWoWInForeground() const;
@@ -47,6 +91,12 @@ public:
     // Mouse click with coordinate translation
     void clickAtMonitorCoords(int screenX, int screenY) const;       // Click at monitor coordinates
     void clickAtUICoords(float uiX, float uiY, const CalibrationData& calibration) const; // Click at UI coordinates
+
+    // Record queued actions as client `client`; set before any input is sent
+    void setFlightRecorder(FlightRecorder* recorder, int client);
+
+    // Metrics
+    void collectMetrics(MetricsWriter& metrics) const; // Report input queue depth and actions sent
 };
 
 
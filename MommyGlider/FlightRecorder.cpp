@@ -0,0 +1,248 @@
+/**
+ * @file FlightRecorder.cpp
+ * @brief Implementation of the flight recorder rings, their dump and the crash handlers.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <iostream>
+#include "FlightRecorder.h"
+#include "MetricsServer.h"
+#include "OffsetLayout.h"
+#include "Util.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    // Recorder dumped by the crash handlers and the hotkey
+    std::atomic<FlightRecorder*> crashRecorder{ nullptr };
+    // A crash can pass through several handlers (terminate, then abort's SIGABRT); dump once
+    std::atomic<bool> crashDumped{ false };
+    std::terminate_handler previousTerminate = nullptr;
+
+    void dumpCrash() {
+        FlightRecorder* recorder = crashRecorder.load(std::memory_order_acquire);
+        if (recorder && !crashDumped.exchange(true)) {
+            recorder->dump(FlightDumpReason::Crash);
+        }
+    }
+
+    void onTerminate() {
+        dumpCrash();
+        if (previousTerminate) {
+            previousTerminate();
+        }
+        std::abort();
+    }
+
+    void onFatalSignal(int signal) {
+        dumpCrash();
+        // Back to the default action, so re-raising terminates the way the signal would have
+        std::signal(signal, SIG_DFL);
+        std::raise(signal);
+    }
+
+#ifdef _WIN32
+    LPTOP_LEVEL_EXCEPTION_FILTER previousFilter = nullptr;
+
+    LONG WINAPI onUnhandledException(EXCEPTION_POINTERS* exception) {
+        dumpCrash();
+        return previousFilter ? previousFilter(exception) : EXCEPTION_CONTINUE_SEARCH;
+    }
+#else
+    void onDumpSignal(int) {
+        if (FlightRecorder* recorder = crashRecorder.load(std::memory_order_acquire)) {
+            recorder->dump(FlightDumpReason::Requested);
+        }
+    }
+#endif
+
+} // namespace
+
+FlightRecorder::FlightRecorder(size_t frameSlots, size_t eventSlots)
+    : frameSlotCount(frameSlots > 0 ? frameSlots : 1), eventSlotCount(eventSlots > 0 ? eventSlots : 1),
+      frames(std::make_unique<FlightFrame[]>(frameSlotCount)), events(std::make_unique<FlightEvent[]>(eventSlotCount)) {}
+
+FlightRecorder::~FlightRecorder() {
+    FlightRecorder* self = this;
+    crashRecorder.compare_exchange_strong(self, nullptr);
+    stopHotkey = true;
+    if (hotkeyThread.joinable()) {
+        hotkeyThread.join();
+    }
+}
+
+void FlightRecorder::recordFrame(int client, uint64_t frame, int64_t captureTimeNs, const int* values) {
+    uint64_t ticket = framesRecorded.fetch_add(1, std::memory_order_relaxed);
+    FlightFrame& slot = frames[ticket % frameSlotCount];
+    slot.sequence.store(ticket * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timeNs = captureTimeNs;
+    slot.frame = frame;
+    slot.client = client;
+    std::memcpy(slot.values, values, sizeof(slot.values));
+    slot.sequence.store(ticket * 2 + 2, std::memory_order_release);
+}
+
+void FlightRecorder::recordTick(int client, uint64_t frame, int64_t durationNs, uint64_t instructions, bool failed) {
+    recordEvent(FlightEventType::Tick, failed ? FLIGHT_TICK_FAILED : 0, client,
+        static_cast<int64_t>(frame), durationNs, static_cast<int64_t>(instructions));
+}
+
+void FlightRecorder::recordKeyPress(int client, int key) {
+    recordEvent(FlightEventType::KeyPress, 0, client, key, 0, 0);
+}
+
+void FlightRecorder::recordClick(int client, int x, int y) {
+    recordEvent(FlightEventType::Click, 0, client, x, y, 0);
+}
+
+void FlightRecorder::recordEvent(FlightEventType type, uint16_t flags, int client, int64_t a, int64_t b, int64_t c) {
+    uint64_t ticket = eventsRecorded.fetch_add(1, std::memory_order_relaxed);
+    FlightEvent& slot = events[ticket % eventSlotCount];
+    slot.sequence.store(ticket * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timeNs = monotonicNanos();
+    slot.type = static_cast<uint16_t>(type);
+    slot.flags = flags;
+    slot.client = client;
+    slot.values[0] = a;
+    slot.values[1] = b;
+    slot.values[2] = c;
+    slot.sequence.store(ticket * 2 + 2, std::memory_order_release);
+}
+
+void FlightRecorder::installCrashHandlers(const std::string& path) {
+    if (path.size() >= MAX_PATH_CHARS) {
+        std::cerr << "Error: Flight recorder path " << path << " is too long.\n";
+        return;
+    }
+    std::memcpy(dumpPath, path.c_str(), path.size() + 1);
+    crashRecorder.store(this, std::memory_order_release);
+
+    previousTerminate = std::set_terminate(onTerminate);
+    for (int signal : { SIGSEGV, SIGFPE, SIGILL, SIGABRT }) {
+        std::signal(signal, onFatalSignal);
+    }
+#ifdef _WIN32
+    previousFilter = SetUnhandledExceptionFilter(onUnhandledException);
+    hotkeyThread = std::thread(&FlightRecorder::watchHotkey, this);
+    std::cout << "Flight recorder dumps to " << path << ".<n> on crashes and on Ctrl+Shift+F12.\n";
+#else
+    std::signal(SIGBUS, onFatalSignal);
+    std::signal(SIGUSR1, onDumpSignal);
+    std::cout << "Flight recorder dumps to " << path << ".<n> on crashes and on SIGUSR1.\n";
+#endif
+}
+
+/**
+ * @brief Polls the dump hotkey; a registered hotkey would need a message loop this process lacks.
+ */
+void FlightRecorder::watchHotkey() {
+#ifdef _WIN32
+    bool wasDown = false;
+    while (!stopHotkey) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        bool down = (GetAsyncKeyState(VK_F12) & 0x8000) && (GetAsyncKeyState(VK_CONTROL) & 0x8000)
+            && (GetAsyncKeyState(VK_SHIFT) & 0x8000);
+        if (down && !wasDown) {
+            std::cout << (dump() ? "Flight recorder dumped.\n" : "Error: Flight recorder dump failed.\n");
+        }
+        wasDown = down;
+    }
+#endif
+}
+
+/**
+ * @brief Writes the header and both rings as they are, records being written included.
+ *
+ * Only fixed buffers, the clock and raw file calls are used, so this runs inside signal handlers
+ * and exception filters without allocating or taking locks.
+ */
+bool FlightRecorder::dump(FlightDumpReason reason) {
+    if (!dumpPath[0]) {
+        return false;
+    }
+
+    // "<path>.<n>" without snprintf
+    char path[MAX_PATH_CHARS + 24];
+    size_t length = 0;
+    while (dumpPath[length]) {
+        path[length] = dumpPath[length];
+        ++length;
+    }
+    path[length++] = '.';
+    char digits[20];
+    int digitCount = 0;
+    for (uint64_t number = dumpsWritten.fetch_add(1, std::memory_order_relaxed) + 1; number > 0; number /= 10) {
+        digits[digitCount++] = static_cast<char>('0' + number % 10);
+    }
+    while (digitCount > 0) {
+        path[length++] = digits[--digitCount];
+    }
+    path[length] = '\0';
+
+    FlightRecordHeader header = {};
+    header.magic = FLIGHT_RECORD_MAGIC;
+    header.version = FLIGHT_RECORD_VERSION;
+    header.layoutHash = OFFSET_LAYOUT_HASH;
+    header.valueCount = OFFSET_COUNT;
+    header.frameSlots = static_cast<uint32_t>(frameSlotCount);
+    header.eventSlots = static_cast<uint32_t>(eventSlotCount);
+    header.reason = static_cast<uint32_t>(reason);
+    header.dumpTimeNs = monotonicNanos();
+    header.wallTimeSeconds = static_cast<int64_t>(std::time(nullptr));
+
+    const void* parts[] = { &header, frames.get(), events.get() };
+    size_t sizes[] = { sizeof(header), frameSlotCount * sizeof(FlightFrame), eventSlotCount * sizeof(FlightEvent) };
+    bool written = true;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    for (int part = 0; part < 3 && written; ++part) {
+        DWORD count = 0;
+        written = WriteFile(file, parts[part], static_cast<DWORD>(sizes[part]), &count, NULL) && count == sizes[part];
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        return false;
+    }
+    for (int part = 0; part < 3 && written; ++part) {
+        const char* data = static_cast<const char*>(parts[part]);
+        size_t remaining = sizes[part];
+        while (remaining > 0 && written) {
+            ssize_t count = ::write(file, data, remaining);
+            written = count > 0;
+            data += written ? count : 0;
+            remaining -= written ? static_cast<size_t>(count) : 0;
+        }
+    }
+    ::close(file);
+#endif
+    return written;
+}
+
+void FlightRecorder::collectMetrics(MetricsWriter& metrics) const {
+    metrics.counter("mommyglider_flight_frames_recorded_total", "Published frames appended to the flight recorder.",
+        static_cast<double>(framesRecorded.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_flight_events_recorded_total", "Script ticks and input actions appended to the flight recorder.",
+        static_cast<double>(eventsRecorded.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_flight_dumps_total", "Flight recorder dumps attempted.",
+        static_cast<double>(dumpsWritten.load(std::memory_order_relaxed)));
+}
@@ -0,0 +1,143 @@
+/**
+ * @file FlightRecorder.h
+ * @brief Always-on ring of the latest decoded frames, script ticks and input actions.
+ *
+ * Every published frame, every script tick and every key press or click is appended to fixed-size
+ * rings allocated up front. Appending claims a slot with one atomic increment and copies a few
+ * hundred bytes, so no writer ever waits or allocates. On a crash (unhandled exception, fatal
+ * signal, std::terminate), on the dump hotkey (Ctrl+Shift+F12 on Windows, SIGUSR1 elsewhere) or on
+ * request, the rings are written as they are to `<path>.<n>`, using only calls that are safe inside
+ * a signal handler.
+ *
+ * Dump layout, all little-endian and naturally aligned:
+ *  - FlightRecordHeader
+ *  - frameSlots FlightFrame records
+ *  - eventSlots FlightEvent records
+ *
+ * A record's `sequence` is 2n+1 while the nth record of its ring (counting from 0) is written and
+ * 2n+2 once it is complete; odd or zero sequences are records to skip. Sort by sequence to replay.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include "Snapshot.h"
+
+class MetricsWriter;
+
+constexpr uint32_t FLIGHT_RECORD_MAGIC = 0x4C46474D;  // "MGFL"
+constexpr uint32_t FLIGHT_RECORD_VERSION = 1;
+
+/**
+ * @brief Start of a dump file.
+ */
+struct FlightRecordHeader {
+    uint32_t magic;             ///< FLIGHT_RECORD_MAGIC
+    uint32_t version;           ///< FLIGHT_RECORD_VERSION
+    uint32_t layoutHash;        ///< OFFSET_LAYOUT_HASH of the Offsets.h the values follow
+    uint32_t valueCount;        ///< Values per frame (OFFSET_COUNT)
+    uint32_t frameSlots;        ///< FlightFrame records that follow
+    uint32_t eventSlots;        ///< FlightEvent records after the frames
+    uint32_t reason;            ///< FlightDumpReason
+    uint32_t reserved;
+    int64_t dumpTimeNs;         ///< monotonicNanos() when the dump was written, the clock of every record
+    int64_t wallTimeSeconds;    ///< Unix time at the same moment
+};
+
+/**
+ * @brief One published frame.
+ */
+struct FlightFrame {
+    std::atomic<uint64_t> sequence;
+    int64_t timeNs;             ///< Capture time
+    uint64_t frame;             ///< Snapshot sequence of the client's Memory
+    int32_t client;
+    int32_t reserved;
+    int32_t values[OFFSET_COUNT];
+};
+
+enum class FlightEventType : uint16_t {
+    Tick = 1,       ///< values: frame ticked (0 for a timer-only tick), duration in ns, Lua instructions
+    KeyPress = 2,   ///< values: virtual key code
+    Click = 3       ///< values: monitor x, monitor y
+};
+
+constexpr uint16_t FLIGHT_TICK_FAILED = 1;  ///< Tick flag: the tick function raised an error
+
+/**
+ * @brief One script tick or input action.
+ */
+struct FlightEvent {
+    std::atomic<uint64_t> sequence;
+    int64_t timeNs;             ///< When the tick ended or the action was queued
+    uint16_t type;              ///< FlightEventType
+    uint16_t flags;
+    int32_t client;
+    int64_t values[3];
+};
+
+enum class FlightDumpReason : uint32_t {
+    Requested = 0,  ///< Hotkey, signal or metrics command
+    Crash = 1       ///< Unhandled exception, fatal signal or std::terminate
+};
+
+/**
+ * @class FlightRecorder
+ * @brief Lock-free multi-writer rings with a crash-time dump.
+ */
+class FlightRecorder {
+public:
+    static constexpr size_t DEFAULT_FRAME_SLOTS = 256;
+    static constexpr size_t DEFAULT_EVENT_SLOTS = 4096;
+    static constexpr size_t MAX_PATH_CHARS = 260;
+
+    explicit FlightRecorder(size_t frameSlots = DEFAULT_FRAME_SLOTS, size_t eventSlots = DEFAULT_EVENT_SLOTS);
+    ~FlightRecorder();
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    void recordFrame(int client, uint64_t frame, int64_t captureTimeNs, const int* values);
+    void recordTick(int client, uint64_t frame, int64_t durationNs, uint64_t instructions, bool failed);
+    void recordKeyPress(int client, int key);
+    void recordClick(int client, int x, int y);
+
+    /**
+     * @brief Makes this recorder the one dumped on crashes and on the dump hotkey.
+     * @param path Dumps are written to `<path>.<n>`, n counting from 1.
+     */
+    void installCrashHandlers(const std::string& path);
+
+    /**
+     * @brief Writes the rings to the next dump file. Safe to call from a signal handler.
+     * @return False if the file could not be written.
+     */
+    bool dump(FlightDumpReason reason = FlightDumpReason::Requested);
+
+    void collectMetrics(MetricsWriter& metrics) const;
+
+private:
+    void recordEvent(FlightEventType type, uint16_t flags, int client, int64_t a, int64_t b, int64_t c);
+    void watchHotkey();
+
+    size_t frameSlotCount;
+    size_t eventSlotCount;
+    std::unique_ptr<FlightFrame[]> frames;
+    std::unique_ptr<FlightEvent[]> events;
+    std::atomic<uint64_t> framesRecorded{ 0 };  ///< Also the ticket of the next frame record
+    std::atomic<uint64_t> eventsRecorded{ 0 };
+    std::atomic<uint64_t> dumpsWritten{ 0 };
+
+    char dumpPath[MAX_PATH_CHARS] = {};         ///< Fixed buffer, so a dump never allocates
+    std::atomic<bool> stopHotkey{ false };
+    std::thread hotkeyThread;
+};
+
+#endif // FLIGHTRECORDER_H
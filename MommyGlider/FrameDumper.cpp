@@ -0,0 +1,221 @@
+/**
+ * @file FrameDumper.cpp
+ * @brief Implementation of the triggered frame dumper and its QOI encoder.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "FrameDumper.h"
+#include "MetricsServer.h"
+#include "Util.h"
+
+/**
+ * @brief Encodes 0x00RRGGBB pixels as a 3-channel QOI image (https://qoiformat.org).
+ *
+ * @param out Receives the file contents; reused between calls to avoid reallocating.
+ */
+static void encodeQoi(const uint32_t* pixels, int width, int height, std::vector<uint8_t>& out) {
+    auto put32 = [&out](uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    };
+    out.clear();
+    out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+    put32(static_cast<uint32_t>(width));
+    put32(static_cast<uint32_t>(height));
+    out.push_back(3); // RGB
+    out.push_back(0); // sRGB
+
+    // Pixels are kept with an opaque alpha byte, so empty index entries (all zero) never match
+    uint32_t index[64] = {};
+    uint32_t previous = 0xFF000000;
+    int run = 0;
+    size_t count = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t pixel = pixels[i] | 0xFF000000;
+        if (pixel == previous) {
+            if (++run == 62 || i + 1 == count) {
+                out.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            out.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+            run = 0;
+        }
+
+        int r = (pixel >> 16) & 0xFF, g = (pixel >> 8) & 0xFF, b = pixel & 0xFF;
+        int slot = (r * 3 + g * 5 + b * 7 + 255 * 11) % 64;
+        if (index[slot] == pixel) {
+            out.push_back(static_cast<uint8_t>(slot));
+        }
+        else {
+            index[slot] = pixel;
+            int8_t dr = static_cast<int8_t>(r - ((previous >> 16) & 0xFF));
+            int8_t dg = static_cast<int8_t>(g - ((previous >> 8) & 0xFF));
+            int8_t db = static_cast<int8_t>(b - (previous & 0xFF));
+            int8_t drg = static_cast<int8_t>(dr - dg), dbg = static_cast<int8_t>(db - dg);
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                out.push_back(static_cast<uint8_t>(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+            }
+            else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                out.push_back(static_cast<uint8_t>(0x80 | (dg + 32)));
+                out.push_back(static_cast<uint8_t>((drg + 8) << 4 | (dbg + 8)));
+            }
+            else {
+                out.insert(out.end(), { 0xFE, static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b) });
+            }
+        }
+        previous = pixel;
+    }
+    out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+}
+
+// Destructor
+FrameDumper::~FrameDumper() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopThread = true;
+    }
+    wake.notify_all();
+    if (encoderThread.joinable()) {
+        encoderThread.join();
+    }
+}
+
+bool FrameDumper::open(const std::string& dumpDirectory, const std::vector<int>& panelWidths, size_t retainedFrames) {
+    std::error_code error;
+    std::filesystem::create_directories(dumpDirectory, error);
+    if (error) {
+        std::cerr << "Error: Unable to create frame dump directory " << dumpDirectory << ": " << error.message() << "\n";
+        return false;
+    }
+    directory = dumpDirectory;
+    widths = panelWidths;
+    width = std::max(1, *std::max_element(widths.begin(), widths.end()));
+    rows = static_cast<int>(widths.size());
+    retained = std::max<size_t>(retainedFrames, 1);
+
+    size_t frameSize = static_cast<size_t>(width) * rows;
+    for (Ring& ring : rings) {
+        ring.pixels.assign(retained * frameSize, 0);
+        ring.frames.assign(retained, 0);
+    }
+    latestRows.assign(frameSize, 0);
+    encoderThread = std::thread(&FrameDumper::encodeLoop, this);
+    std::cout << "Retaining the last " << retained << " frames for dumps to " << directory << "\n";
+    return true;
+}
+
+void FrameDumper::record(const uint32_t* const panelRows[], uint64_t frame) {
+    Ring& ring = rings[active];
+    uint32_t* slot = ring.pixels.data() + ring.next * width * rows;
+    for (int row = 0; row < rows; ++row) {
+        uint32_t* latest = latestRows.data() + static_cast<size_t>(row) * width;
+        if (panelRows[row]) {
+            std::memcpy(latest, panelRows[row], widths[row] * sizeof(uint32_t));
+        }
+        std::memcpy(slot + static_cast<size_t>(row) * width, latest, width * sizeof(uint32_t));
+    }
+    ring.frames[ring.next] = frame;
+    ring.next = (ring.next + 1) % retained;
+    ring.count = std::min(ring.count + 1, retained);
+    recorded.fetch_add(1, std::memory_order_relaxed);
+
+    // Hand the ring over without ever waiting for the encoder
+    if (!triggered.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock() || flushRing >= 0) {
+        return;
+    }
+    flushRing = active;
+    active ^= 1;
+    rings[active].count = 0;
+    rings[active].next = 0;
+    triggered.store(false, std::memory_order_relaxed);
+    lock.unlock();
+    wake.notify_one();
+}
+
+void FrameDumper::trigger(const std::string& reason) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingReason = reason;
+    triggered.store(true, std::memory_order_release);
+}
+
+void FrameDumper::encodeLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopThread || flushRing >= 0; });
+        if (stopThread) {
+            return;
+        }
+        std::string reason = pendingReason;
+        const Ring& ring = rings[flushRing];
+        lock.unlock();
+
+        int64_t start = monotonicNanos();
+        writeRing(ring, reason, dumps.fetch_add(1, std::memory_order_relaxed) + 1);
+        encodeNs.fetch_add(static_cast<uint64_t>(monotonicNanos() - start), std::memory_order_relaxed);
+
+        lock.lock();
+        flushRing = -1;
+    }
+}
+
+/**
+ * @brief Encodes the frames of a ring, oldest first, into a directory of their own.
+ */
+void FrameDumper::writeRing(const Ring& ring, const std::string& reason, uint64_t dump) {
+    std::string name = std::to_string(dump);
+    if (!reason.empty()) {
+        name += "-";
+        for (char c : reason) {
+            name += std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' ? c : '_';
+        }
+    }
+    std::filesystem::path path = std::filesystem::path(directory) / name;
+    std::error_code error;
+    std::filesystem::create_directories(path, error);
+    if (error) {
+        std::cerr << "Error: Unable to create frame dump directory " << path.string() << ": " << error.message() << "\n";
+        return;
+    }
+
+    std::vector<uint8_t> encoded;
+    size_t frameSize = static_cast<size_t>(width) * rows;
+    size_t oldest = (ring.next + retained - ring.count) % retained;
+    for (size_t i = 0; i < ring.count; ++i) {
+        size_t slot = (oldest + i) % retained;
+        encodeQoi(ring.pixels.data() + slot * frameSize, width, rows, encoded);
+        std::ofstream file(path / (std::to_string(ring.frames[slot]) + ".qoi"), std::ios::binary);
+        if (!file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()))) {
+            std::cerr << "Error: Unable to write frame dump to " << path.string() << "\n";
+            return;
+        }
+        framesWritten.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::cout << "Dumped " << ring.count << " frames to " << path.string() << "\n";
+}
+
+void FrameDumper::collectMetrics(MetricsWriter& metrics) const {
+    metrics.counter("mommyglider_frame_dump_recorded_total", "Captured frames copied into the dump ring.",
+        static_cast<double>(recorded.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_frame_dumps_total", "Triggered dumps written out.",
+        static_cast<double>(dumps.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_frame_dump_frames_written_total", "Frames encoded to QOI files.",
+        static_cast<double>(framesWritten.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_frame_dump_encode_seconds_total", "Time the dump thread spent encoding and writing.",
+        encodeNs.load(std::memory_order_relaxed) / 1e9);
+}
@@ -0,0 +1,105 @@
+/**
+ * @file FrameDumper.h
+ * @brief Retains the last captured strips and writes them out as QOI images when triggered.
+ *
+ * The capture thread copies every captured strip into a ring of preallocated slots, a few hundred
+ * bytes per frame and no allocation. trigger() hands the filled ring to a background thread,
+ * which encodes each retained frame as a lossless QOI image while capture goes on into a second
+ * ring. Scripts trigger a dump right after a bad decision to see exactly what was decoded.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef FRAMEDUMPER_H
+#define FRAMEDUMPER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class MetricsWriter;
+
+/**
+ * @class FrameDumper
+ * @brief Double-buffered frame ring with an encoder thread.
+ *
+ * Image row r holds row 0 of panel r as captured; a panel not captured that frame repeats its
+ * previous row.
+ */
+class FrameDumper {
+public:
+    static constexpr size_t DEFAULT_RETAINED_FRAMES = 200;
+
+    FrameDumper() = default;
+    ~FrameDumper();
+    FrameDumper(const FrameDumper&) = delete;
+    FrameDumper& operator=(const FrameDumper&) = delete;
+
+    /**
+     * @brief Allocates the rings and starts the encoder thread.
+     * @param directory Dumps go to directory/<trigger>-<reason>/<frame>.qoi.
+     * @param widths Width in pixels of each panel row.
+     * @param retainedFrames Frames kept before the oldest is overwritten.
+     * @return False if the directory cannot be created; the error has been reported.
+     */
+    bool open(const std::string& directory, const std::vector<int>& widths, size_t retainedFrames);
+
+    /**
+     * @brief Copies one captured frame into the ring. Capture thread only; never blocks.
+     * @param rows Row 0 of each panel, null for a panel not captured this frame.
+     * @param frame Capture number, used as the file name.
+     */
+    void record(const uint32_t* const rows[], uint64_t frame);
+
+    /**
+     * @brief Writes out the retained frames. Callable from any thread.
+     *
+     * The ring is handed over at the next recorded frame. A trigger while the previous dump is
+     * still being written is kept and served once that dump is done.
+     */
+    void trigger(const std::string& reason);
+
+    void collectMetrics(MetricsWriter& metrics) const;
+
+private:
+    struct Ring {
+        std::vector<uint32_t> pixels;   ///< retainedFrames images of width x rows
+        std::vector<uint64_t> frames;
+        size_t count = 0;               ///< Frames held, at most retainedFrames
+        size_t next = 0;                ///< Slot written next
+    };
+
+    void encodeLoop();
+    void writeRing(const Ring& ring, const std::string& reason, uint64_t dump);
+
+    std::string directory;
+    std::vector<int> widths;
+    int width = 0;
+    int rows = 0;
+    size_t retained = 0;
+
+    // Owned by the capture thread, except the ring being flushed
+    Ring rings[2];
+    int active = 0;
+    std::vector<uint32_t> latestRows;   ///< Last captured row of each panel
+
+    std::mutex mutex;                   ///< Guards the fields below; the capture thread only try-locks it
+    std::condition_variable wake;
+    std::string pendingReason;
+    int flushRing = -1;                 ///< Ring handed to the encoder, -1 while it is idle
+    bool stopThread = false;
+    std::atomic<bool> triggered{ false };
+    std::thread encoderThread;
+
+    std::atomic<uint64_t> recorded{ 0 };
+    std::atomic<uint64_t> dumps{ 0 };
+    std::atomic<uint64_t> framesWritten{ 0 };
+    std::atomic<uint64_t> encodeNs{ 0 };
+};
+
+#endif // FRAMEDUMPER_H
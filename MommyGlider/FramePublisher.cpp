@@ -0,0 +1,152 @@
+/**
+ * @file FramePublisher.cpp
+ * @brief Implementation of the shared-memory frame ring writer.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <algorithm>
+#include <iostream>
+#include "FramePublisher.h"
+#include "Memory.h"
+#include "MetricsServer.h"
+
+FramePublisher::~FramePublisher() {
+    close();
+}
+
+bool FramePublisher::open(const std::string& name, const std::map<std::string, OffsetMetadata, std::less<>>& schema, int valueCount) {
+    close();
+    ringName = name;
+
+    size_t slotsOffset = sizeof(FrameRingHeader) + schema.size() * sizeof(FrameRingOffset);
+    slotsOffset = (slotsOffset + 63) & ~static_cast<size_t>(63);
+    size_t slotSize = (sizeof(FrameRingSlot) + valueCount * sizeof(int32_t) + 63) & ~static_cast<size_t>(63);
+    viewSize = slotsOffset + SLOT_COUNT * slotSize;
+
+#ifdef _WIN32
+    HANDLE fileMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, static_cast<DWORD>(viewSize),
+        frameRingMappingName(name).c_str());
+    if (!fileMapping) {
+        std::cerr << "Error: Unable to create shared frame ring " << name << " (" << GetLastError() << ").\n";
+        return false;
+    }
+    mapping = fileMapping;
+    view = static_cast<uint8_t*>(MapViewOfFile(fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, viewSize));
+    wake = CreateSemaphoreA(NULL, 0, 1024, frameRingSemaphoreName(name).c_str());
+#else
+    int fd = shm_open(frameRingMappingName(name).c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(viewSize)) != 0) {
+        std::cerr << "Error: Unable to create shared frame ring " << name << " (" << errno << ").\n";
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+    void* mapped = mmap(nullptr, viewSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    view = mapped == MAP_FAILED ? nullptr : static_cast<uint8_t*>(mapped);
+    sem_t* semaphore = sem_open(frameRingSemaphoreName(name).c_str(), O_CREAT, 0600, 0);
+    wake = semaphore == SEM_FAILED ? nullptr : semaphore;
+#endif
+    if (!view || !wake) {
+        std::cerr << "Error: Unable to map shared frame ring " << name << ".\n";
+        close();
+        return false;
+    }
+
+    // A previous run may have left a ring behind; start from a clean region
+    std::fill(view, view + viewSize, uint8_t(0));
+    FrameRingHeader& ring = header();
+    ring.version = FRAME_RING_VERSION;
+    ring.offsetCount = static_cast<uint32_t>(schema.size());
+    ring.valueCount = static_cast<uint32_t>(valueCount);
+    ring.slotCount = SLOT_COUNT;
+    ring.slotSize = static_cast<uint32_t>(slotSize);
+    ring.slotsOffset = slotsOffset;
+
+    auto* entries = reinterpret_cast<FrameRingOffset*>(view + sizeof(FrameRingHeader));
+    for (const auto& [key, metadata] : schema) {
+        if (key.size() >= FRAME_RING_NAME_CHARS) {
+            std::cerr << "Warning: Offset name " << key << " is truncated in the shared frame schema.\n";
+        }
+        key.copy(entries->name, FRAME_RING_NAME_CHARS - 1);
+        metadata.type.copy(entries->type, FRAME_RING_TYPE_CHARS - 1);
+        entries->index = metadata.index;
+        ++entries;
+    }
+
+    // Readers check the magic last, so it is written after everything else
+    std::atomic_thread_fence(std::memory_order_release);
+    ring.magic = FRAME_RING_MAGIC;
+    std::cout << "Publishing frames to shared memory ring " << name << "\n";
+    return true;
+}
+
+void FramePublisher::close() {
+#ifdef _WIN32
+    if (view) {
+        UnmapViewOfFile(view);
+    }
+    if (mapping) {
+        CloseHandle(static_cast<HANDLE>(mapping));
+    }
+    if (wake) {
+        CloseHandle(static_cast<HANDLE>(wake));
+    }
+#else
+    if (view) {
+        munmap(view, viewSize);
+        shm_unlink(frameRingMappingName(ringName).c_str());
+    }
+    if (wake) {
+        sem_close(static_cast<sem_t*>(wake));
+        sem_unlink(frameRingSemaphoreName(ringName).c_str());
+    }
+#endif
+    view = nullptr;
+    mapping = nullptr;
+    wake = nullptr;
+}
+
+void FramePublisher::publish(uint64_t frame, const int* values, int64_t captureTimeNs) {
+    if (!view) {
+        return;
+    }
+    FrameRingHeader& ring = header();
+    auto& slot = *reinterpret_cast<FrameRingSlot*>(view + ring.slotsOffset + (frame % ring.slotCount) * ring.slotSize);
+    auto* slotValues = reinterpret_cast<std::atomic<int32_t>*>(&slot + 1);
+
+    slot.lock.store(frame * 2 - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.captureTimeNs.store(captureTimeNs, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < ring.valueCount; ++i) {
+        slotValues[i].store(values[i], std::memory_order_relaxed);
+    }
+    slot.lock.store(frame * 2, std::memory_order_release);
+    ring.latest.store(frame, std::memory_order_release);
+    published.fetch_add(1, std::memory_order_relaxed);
+
+    // Only readers that gave up spinning need a system call to wake up
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint32_t waiting = ring.waiters.load(std::memory_order_relaxed);
+    if (waiting == 0) {
+        return;
+    }
+    wakeups.fetch_add(1, std::memory_order_relaxed);
+#ifdef _WIN32
+    ReleaseSemaphore(static_cast<HANDLE>(wake), static_cast<LONG>(waiting), NULL);
+#else
+    for (uint32_t i = 0; i < waiting; ++i) {
+        sem_post(static_cast<sem_t*>(wake));
+    }
+#endif
+}
+
+void FramePublisher::collectMetrics(MetricsWriter& metrics) const {
+    metrics.counter("mommyglider_shared_frames_published_total", "Frames written to the shared-memory ring.",
+        static_cast<double>(published.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_shared_frames_wakeups_total", "Frames that had to wake a sleeping out-of-process reader.",
+        static_cast<double>(wakeups.load(std::memory_order_relaxed)));
+}
@@ -0,0 +1,65 @@
+/**
+ * @file FramePublisher.h
+ * @brief Writer side of the shared-memory frame ring described in FrameRing.h.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef FRAMEPUBLISHER_H
+#define FRAMEPUBLISHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "FrameRing.h"
+
+struct OffsetMetadata;
+class MetricsWriter;
+
+/**
+ * @class FramePublisher
+ * @brief Creates a named frame ring and copies every decoded frame into it.
+ *
+ * Only the capture thread calls publish(); readers in other processes never block it.
+ */
+class FramePublisher {
+public:
+    static constexpr uint32_t SLOT_COUNT = 8; ///< Frames a slow reader can lag behind before losing one
+
+    FramePublisher() = default;
+    ~FramePublisher();
+    FramePublisher(const FramePublisher&) = delete;
+    FramePublisher& operator=(const FramePublisher&) = delete;
+
+    /**
+     * @brief Creates the ring and writes the schema.
+     * @param name Ring name passed to FrameReader::open, e.g. "MommyGlider.Frames.0".
+     * @param schema Offsets.h entries, normally Memory::offsetIndices.
+     * @param valueCount Values per frame (OFFSET_COUNT).
+     * @return False if the shared objects could not be created; the error has been reported.
+     */
+    bool open(const std::string& name, const std::map<std::string, OffsetMetadata, std::less<>>& schema, int valueCount);
+
+    /**
+     * @brief Writes frame `frame` (counting from 1) and wakes sleeping readers.
+     */
+    void publish(uint64_t frame, const int* values, int64_t captureTimeNs);
+
+    void collectMetrics(MetricsWriter& metrics) const;
+
+private:
+    FrameRingHeader& header() { return *reinterpret_cast<FrameRingHeader*>(view); }
+    void close();
+
+    std::string ringName;
+    uint8_t* view = nullptr;
+    size_t viewSize = 0;
+    void* mapping = nullptr;    ///< File mapping handle (Windows)
+    void* wake = nullptr;       ///< Semaphore readers sleep on
+    std::atomic<uint64_t> published{ 0 };
+    std::atomic<uint64_t> wakeups{ 0 };
+};
+
+#endif // FRAMEPUBLISHER_H
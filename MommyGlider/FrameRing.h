@@ -0,0 +1,330 @@
+/**
+ * @file FrameRing.h
+ * @brief Shared-memory layout of published frames, and a header-only reader for other processes.
+ *
+ * A Memory with shared frames enabled writes every decoded frame into a named shared-memory ring
+ * (FramePublisher). Any number of local processes can open it with FrameReader and read the game
+ * state without capturing the screen themselves. This header has no dependency on the rest of the
+ * project, so tools can copy it as is.
+ *
+ * Layout, all little-endian and naturally aligned:
+ *  - FrameRingHeader
+ *  - FrameRingOffset[offsetCount]  the Offsets.h schema: name, index and type of every value
+ *  - slotCount slots of slotSize bytes, each a FrameRingSlot followed by valueCount int32 values
+ *
+ * Frame n (counting from 1) lives in slot n % slotCount. A slot's `lock` is 2n-1 while frame n is
+ * being written and 2n once it is complete, so a reader that sees the same even value before and
+ * after copying has a consistent frame. Readers poll `latest` and only fall back to a named
+ * semaphore once they have to sleep; the writer only signals it when a reader is waiting.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef FRAMERING_H
+#define FRAMERING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+constexpr uint32_t FRAME_RING_MAGIC = 0x5246474D;  // "MGFR"
+constexpr uint32_t FRAME_RING_VERSION = 2;
+constexpr size_t FRAME_RING_NAME_CHARS = 48;
+constexpr size_t FRAME_RING_TYPE_CHARS = 16;
+
+/**
+ * @brief Start of the shared region.
+ */
+struct FrameRingHeader {
+    uint32_t magic;                     ///< FRAME_RING_MAGIC once the writer finished initialising
+    uint32_t version;                   ///< FRAME_RING_VERSION
+    uint32_t offsetCount;               ///< Entries in the schema table
+    uint32_t valueCount;                ///< Values per frame (highest offset index + 1)
+    uint32_t slotCount;                 ///< Frames kept in the ring
+    uint32_t slotSize;                  ///< Bytes per slot, including its FrameRingSlot
+    uint64_t slotsOffset;               ///< Byte offset of the first slot from the start of the region
+    std::atomic<uint64_t> latest;       ///< Number of the newest complete frame, 0 before the first
+    std::atomic<uint32_t> waiters;      ///< Readers sleeping (or about to) on the semaphore
+    uint32_t reserved;
+};
+
+/**
+ * @brief Schema entry for one offset of Offsets.h.
+ */
+struct FrameRingOffset {
+    char name[FRAME_RING_NAME_CHARS];   ///< NUL-terminated, truncated if longer
+    char type[FRAME_RING_TYPE_CHARS];   ///< "int", "bool" or "StringId" (an id without its text)
+    int32_t index;                      ///< Position in the values array
+    int32_t reserved;
+};
+
+/**
+ * @brief Start of one slot; the frame's values follow it.
+ */
+struct FrameRingSlot {
+    std::atomic<uint64_t> lock;         ///< 2n-1 while frame n is written, 2n when complete
+    std::atomic<int64_t> captureTimeNs; ///< Writer's monotonic clock when the strip was copied
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<int64_t>::is_always_lock_free &&
+    std::atomic<int32_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+    "shared-memory atomics must be lock-free");
+
+/**
+ * @brief Names of the shared objects behind a ring called `name`.
+ */
+inline std::string frameRingMappingName(const std::string& name) {
+#ifdef _WIN32
+    return "Local\\" + name;
+#else
+    return "/" + name;
+#endif
+}
+
+inline std::string frameRingSemaphoreName(const std::string& name) {
+#ifdef _WIN32
+    return "Local\\" + name + ".wake";
+#else
+    return "/" + name + ".wake";
+#endif
+}
+
+/**
+ * @class FrameReader
+ * @brief Read-only view of a frame ring published by another process.
+ */
+class FrameReader {
+public:
+    FrameReader() = default;
+    ~FrameReader() { close(); }
+    FrameReader(const FrameReader&) = delete;
+    FrameReader& operator=(const FrameReader&) = delete;
+
+    /**
+     * @brief Maps the ring called `name`, e.g. "MommyGlider.Frames.0".
+     * @return False if it does not exist (yet) or has an unknown layout.
+     */
+    bool open(const std::string& name) {
+        close();
+#ifdef _WIN32
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, frameRingMappingName(name).c_str());
+        if (!mapping) {
+            return false;
+        }
+        // Map the header first to learn the full size
+        auto* peek = static_cast<const FrameRingHeader*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(FrameRingHeader)));
+        if (!peek) {
+            close();
+            return false;
+        }
+        bool ready = peek->magic == FRAME_RING_MAGIC;
+        size_t size = regionSize(*peek);
+        UnmapViewOfFile(peek);
+        if (!ready) {
+            close();
+            return false;
+        }
+        view = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+        wake = OpenSemaphoreA(SYNCHRONIZE, FALSE, frameRingSemaphoreName(name).c_str());
+#else
+        int fd = shm_open(frameRingMappingName(name).c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FrameRingHeader)) {
+            ::close(fd);
+            return false;
+        }
+        viewSize = static_cast<size_t>(info.st_size);
+        void* mapped = mmap(nullptr, viewSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        view = mapped == MAP_FAILED ? nullptr : static_cast<uint8_t*>(mapped);
+        sem_t* semaphore = sem_open(frameRingSemaphoreName(name).c_str(), 0);
+        wake = semaphore == SEM_FAILED ? nullptr : semaphore;
+#endif
+        if (!view || header().magic != FRAME_RING_MAGIC || header().version != FRAME_RING_VERSION) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (view) {
+            UnmapViewOfFile(view);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (wake) {
+            CloseHandle(wake);
+        }
+        mapping = NULL;
+        wake = NULL;
+#else
+        if (view) {
+            munmap(view, viewSize);
+        }
+        if (wake) {
+            sem_close(static_cast<sem_t*>(wake));
+        }
+        wake = nullptr;
+#endif
+        view = nullptr;
+    }
+
+    bool isOpen() const { return view != nullptr; }
+
+    /**
+     * @brief Offsets.h schema published by the writer.
+     */
+    const FrameRingOffset* offsets() const { return reinterpret_cast<const FrameRingOffset*>(view + sizeof(FrameRingHeader)); }
+    uint32_t offsetCount() const { return header().offsetCount; }
+    uint32_t valueCount() const { return header().valueCount; }
+
+    /**
+     * @brief Index of the offset called `name`, or -1.
+     */
+    int indexOf(const char* name) const {
+        for (uint32_t i = 0; i < offsetCount(); ++i) {
+            if (std::strncmp(offsets()[i].name, name, FRAME_RING_NAME_CHARS) == 0) {
+                return offsets()[i].index;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Number of the newest complete frame; a plain load from shared memory.
+     */
+    uint64_t latest() const { return header().latest.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Copies the newest frame.
+     * @param values Receives valueCount() values.
+     * @param captureTimeNs Optional; receives the writer's capture timestamp.
+     * @return Number of the frame copied, or 0 if nothing was published yet.
+     */
+    uint64_t read(std::vector<int32_t>& values, int64_t* captureTimeNs = nullptr) const {
+        values.resize(valueCount());
+        for (;;) {
+            uint64_t frame = latest();
+            if (frame == 0) {
+                return 0;
+            }
+            const FrameRingSlot& slot = slotFor(frame);
+            uint64_t before = slot.lock.load(std::memory_order_acquire);
+            if (before != frame * 2) {
+                continue; // Overwritten by a newer frame since `latest` was read
+            }
+            const auto* source = reinterpret_cast<const std::atomic<int32_t>*>(&slot + 1);
+            for (uint32_t i = 0; i < valueCount(); ++i) {
+                values[i] = source[i].load(std::memory_order_relaxed);
+            }
+            int64_t time = slot.captureTimeNs.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.lock.load(std::memory_order_relaxed) == before) {
+                if (captureTimeNs) {
+                    *captureTimeNs = time;
+                }
+                return frame;
+            }
+        }
+    }
+
+    /**
+     * @brief Waits until a frame newer than `lastFrame` is published.
+     *
+     * Spins on `latest` first, which costs no system call when frames arrive quickly; only then
+     * registers as a waiter and sleeps on the writer's semaphore.
+     *
+     * @return The newest frame number, equal to lastFrame if the wait timed out.
+     */
+    uint64_t waitForFrame(uint64_t lastFrame, uint32_t timeoutMs) const {
+        for (int spin = 0; spin < 2000; ++spin) {
+            uint64_t frame = latest();
+            if (frame != lastFrame) {
+                return frame;
+            }
+            pause();
+        }
+        if (!wake) {
+            return latest();
+        }
+
+        FrameRingHeader& shared = const_cast<FrameRingHeader&>(header());
+        shared.waiters.fetch_add(1, std::memory_order_seq_cst);
+        // Pairs with the writer's fence: either it sees this waiter or this load sees its frame
+        uint64_t frame = shared.latest.load(std::memory_order_seq_cst);
+        if (frame == lastFrame) {
+#ifdef _WIN32
+            WaitForSingleObject(wake, timeoutMs);
+#else
+            timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += timeoutMs / 1000;
+            deadline.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000;
+            if (deadline.tv_nsec >= 1000000000) {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000;
+            }
+            while (sem_timedwait(static_cast<sem_t*>(wake), &deadline) != 0 && errno == EINTR) {
+            }
+#endif
+            frame = latest();
+        }
+        // A wake-up left unconsumed by a timeout only makes a later wait return early
+        shared.waiters.fetch_sub(1, std::memory_order_relaxed);
+        return frame;
+    }
+
+    static size_t regionSize(const FrameRingHeader& header) {
+        return static_cast<size_t>(header.slotsOffset) + static_cast<size_t>(header.slotCount) * header.slotSize;
+    }
+
+private:
+    const FrameRingHeader& header() const { return *reinterpret_cast<const FrameRingHeader*>(view); }
+
+    const FrameRingSlot& slotFor(uint64_t frame) const {
+        size_t slot = static_cast<size_t>(frame % header().slotCount);
+        return *reinterpret_cast<const FrameRingSlot*>(view + header().slotsOffset + slot * header().slotSize);
+    }
+
+    static void pause() {
+#ifdef _WIN32
+        YieldProcessor();
+#else
+        sched_yield();
+#endif
+    }
+
+    uint8_t* view = nullptr;
+#ifdef _WIN32
+    HANDLE mapping = NULL;
+    HANDLE wake = NULL;
+#else
+    size_t viewSize = 0;
+    void* wake = nullptr;
+#endif
+};
+
+#endif // FRAMERING_H
@@ -0,0 +1,87 @@
+/**
+ * @file GdiCapture.cpp
+ * @brief Implementation of the GDI capture backend.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifdef _WIN32
+
+#include <iostream>
+#include "GdiCapture.h"
+
+// Destructor
+GdiCapture::~GdiCapture() {
+    releaseBuffer();
+    if (memDC) {
+        DeleteDC(memDC);
+    }
+    if (screenDC) {
+        ReleaseDC(NULL, screenDC);
+    }
+}
+
+bool GdiCapture::open() {
+    screenDC = GetDC(NULL);
+    memDC = screenDC ? CreateCompatibleDC(screenDC) : NULL;
+    if (!memDC) {
+        std::cerr << "Error: Unable to open the screen device context.\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Makes the DIB section at least width x height pixels.
+ *
+ * @return False if it could not be created; the error has been reported.
+ */
+bool GdiCapture::resize(int width, int height) {
+    if (dib && width <= bufferWidth && height <= bufferHeight) {
+        return true;
+    }
+    releaseBuffer();
+
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height; // Top-down rows
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    void* buffer = nullptr;
+    dib = CreateDIBSection(screenDC, &info, DIB_RGB_COLORS, &buffer, NULL, 0);
+    if (!dib) {
+        std::cerr << "Error: Unable to create a " << width << "x" << height << " capture buffer.\n";
+        return false;
+    }
+    previousBitmap = SelectObject(memDC, dib);
+    bits = static_cast<const uint32_t*>(buffer);
+    bufferWidth = width;
+    bufferHeight = height;
+    return true;
+}
+
+bool GdiCapture::copy(int x, int y, int width, int height, int bufferX, int bufferY) {
+    return BitBlt(memDC, bufferX, bufferY, width, height, screenDC, x, y, SRCCOPY) != FALSE;
+}
+
+void GdiCapture::finish() {
+    GdiFlush(); // The DIB's pixels are only valid once GDI has finished writing them
+}
+
+void GdiCapture::releaseBuffer() {
+    if (!dib) {
+        return;
+    }
+    SelectObject(memDC, previousBitmap);
+    DeleteObject(dib);
+    dib = NULL;
+    bits = nullptr;
+    bufferWidth = 0;
+    bufferHeight = 0;
+}
+
+#endif // _WIN32
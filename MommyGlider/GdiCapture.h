@@ -0,0 +1,51 @@
+/**
+ * @file GdiCapture.h
+ * @brief Capture backend copying the screen into a DIB section with BitBlt.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef GDICAPTURE_H
+#define GDICAPTURE_H
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include "CaptureBackend.h"
+
+/**
+ * @class GdiCapture
+ * @brief BitBlt from the screen DC into a top-down 32-bit DIB section.
+ */
+class GdiCapture : public CaptureBackend {
+public:
+    GdiCapture() = default;
+    ~GdiCapture() override;
+    GdiCapture(const GdiCapture&) = delete;
+    GdiCapture& operator=(const GdiCapture&) = delete;
+
+    const char* name() const override { return "gdi"; }
+    bool open() override;
+    bool resize(int width, int height) override;
+    bool copy(int x, int y, int width, int height, int bufferX, int bufferY) override;
+    bool copiesRegions() const override { return true; }
+    void finish() override;
+    const uint32_t* pixels() const override { return bits; }
+    int stride() const override { return bufferWidth; }
+
+private:
+    void releaseBuffer();
+
+    HDC screenDC = NULL;
+    HDC memDC = NULL;
+    HBITMAP dib = NULL;
+    HGDIOBJ previousBitmap = NULL;
+    const uint32_t* bits = nullptr;     ///< Top-down BGRA rows of the DIB section
+    int bufferWidth = 0;
+    int bufferHeight = 0;
+};
+
+#endif // _WIN32
+
+#endif // GDICAPTURE_H
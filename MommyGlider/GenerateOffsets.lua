@@ -0,0 +1,259 @@
+-- GenerateOffsets.lua
+-- Compiles Offsets.schema.lua into the C++ offset table and the addon encoder.
+--
+-- Usage: lua GenerateOffsets.lua [projectDir]
+-- The outputs are checked in; MommyGlider.vcxproj only runs this with /p:RegenerateOffsets=true.
+--
+-- Writes:
+--   Offsets.h         DEFINE_MEMORY_OFFSET(name, type, index, rate, column, bit) per offset
+--   OffsetLayout.h    OFFSET_LAYOUT_HASH, checked by Memory against the LayoutHash pixel
+--   Interface/aura.lua  the section between the GENERATED OFFSETS markers
+--
+-- Layout of each panel: the fast panel starts with Calibration, LayoutHash and TickCounter and ends
+-- with TickCounterTail, the slow panel starts with its calibration marker. Every int takes one pixel; bools are packed 24 to a pixel, hottest first.
+-- Pixels are then ordered by hotness, so the offsets scripts read most sit contiguously at the
+-- start of the strip. Ties keep schema order, which keeps the layout stable across small edits.
+-- Every CHECK_GROUP_SIZE pixels, and after the last one, a check pixel holds the XOR of the group's
+-- colors and CHECK_SEED, so Memory can reject a group the screen copy corrupted.
+
+local BITS_PER_PIXEL = 24
+local CHECK_GROUP_SIZE = 16
+-- Keeps an all-black group from passing its check
+local CHECK_SEED = 0x5AA55A
+local BEGIN_MARKER = "-- BEGIN GENERATED OFFSETS"
+local END_MARKER = "-- END GENERATED OFFSETS"
+
+local projectDir = arg[1] or (arg[0]:match("^(.*)[/\\]") or ".")
+
+local function readFile(path)
+    local file = assert(io.open(path, "rb"))
+    local contents = file:read("a")
+    file:close()
+    return contents
+end
+
+-- Only rewrites files whose contents changed, so unchanged outputs do not trigger a rebuild
+local function writeFile(path, contents)
+    local existing = io.open(path, "rb")
+    if existing then
+        local current = existing:read("a")
+        existing:close()
+        if current == contents then
+            return
+        end
+    end
+    local file = assert(io.open(path, "wb"))
+    file:write(contents)
+    file:close()
+    print("Generated " .. path)
+end
+
+local schema = dofile(projectDir .. "/Offsets.schema.lua")
+
+-- Validate and index the schema
+local byName = {}
+for index, entry in ipairs(schema) do
+    entry.index = index - 1
+    assert(entry.name:match("^[%a_][%w_]*$"), "invalid offset name: " .. entry.name)
+    assert(not byName[entry.name], "duplicate offset: " .. entry.name)
+    assert(entry.codec == "int" or entry.codec == "bool" or entry.codec == "string", entry.name .. ": codec must be int, bool or string")
+    assert(entry.rate == "Fast" or entry.rate == "Slow", entry.name .. ": rate must be Fast or Slow")
+    byName[entry.name] = entry
+end
+local header = { Fast = { "Calibration", "LayoutHash", "TickCounter" }, Slow = {} }
+local trailer = { Fast = { "TickCounterTail" }, Slow = {} }
+for _, names in ipairs({ header.Fast, trailer.Fast }) do
+    for _, name in ipairs(names) do
+        assert(byName[name] and byName[name].codec == "int" and byName[name].rate == "Fast", name .. " must be a fast int offset")
+    end
+end
+
+local checkGroups = {}
+
+-- Lay out one panel; returns its pixels, check pixels included, in column order
+local function layoutPanel(rate, firstColumn)
+    local pixels = {}
+    local fixed = {}
+    for _, name in ipairs(header[rate]) do
+        fixed[name] = true
+        table.insert(pixels, { hot = math.huge, order = #pixels, offsets = { byName[name] } })
+    end
+    for _, name in ipairs(trailer[rate]) do
+        fixed[name] = true
+    end
+
+    local ints, bools = {}, {}
+    for _, entry in ipairs(schema) do
+        if entry.rate == rate and not fixed[entry.name] then
+            table.insert(entry.codec == "bool" and bools or ints, entry)
+        end
+    end
+    local function hotter(a, b)
+        if a.hot ~= b.hot then
+            return a.hot > b.hot
+        end
+        return a.index < b.index
+    end
+    table.sort(bools, hotter)
+
+    for _, entry in ipairs(ints) do
+        table.insert(pixels, { hot = entry.hot, order = entry.index, offsets = { entry } })
+    end
+    for first = 1, #bools, BITS_PER_PIXEL do
+        local packed = { hot = bools[first].hot, order = bools[first].index, offsets = {}, bits = true }
+        for i = first, math.min(first + BITS_PER_PIXEL - 1, #bools) do
+            table.insert(packed.offsets, bools[i])
+        end
+        table.insert(pixels, packed)
+    end
+    table.sort(pixels, function(a, b)
+        if a.hot ~= b.hot then
+            return a.hot > b.hot
+        end
+        return a.order < b.order
+    end)
+    for _, name in ipairs(trailer[rate]) do
+        table.insert(pixels, { offsets = { byName[name] } })
+    end
+
+    local laidOut = {}
+    local column = firstColumn
+    local group = nil
+    local function closeGroup()
+        table.insert(laidOut, { check = true, column = column, rate = rate })
+        table.insert(checkGroups, { panel = rate == "Fast" and 0 or 1, firstColumn = group, checkColumn = column })
+        column = column + 1
+        group = nil
+    end
+    for _, pixel in ipairs(pixels) do
+        group = group or column
+        pixel.column = column
+        pixel.rate = rate
+        for bit, entry in ipairs(pixel.offsets) do
+            entry.column = pixel.column
+            entry.bit = pixel.bits and bit - 1 or -1
+        end
+        table.insert(laidOut, pixel)
+        column = column + 1
+        if column - group == CHECK_GROUP_SIZE then
+            closeGroup()
+        end
+    end
+    if group then
+        closeGroup()
+    end
+    return laidOut
+end
+
+local panels = { Fast = layoutPanel("Fast", 0), Slow = layoutPanel("Slow", 1) }
+
+-- FNV-1a over every placement, reduced to the 24 bits a pixel can carry
+local hash = 0x811C9DC5
+for _, entry in ipairs(schema) do
+    local placement = string.format("%s,%d,%s,%s,%d,%d;", entry.name, entry.index, entry.codec, entry.rate, entry.column, entry.bit)
+    for i = 1, #placement do
+        hash = ((hash ~ placement:byte(i)) * 0x01000193) & 0xFFFFFFFF
+    end
+end
+for _, group in ipairs(checkGroups) do
+    local placement = string.format("check,%d,%d,%d;", group.panel, group.firstColumn, group.checkColumn)
+    for i = 1, #placement do
+        hash = ((hash ~ placement:byte(i)) * 0x01000193) & 0xFFFFFFFF
+    end
+end
+local layoutHash = (hash ~ (hash >> 24)) & 0xFFFFFF
+
+-- Offsets.h
+local cppTypes = { int = "int", bool = "bool", string = "StringId" }
+local lines = { "// Generated by GenerateOffsets.lua from Offsets.schema.lua. Do not edit." }
+for _, entry in ipairs(schema) do
+    table.insert(lines, string.format("DEFINE_MEMORY_OFFSET(%s, %s, %d, %s, %d, %d);",
+        entry.name, cppTypes[entry.codec], entry.index, entry.rate, entry.column, entry.bit))
+end
+writeFile(projectDir .. "/Offsets.h", table.concat(lines, "\n") .. "\n")
+
+-- OffsetLayout.h
+local groupLines = {}
+for _, group in ipairs(checkGroups) do
+    table.insert(groupLines, string.format("    { %d, %d, %d },", group.panel, group.firstColumn, group.checkColumn))
+end
+writeFile(projectDir .. "/OffsetLayout.h", string.format([[
+/**
+ * @file OffsetLayout.h
+ * @brief Hash and check groups of the offset layout in Offsets.h.
+ *
+ * The hash is painted by the addon as the LayoutHash offset. Each check group is a run of pixels
+ * followed by a check pixel holding the XOR of their colors and OFFSET_CHECK_SEED.
+ *
+ * Generated by GenerateOffsets.lua from Offsets.schema.lua. Do not edit.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef OFFSETLAYOUT_H
+#define OFFSETLAYOUT_H
+
+#include <cstdint>
+
+constexpr uint32_t OFFSET_LAYOUT_HASH = 0x%06X;
+constexpr uint32_t OFFSET_CHECK_SEED = 0x%06X;
+
+struct OffsetCheckGroup {
+    int panel;          // Panel of the group, indexed like OffsetRate
+    int firstColumn;    // First pixel of the group
+    int checkColumn;    // Check pixel, right after the group's last pixel
+};
+
+constexpr OffsetCheckGroup OFFSET_CHECK_GROUPS[] = {
+%s
+};
+constexpr int OFFSET_CHECK_GROUP_COUNT = static_cast<int>(sizeof(OFFSET_CHECK_GROUPS) / sizeof(OFFSET_CHECK_GROUPS[0]));
+
+#endif // OFFSETLAYOUT_H
+]], layoutHash, CHECK_SEED, table.concat(groupLines, "\n")))
+
+-- Encoder section of aura.lua
+local encoder = {
+    BEGIN_MARKER .. " (GenerateOffsets.lua from Offsets.schema.lua, do not edit)",
+    string.format("local LAYOUT_HASH = 0x%06X", layoutHash),
+    string.format("local CHECK_SEED = 0x%06X", CHECK_SEED),
+    "",
+    "-- One entry per pixel: an int offset with `fetch`, up to 24 bools with one `fields` function per bit,",
+    "-- or the check pixel of the pixels since the previous one",
+    "local function initializeOffsets()",
+    "    return {",
+}
+for _, rate in ipairs({ "Fast", "Slow" }) do
+    for _, pixel in ipairs(panels[rate]) do
+        if pixel.check then
+            table.insert(encoder, string.format('        { key = "%s_Check_%d", rate = "%s", column = %d, type = "check" },',
+                rate, pixel.column, rate, pixel.column))
+        elseif pixel.bits then
+            table.insert(encoder, string.format('        { key = "%s_Bits_%d", rate = "%s", column = %d, type = "bits", fields = {',
+                rate, pixel.column, rate, pixel.column))
+            for _, entry in ipairs(pixel.offsets) do
+                table.insert(encoder, string.format("            function() return %s end, -- %s", entry.fetch, entry.name))
+            end
+            table.insert(encoder, "        } },")
+        else
+            local entry = pixel.offsets[1]
+            local fetch = entry.codec == "string" and string.format("internString(%s)", entry.fetch) or entry.fetch
+            table.insert(encoder, string.format('        { key = "%s", rate = "%s", column = %d, type = "number", fetch = function() return %s end },',
+                entry.name, rate, pixel.column, fetch))
+        end
+    end
+end
+table.insert(encoder, "    }")
+table.insert(encoder, "end")
+table.insert(encoder, END_MARKER)
+
+local auraPath = projectDir .. "/Interface/aura.lua"
+local aura = readFile(auraPath)
+local first = aura:find(BEGIN_MARKER, 1, true)
+local _, last = aura:find(END_MARKER, 1, true)
+assert(first and last, auraPath .. " has no GENERATED OFFSETS section")
+writeFile(auraPath, aura:sub(1, first - 1) .. table.concat(encoder, "\n") .. aura:sub(last + 1))
+
+print(string.format("%d offsets, %d fast and %d slow pixels, layout hash 0x%06X",
+    #schema, #panels.Fast, #panels.Slow, layoutHash))
@@ -1,19 +1,20 @@
--- Function to create offset mapping
-local function createOffset(key, fetchFunction, type, hex)
-    return { key = key, fetch = fetchFunction, type = type or "number", hex = hex or 0xA0A0A0 }
-end
+-- Interface/aura.lua
+-- Paints the game state as colored pixels for Memory to capture. The offsets themselves, their
+-- fetch expressions and their layout come from Offsets.schema.lua: run GenerateOffsets.lua to
+-- refresh the generated section below, together with Offsets.h.
 
--- Helper function to create C++ DEFINE_MEMORY_OFFSET macros
-local function createCppOffset(offset, index)
-    local typeMapping = {
-        number = "int",
-        bool = "bool",
-        string = "std::string",
-        float = "float"
-    }
-    local cppType = typeMapping[offset.type] or "int"
-    return string.format("DEFINE_MEMORY_OFFSET(%s, %s, %d);", offset.key, cppType, index)
-end
+-- Ticker periods in seconds. Memory decodes the slow panel every SLOW_FRAME_INTERVAL (8) captures
+-- of 250 ms, so the slow ticker must repaint within 2 s
+local FAST_PERIOD = 0.05
+local SLOW_PERIOD = 1.0
+
+-- Fast ticks painted so far, published as the TickCounter offset so Memory can tell a freshly
+-- painted frame from a repeat. Wraps at 24 bits, the capacity of one pixel.
+local tickCounter = 0
+-- GetTime() of the frame being painted in milliseconds, published as the GameTime offset so Memory
+-- can measure how old a frame is when captured, relative to the fastest recent frame (the two
+-- clocks do not share an origin). Also wraps at 24 bits.
+local gameTime = 0
 
 -- Helper function to log debug information to chat
 local function debugLog(message)
@@ -28,200 +29,391 @@ local function setHexColor(texture, hex)
     texture:SetColorTexture(r, g, b)
 end
 
--- Function to create offset mapping
-local function createOffset(key, fetchFunction, type, hex)
-    return { key = key, fetch = fetchFunction, type = type or "number", hex = hex or 0xA0A0A0 }
-end
-
--- Function to encode values into hex color based on type
-local function encodeToHex(value, type)
-    -- RGB encoding logic (number range)
-    if type == "number" then
-        return value -- Assume value is already a valid number for RGB encoding
-        -- Boolean to RGB encoding (1 = green, 0 = red)
-    elseif type == "bool" then
-        return value == 1 and 0x00FF00 or 0xFF0000
+-- Function to encode a pixel's value into a hex color
+local function encodeToHex(offset)
+    if offset.type == "bits" then
+        -- One bool per bit, bit 0 first
+        local hex = 0
+        for bitIndex, field in ipairs(offset.fields) do
+            local value = field()
+            if value == 1 or value == true then
+                hex = bit.bor(hex, bit.lshift(1, bitIndex - 1))
+            end
+        end
+        return hex
+    elseif offset.type == "number" then
+        return bit.band(offset.fetch() or 0, 0xFFFFFF)
     else
         return 0x000000 -- Default to black if type is unrecognized
     end
 end
 
--- Define reusable helper function for unit aura checks
-local function createAuraOffset(unit, auraType, auraName)
-    return createOffset("Unit" .. auraType .. "__" .. unit .. "_" .. auraName:gsub(" ", ""), function()
-            for i = 1, 40 do
-                local name = (auraType == "Buff") and UnitBuff(unit, i) or UnitDebuff(unit, i)
-                if name == auraName then
-                    return 1
-                end
-            end
-            return 0
-    end, "bool")
-end
+-- Aura names present on each unit, { Buff = { [name] = true }, Debuff = { ... } }. A unit is
+-- scanned once after each UNIT_AURA event (or target/party change) instead of once per aura offset
+-- per tick; until an event arrives its offsets are answered from the cached sets.
+local auraCache = {}
+local auraEvents = nil
 
+local function scanAuras(unit)
+    local auras = { Buff = {}, Debuff = {} }
+    for i = 1, 40 do
+        local name = UnitBuff(unit, i)
+        if not name then
+            break
+        end
+        auras.Buff[name] = true
+    end
+    for i = 1, 40 do
+        local name = UnitDebuff(unit, i)
+        if not name then
+            break
+        end
+        auras.Debuff[name] = true
+    end
+    return auras
+end
 
--- Initialize offsets with dynamic fetch functions
+local function unitAuras(unit, auraType)
+    local auras = auraCache[unit]
+    if not auras then
+        auras = scanAuras(unit)
+        -- Without the event frame nothing would invalidate the cache, so only keep it while watching
+        if auraEvents then
+            auraCache[unit] = auras
+        end
+    end
+    return auras[auraType]
+end
 
--- Helper function to log debug information to chat
-local function debugLog(message)
-    print("|cFFFFD904[Debug]:|r " .. tostring(message))
+-- Invalidates cached units on aura changes and whenever a unit token starts naming someone else
+local function watchAuras()
+    if auraEvents then
+        return
+    end
+    auraEvents = CreateFrame("Frame")
+    auraEvents:RegisterEvent("UNIT_AURA")
+    auraEvents:RegisterEvent("PLAYER_TARGET_CHANGED")
+    auraEvents:RegisterEvent("GROUP_ROSTER_UPDATE")
+    auraEvents:RegisterEvent("PLAYER_ENTERING_WORLD")
+    auraEvents:SetScript("OnEvent", function(_, event, unit)
+        if event == "UNIT_AURA" then
+            auraCache[unit] = nil
+        elseif event == "PLAYER_TARGET_CHANGED" then
+            auraCache.target = nil
+        else
+            wipe(auraCache)
+        end
+    end)
 end
 
--- Helper function to set a color as a hex value
-local function setHexColor(texture, hex)
-    local r = bit.rshift(hex, 16) / 255
-    local g = bit.band(bit.rshift(hex, 8), 0xFF) / 255
-    local b = bit.band(hex, 0xFF) / 255
-    texture:SetColorTexture(r, g, b)
+-- String dictionary. Text offsets are painted as small ids, handed out in first-seen order from 1
+-- (0 stands for nil or ""). The text of each id is streamed once through the mailbox pixels, in
+-- chunks of MAILBOX_CHUNK_BYTES held for MAILBOX_HOLD seconds each so a 250 ms capture sees every
+-- one. With nothing new to send, the mailbox cycles through the whole dictionary, which repairs
+-- missed chunks and teaches a restarted reader. DictionaryGeneration changes on every reload, as
+-- ids are only stable within one load.
+local MAILBOX_DATA_PIXELS = 6
+local MAILBOX_CHUNK_BYTES = MAILBOX_DATA_PIXELS * 3
+local MAILBOX_HOLD = 0.3
+local MAX_STRING_ID = 0xFFFF
+local MAX_STRING_CHUNKS = 0x100
+
+local stringIds = {}
+local strings = {}
+local mailbox = {
+    generation = math.random(1, 0xFFFFFF),
+    header = 0,                 -- id << 8 | chunk, 0 while empty
+    data = {},                  -- MAILBOX_DATA_PIXELS words of three bytes
+    fresh = {},                 -- { id, chunk } of strings not yet sent once
+    cycleId = 0,                -- Position of the repeat cycle
+    cycleChunk = 0,
+    sentAt = nil
+}
+for i = 1, MAILBOX_DATA_PIXELS do
+    mailbox.data[i] = 0
 end
 
--- Function to create offset mapping
-local function createOffset(key, fetchFunction, type, hex)
-    return { key = key, fetch = fetchFunction, type = type or "number", hex = hex or 0xA0A0A0 }
+-- Chunks of a string, the last one holding at least its terminating zero byte
+local function stringChunks(text)
+    return math.floor(#text / MAILBOX_CHUNK_BYTES) + 1
 end
 
--- Function to encode values into hex color based on type
-local function encodeToHex(value, type, maxValue)
-    -- RGB encoding logic (number range)
-    if type == "number" then
-        return value -- Assume value is already a valid number for RGB encoding
-        -- Boolean to RGB encoding (1 = green, 0 = red)
-    elseif type == "bool" then
-        return value == 1 and 0x00FF00 or 0xFF0000
-    else
-        return 0x000000 -- Default to black if type is unrecognized
+local function internString(text)
+    if text == nil or text == "" then
+        return 0
     end
+    local id = stringIds[text]
+    if not id then
+        if #strings >= MAX_STRING_ID or stringChunks(text) > MAX_STRING_CHUNKS then
+            return 0
+        end
+        table.insert(strings, text)
+        id = #strings
+        stringIds[text] = id
+        for chunk = 0, stringChunks(text) - 1 do
+            table.insert(mailbox.fresh, { id, chunk })
+        end
+    end
+    return id
 end
 
--- Define reusable helper function for unit aura checks
-local function createAuraOffset(unit, auraType, auraName)
-    return createOffset("Unit" .. auraType .. "__" .. unit .. "_" .. auraName:gsub(" ", ""), function()
-            for i = 1, 40 do
-                local name = (auraType == "Buff") and UnitBuff(unit, i) or UnitDebuff(unit, i)
-                if name == auraName then
-                    return 1
-                end
-            end
-            return 0
-    end, "bool")
+local function nextMailboxChunk()
+    if #mailbox.fresh > 0 then
+        local entry = table.remove(mailbox.fresh, 1)
+        return entry[1], entry[2]
+    end
+    if #strings == 0 then
+        return 0, 0
+    end
+    mailbox.cycleChunk = mailbox.cycleChunk + 1
+    if mailbox.cycleId == 0 or mailbox.cycleChunk >= stringChunks(strings[mailbox.cycleId]) then
+        mailbox.cycleId = mailbox.cycleId % #strings + 1
+        mailbox.cycleChunk = 0
+    end
+    return mailbox.cycleId, mailbox.cycleChunk
 end
 
+-- Moves the mailbox to the next chunk once the current one has been shown long enough
+local function updateMailbox()
+    local now = GetTime()
+    if mailbox.sentAt and now - mailbox.sentAt < MAILBOX_HOLD then
+        return
+    end
+    local id, chunk = nextMailboxChunk()
+    mailbox.header = id > 0 and bit.bor(bit.lshift(id, 8), chunk) or 0
+    local text = id > 0 and strings[id] or ""
+    local first = chunk * MAILBOX_CHUNK_BYTES
+    for i = 1, MAILBOX_DATA_PIXELS do
+        local word = 0
+        for b = 1, 3 do
+            word = word * 256 + (text:byte(first + (i - 1) * 3 + b) or 0)
+        end
+        mailbox.data[i] = word
+    end
+    mailbox.sentAt = now
+end
 
--- List of unit types and auras to check
-local units = { "player", "target", "party1", "party2", "party3", "party4" }
-local buffs = { "Power Word: Shield", "Power Word: Fortitude", "Renew" }
-local debuffs = { "Shadow Word: Pain", "Weakened Soul" }
-local spells = {
-    "Power Word: Shield",
-    "Mind Blast",
-    "Renew",
-    "Heal",
-    "Smite",
-    "Shadow Word: Pain",
-    "Power Word: Fortitude",
-    "Lesser Heal",
-    "Shoot",
-    "Attack"
-}
+-- BEGIN GENERATED OFFSETS (GenerateOffsets.lua from Offsets.schema.lua, do not edit)
+local LAYOUT_HASH = 0x2FCD76
+local CHECK_SEED = 0x5AA55A
 
--- Initialize offsets with dynamic fetch functions
+-- One entry per pixel: an int offset with `fetch`, up to 24 bools with one `fields` function per bit,
+-- or the check pixel of the pixels since the previous one
 local function initializeOffsets()
-    local offsets = {
-        createOffset("Calibration", function() return 0xFFD904 end, "number"),
-        createOffset("UnitPosition__player_1", function() return select(1, UnitPosition("player")) end, "number"),
-        createOffset("UnitPosition__player_2", function() return select(2, UnitPosition("player")) end, "number"),
-        createOffset("UnitPosition__player_3", function() return select(3, UnitPosition("player")) end, "number"),
-        createOffset("UnitCastingInfo__player", function() return UnitCastingInfo("player") and 1 or 0 end, "bool"),
-        createOffset("UnitChannelInfo__player", function() return UnitChannelInfo("player") and 1 or 0 end, "bool"),
-        createOffset("UnitCastingInfo__target", function() return UnitCastingInfo("target") and 1 or 0 end, "bool"),
-        createOffset("UnitChannelInfo__target", function() return UnitChannelInfo("target") and 1 or 0 end, "bool"),
-        createOffset("UnitCastingInfo__focus", function() return UnitCastingInfo("focus") and 1 or 0 end, "bool"),
-        createOffset("UnitChannelInfo__focus", function() return UnitChannelInfo("focus") and 1 or 0 end, "bool"),
-        createOffset("UnitPower__player", function() return UnitPower("player") end, "number"),
-        createOffset("UnitPowerMax__player", function() return UnitPowerMax("player") end, "number"),
-        createOffset("UnitPower__player_0", function() return UnitPower("player", 0) end, "number"),
-        createOffset("UnitPower__player_1", function() return UnitPower("player", 1) end, "number"),
-        createOffset("IsPlayerMoving", function() return IsPlayerMoving() and 1 or 0 end, "bool"),
-        createOffset("IsResting", function() return IsResting() and 1 or 0 end, "bool"),
-        createOffset("GetNumQuestLogEntries", function() return GetNumQuestLogEntries() end, "number"),
-        createOffset("GetQuestLogCompletionText__3", function() return select(3, GetQuestLogCompletionText()) and 1 or 0 end, "bool"),
-        createOffset("UnitXP__player", function() return UnitXP("player") end, "number"),
-        createOffset("UnitXPMax__player", function() return UnitXPMax("player") end, "number"),
-        createOffset("GetXPExhaustion", function() return GetXPExhaustion() or 0 end, "number"),
-        -- createOffset("GetZoneText", function() return GetZoneText() end, "int"),
-        -- createOffset("GetSubZoneText", function() return GetSubZoneText() end, "int"),
-        createOffset("IsSwimming", function() return IsSwimming() and 1 or 0 end, "bool"),
-        createOffset("IsFalling", function() return IsFalling() and 1 or 0 end, "bool"),
-        createOffset("GetMoney", function() return GetMoney() end, "number"),
-        createOffset("GetNumLootItems", function() return GetNumLootItems() end, "number"),
-        createOffset("LootFrame_IsShown", function() return LootFrame:IsShown() and 1 or 0 end, "bool"),
-        createOffset("IsControlKeyDown", function() return IsControlKeyDown() and 1 or 0 end, "bool"),
-        createOffset("UnitIsPlayer__target", function() return UnitIsPlayer("target") and 1 or 0 end, "bool")
+    return {
+        { key = "Calibration", rate = "Fast", column = 0, type = "number", fetch = function() return 0xFFD904 end },
+        { key = "LayoutHash", rate = "Fast", column = 1, type = "number", fetch = function() return LAYOUT_HASH end },
+        { key = "TickCounter", rate = "Fast", column = 2, type = "number", fetch = function() return tickCounter end },
+        { key = "Fast_Bits_3", rate = "Fast", column = 3, type = "bits", fields = {
+            function() return UnitCastingInfo("player") and 1 or 0 end, -- UnitCastingInfo__player
+            function() return UnitChannelInfo("player") and 1 or 0 end, -- UnitChannelInfo__player
+            function() return UnitCastingInfo("target") and 1 or 0 end, -- UnitCastingInfo__target
+            function() return UnitChannelInfo("target") and 1 or 0 end, -- UnitChannelInfo__target
+            function() return IsPlayerMoving() and 1 or 0 end, -- IsPlayerMoving
+            function() return UnitCastingInfo("focus") and 1 or 0 end, -- UnitCastingInfo__focus
+            function() return UnitChannelInfo("focus") and 1 or 0 end, -- UnitChannelInfo__focus
+            function() return UnitExists("player") and 1 or 0 end, -- UnitExists__player
+            function() return UnitAffectingCombat("player") and 1 or 0 end, -- UnitAffectingCombat__player
+            function() return unitAuras("player", "Buff")["Power Word: Shield"] and 1 or 0 end, -- UnitBuff__player_PowerWordShield
+            function() return unitAuras("player", "Buff")["Renew"] and 1 or 0 end, -- UnitBuff__player_Renew
+            function() return unitAuras("player", "Debuff")["Shadow Word: Pain"] and 1 or 0 end, -- UnitDebuff__player_ShadowWordPain
+            function() return unitAuras("player", "Debuff")["Weakened Soul"] and 1 or 0 end, -- UnitDebuff__player_WeakenedSoul
+            function() return UnitExists("target") and 1 or 0 end, -- UnitExists__target
+            function() return UnitAffectingCombat("target") and 1 or 0 end, -- UnitAffectingCombat__target
+            function() return unitAuras("target", "Buff")["Power Word: Shield"] and 1 or 0 end, -- UnitBuff__target_PowerWordShield
+            function() return unitAuras("target", "Buff")["Renew"] and 1 or 0 end, -- UnitBuff__target_Renew
+            function() return unitAuras("target", "Debuff")["Shadow Word: Pain"] and 1 or 0 end, -- UnitDebuff__target_ShadowWordPain
+            function() return unitAuras("target", "Debuff")["Weakened Soul"] and 1 or 0 end, -- UnitDebuff__target_WeakenedSoul
+            function() return UnitExists("party1") and 1 or 0 end, -- UnitExists__party1
+            function() return UnitAffectingCombat("party1") and 1 or 0 end, -- UnitAffectingCombat__party1
+            function() return unitAuras("party1", "Buff")["Power Word: Shield"] and 1 or 0 end, -- UnitBuff__party1_PowerWordShield
+            function() return unitAuras("party1", "Buff")["Renew"] and 1 or 0 end, -- UnitBuff__party1_Renew
+            function() return unitAuras("party1", "Debuff")["Shadow Word: Pain"] and 1 or 0 end, -- UnitDebuff__party1_ShadowWordPain
+        } },
+        { key = "UnitPower__player", rate = "Fast", column = 4, type = "number", fetch = function() return UnitPower("player") end },
+        { key = "UnitHealth__player", rate = "Fast", column = 5, type = "number", fetch = function() return UnitHealth("player") end },
+        { key = "UnitHealth__target", rate = "Fast", column = 6, type = "number", fetch = function() return UnitHealth("target") end },
+        { key = "UnitHealth__party1", rate = "Fast", column = 7, type = "number", fetch = function() return UnitHealth("party1") end },
+        { key = "UnitHealth__party2", rate = "Fast", column = 8, type = "number", fetch = function() return UnitHealth("party2") end },
+        { key = "UnitHealth__party3", rate = "Fast", column = 9, type = "number", fetch = function() return UnitHealth("party3") end },
+        { key = "UnitHealth__party4", rate = "Fast", column = 10, type = "number", fetch = function() return UnitHealth("party4") end },
+        { key = "GetSpellCooldown__PowerWordShield", rate = "Fast", column = 11, type = "number", fetch = function() return GetSpellCooldown("Power Word: Shield") end },
+        { key = "GetSpellCooldown__MindBlast", rate = "Fast", column = 12, type = "number", fetch = function() return GetSpellCooldown("Mind Blast") end },
+        { key = "GetSpellCooldown__Renew", rate = "Fast", column = 13, type = "number", fetch = function() return GetSpellCooldown("Renew") end },
+        { key = "GetSpellCooldown__Heal", rate = "Fast", column = 14, type = "number", fetch = function() return GetSpellCooldown("Heal") end },
+        { key = "GetSpellCooldown__Smite", rate = "Fast", column = 15, type = "number", fetch = function() return GetSpellCooldown("Smite") end },
+        { key = "Fast_Check_16", rate = "Fast", column = 16, type = "check" },
+        { key = "GetSpellCooldown__ShadowWordPain", rate = "Fast", column = 17, type = "number", fetch = function() return GetSpellCooldown("Shadow Word: Pain") end },
+        { key = "GetSpellCooldown__PowerWordFortitude", rate = "Fast", column = 18, type = "number", fetch = function() return GetSpellCooldown("Power Word: Fortitude") end },
+        { key = "GetSpellCooldown__LesserHeal", rate = "Fast", column = 19, type = "number", fetch = function() return GetSpellCooldown("Lesser Heal") end },
+        { key = "GetSpellCooldown__Shoot", rate = "Fast", column = 20, type = "number", fetch = function() return GetSpellCooldown("Shoot") end },
+        { key = "GetSpellCooldown__Attack", rate = "Fast", column = 21, type = "number", fetch = function() return GetSpellCooldown("Attack") end },
+        { key = "GameTime", rate = "Fast", column = 22, type = "number", fetch = function() return gameTime end },
+        { key = "UnitPosition__player_1", rate = "Fast", column = 23, type = "number", fetch = function() return select(1, UnitPosition("player")) end },
+        { key = "UnitPosition__player_2", rate = "Fast", column = 24, type = "number", fetch = function() return select(2, UnitPosition("player")) end },
+        { key = "UnitPosition__player_3", rate = "Fast", column = 25, type = "number", fetch = function() return select(3, UnitPosition("player")) end },
+        { key = "UnitPower__player_0", rate = "Fast", column = 26, type = "number", fetch = function() return UnitPower("player", 0) end },
+        { key = "UnitPower__player_1", rate = "Fast", column = 27, type = "number", fetch = function() return UnitPower("player", 1) end },
+        { key = "Fast_Bits_28", rate = "Fast", column = 28, type = "bits", fields = {
+            function() return unitAuras("party1", "Debuff")["Weakened Soul"] and 1 or 0 end, -- UnitDebuff__party1_WeakenedSoul
+            function() return UnitExists("party2") and 1 or 0 end, -- UnitExists__party2
+            function() return UnitAffectingCombat("party2") and 1 or 0 end, -- UnitAffectingCombat__party2
+            function() return unitAuras("party2", "Buff")["Power Word: Shield"] and 1 or 0 end, -- UnitBuff__party2_PowerWordShield
+            function() return unitAuras("party2", "Buff")["Renew"] and 1 or 0 end, -- UnitBuff__party2_Renew
+            function() return unitAuras("party2", "Debuff")["Shadow Word: Pain"] and 1 or 0 end, -- UnitDebuff__party2_ShadowWordPain
+            function() return unitAuras("party2", "Debuff")["Weakened Soul"] and 1 or 0 end, -- UnitDebuff__party2_WeakenedSoul
+            function() return UnitExists("party3") and 1 or 0 end, -- UnitExists__party3
+            function() return UnitAffectingCombat("party3") and 1 or 0 end, -- UnitAffectingCombat__party3
+            function() return unitAuras("party3", "Buff")["Power Word: Shield"] and 1 or 0 end, -- UnitBuff__party3_PowerWordShield
+            function() return unitAuras("party3", "Buff")["Renew"] and 1 or 0 end, -- UnitBuff__party3_Renew
+            function() return unitAuras("party3", "Debuff")["Shadow Word: Pain"] and 1 or 0 end, -- UnitDebuff__party3_ShadowWordPain
+            function() return unitAuras("party3", "Debuff")["Weakened Soul"] and 1 or 0 end, -- UnitDebuff__party3_WeakenedSoul
+            function() return UnitExists("party4") and 1 or 0 end, -- UnitExists__party4
+            function() return UnitAffectingCombat("party4") and 1 or 0 end, -- UnitAffectingCombat__party4
+            function() return unitAuras("party4", "Buff")["Power Word: Shield"] and 1 or 0 end, -- UnitBuff__party4_PowerWordShield
+            function() return unitAuras("party4", "Buff")["Renew"] and 1 or 0 end, -- UnitBuff__party4_Renew
+            function() return unitAuras("party4", "Debuff")["Shadow Word: Pain"] and 1 or 0 end, -- UnitDebuff__party4_ShadowWordPain
+            function() return unitAuras("party4", "Debuff")["Weakened Soul"] and 1 or 0 end, -- UnitDebuff__party4_WeakenedSoul
+            function() return IsSpellInRange("Power Word: Shield") == 1 and 1 or 0 end, -- IsSpellInRange__PowerWordShield
+            function() return IsSpellInRange("Mind Blast") == 1 and 1 or 0 end, -- IsSpellInRange__MindBlast
+            function() return IsSpellInRange("Renew") == 1 and 1 or 0 end, -- IsSpellInRange__Renew
+            function() return IsSpellInRange("Heal") == 1 and 1 or 0 end, -- IsSpellInRange__Heal
+            function() return IsSpellInRange("Smite") == 1 and 1 or 0 end, -- IsSpellInRange__Smite
+        } },
+        { key = "Fast_Bits_29", rate = "Fast", column = 29, type = "bits", fields = {
+            function() return IsSpellInRange("Shadow Word: Pain") == 1 and 1 or 0 end, -- IsSpellInRange__ShadowWordPain
+            function() return IsSpellInRange("Power Word: Fortitude") == 1 and 1 or 0 end, -- IsSpellInRange__PowerWordFortitude
+            function() return IsSpellInRange("Lesser Heal") == 1 and 1 or 0 end, -- IsSpellInRange__LesserHeal
+            function() return IsSpellInRange("Shoot") == 1 and 1 or 0 end, -- IsSpellInRange__Shoot
+            function() return IsSpellInRange("Attack") == 1 and 1 or 0 end, -- IsSpellInRange__Attack
+            function() return IsSwimming() and 1 or 0 end, -- IsSwimming
+            function() return IsFalling() and 1 or 0 end, -- IsFalling
+            function() return LootFrame:IsShown() and 1 or 0 end, -- LootFrame_IsShown
+            function() return IsControlKeyDown() and 1 or 0 end, -- IsControlKeyDown
+            function() return UnitIsPlayer("target") and 1 or 0 end, -- UnitIsPlayer__target
+            function() return unitAuras("player", "Buff")["Drink"] and 1 or 0 end, -- UnitBuff__player_Drink
+            function() return unitAuras("player", "Buff")["Food"] and 1 or 0 end, -- UnitBuff__player_Food
+        } },
+        { key = "GetNumLootItems", rate = "Fast", column = 30, type = "number", fetch = function() return GetNumLootItems() end },
+        { key = "UnitThreatSituation__player_player", rate = "Fast", column = 31, type = "number", fetch = function() return UnitThreatSituation("player", "player") or 0 end },
+        { key = "UnitThreatSituation__player_target", rate = "Fast", column = 32, type = "number", fetch = function() return UnitThreatSituation("player", "target") or 0 end },
+        { key = "Fast_Check_33", rate = "Fast", column = 33, type = "check" },
+        { key = "UnitThreatSituation__player_party1", rate = "Fast", column = 34, type = "number", fetch = function() return UnitThreatSituation("player", "party1") or 0 end },
+        { key = "UnitThreatSituation__player_party2", rate = "Fast", column = 35, type = "number", fetch = function() return UnitThreatSituation("player", "party2") or 0 end },
+        { key = "UnitThreatSituation__player_party3", rate = "Fast", column = 36, type = "number", fetch = function() return UnitThreatSituation("player", "party3") or 0 end },
+        { key = "UnitThreatSituation__player_party4", rate = "Fast", column = 37, type = "number", fetch = function() return UnitThreatSituation("player", "party4") or 0 end },
+        { key = "UnitThreatSituation__target_player", rate = "Fast", column = 38, type = "number", fetch = function() return UnitThreatSituation("target", "player") or 0 end },
+        { key = "UnitThreatSituation__target_target", rate = "Fast", column = 39, type = "number", fetch = function() return UnitThreatSituation("target", "target") or 0 end },
+        { key = "UnitThreatSituation__target_party1", rate = "Fast", column = 40, type = "number", fetch = function() return UnitThreatSituation("target", "party1") or 0 end },
+        { key = "UnitThreatSituation__target_party2", rate = "Fast", column = 41, type = "number", fetch = function() return UnitThreatSituation("target", "party2") or 0 end },
+        { key = "UnitThreatSituation__target_party3", rate = "Fast", column = 42, type = "number", fetch = function() return UnitThreatSituation("target", "party3") or 0 end },
+        { key = "UnitThreatSituation__target_party4", rate = "Fast", column = 43, type = "number", fetch = function() return UnitThreatSituation("target", "party4") or 0 end },
+        { key = "UnitThreatSituation__party1_player", rate = "Fast", column = 44, type = "number", fetch = function() return UnitThreatSituation("party1", "player") or 0 end },
+        { key = "UnitThreatSituation__party1_target", rate = "Fast", column = 45, type = "number", fetch = function() return UnitThreatSituation("party1", "target") or 0 end },
+        { key = "UnitThreatSituation__party1_party1", rate = "Fast", column = 46, type = "number", fetch = function() return UnitThreatSituation("party1", "party1") or 0 end },
+        { key = "UnitThreatSituation__party1_party2", rate = "Fast", column = 47, type = "number", fetch = function() return UnitThreatSituation("party1", "party2") or 0 end },
+        { key = "UnitThreatSituation__party1_party3", rate = "Fast", column = 48, type = "number", fetch = function() return UnitThreatSituation("party1", "party3") or 0 end },
+        { key = "UnitThreatSituation__party1_party4", rate = "Fast", column = 49, type = "number", fetch = function() return UnitThreatSituation("party1", "party4") or 0 end },
+        { key = "Fast_Check_50", rate = "Fast", column = 50, type = "check" },
+        { key = "UnitThreatSituation__party2_player", rate = "Fast", column = 51, type = "number", fetch = function() return UnitThreatSituation("party2", "player") or 0 end },
+        { key = "UnitThreatSituation__party2_target", rate = "Fast", column = 52, type = "number", fetch = function() return UnitThreatSituation("party2", "target") or 0 end },
+        { key = "UnitThreatSituation__party2_party1", rate = "Fast", column = 53, type = "number", fetch = function() return UnitThreatSituation("party2", "party1") or 0 end },
+        { key = "UnitThreatSituation__party2_party2", rate = "Fast", column = 54, type = "number", fetch = function() return UnitThreatSituation("party2", "party2") or 0 end },
+        { key = "UnitThreatSituation__party2_party3", rate = "Fast", column = 55, type = "number", fetch = function() return UnitThreatSituation("party2", "party3") or 0 end },
+        { key = "UnitThreatSituation__party2_party4", rate = "Fast", column = 56, type = "number", fetch = function() return UnitThreatSituation("party2", "party4") or 0 end },
+        { key = "UnitThreatSituation__party3_player", rate = "Fast", column = 57, type = "number", fetch = function() return UnitThreatSituation("party3", "player") or 0 end },
+        { key = "UnitThreatSituation__party3_target", rate = "Fast", column = 58, type = "number", fetch = function() return UnitThreatSituation("party3", "target") or 0 end },
+        { key = "UnitThreatSituation__party3_party1", rate = "Fast", column = 59, type = "number", fetch = function() return UnitThreatSituation("party3", "party1") or 0 end },
+        { key = "UnitThreatSituation__party3_party2", rate = "Fast", column = 60, type = "number", fetch = function() return UnitThreatSituation("party3", "party2") or 0 end },
+        { key = "UnitThreatSituation__party3_party3", rate = "Fast", column = 61, type = "number", fetch = function() return UnitThreatSituation("party3", "party3") or 0 end },
+        { key = "UnitThreatSituation__party3_party4", rate = "Fast", column = 62, type = "number", fetch = function() return UnitThreatSituation("party3", "party4") or 0 end },
+        { key = "UnitThreatSituation__party4_player", rate = "Fast", column = 63, type = "number", fetch = function() return UnitThreatSituation("party4", "player") or 0 end },
+        { key = "UnitThreatSituation__party4_target", rate = "Fast", column = 64, type = "number", fetch = function() return UnitThreatSituation("party4", "target") or 0 end },
+        { key = "UnitThreatSituation__party4_party1", rate = "Fast", column = 65, type = "number", fetch = function() return UnitThreatSituation("party4", "party1") or 0 end },
+        { key = "UnitThreatSituation__party4_party2", rate = "Fast", column = 66, type = "number", fetch = function() return UnitThreatSituation("party4", "party2") or 0 end },
+        { key = "Fast_Check_67", rate = "Fast", column = 67, type = "check" },
+        { key = "UnitThreatSituation__party4_party3", rate = "Fast", column = 68, type = "number", fetch = function() return UnitThreatSituation("party4", "party3") or 0 end },
+        { key = "UnitThreatSituation__party4_party4", rate = "Fast", column = 69, type = "number", fetch = function() return UnitThreatSituation("party4", "party4") or 0 end },
+        { key = "UnitName__target", rate = "Fast", column = 70, type = "number", fetch = function() return internString(UnitName("target")) end },
+        { key = "DictionaryGeneration", rate = "Fast", column = 71, type = "number", fetch = function() return mailbox.generation end },
+        { key = "MailboxHeader", rate = "Fast", column = 72, type = "number", fetch = function() return mailbox.header end },
+        { key = "MailboxData_1", rate = "Fast", column = 73, type = "number", fetch = function() return mailbox.data[1] end },
+        { key = "MailboxData_2", rate = "Fast", column = 74, type = "number", fetch = function() return mailbox.data[2] end },
+        { key = "MailboxData_3", rate = "Fast", column = 75, type = "number", fetch = function() return mailbox.data[3] end },
+        { key = "MailboxData_4", rate = "Fast", column = 76, type = "number", fetch = function() return mailbox.data[4] end },
+        { key = "MailboxData_5", rate = "Fast", column = 77, type = "number", fetch = function() return mailbox.data[5] end },
+        { key = "MailboxData_6", rate = "Fast", column = 78, type = "number", fetch = function() return mailbox.data[6] end },
+        { key = "TickCounterTail", rate = "Fast", column = 79, type = "number", fetch = function() return tickCounter end },
+        { key = "Fast_Check_80", rate = "Fast", column = 80, type = "check" },
+        { key = "UnitHealthMax__player", rate = "Slow", column = 1, type = "number", fetch = function() return UnitHealthMax("player") end },
+        { key = "Slow_Bits_2", rate = "Slow", column = 2, type = "bits", fields = {
+            function() return unitAuras("player", "Buff")["Power Word: Fortitude"] and 1 or 0 end, -- UnitBuff__player_PowerWordFortitude
+            function() return unitAuras("target", "Buff")["Power Word: Fortitude"] and 1 or 0 end, -- UnitBuff__target_PowerWordFortitude
+            function() return unitAuras("party1", "Buff")["Power Word: Fortitude"] and 1 or 0 end, -- UnitBuff__party1_PowerWordFortitude
+            function() return unitAuras("party2", "Buff")["Power Word: Fortitude"] and 1 or 0 end, -- UnitBuff__party2_PowerWordFortitude
+            function() return unitAuras("party3", "Buff")["Power Word: Fortitude"] and 1 or 0 end, -- UnitBuff__party3_PowerWordFortitude
+            function() return unitAuras("party4", "Buff")["Power Word: Fortitude"] and 1 or 0 end, -- UnitBuff__party4_PowerWordFortitude
+            function() return IsResting() and 1 or 0 end, -- IsResting
+            function() return select(7, GetSpellInfo("Power Word: Shield")) and IsSpellKnown(select(7, GetSpellInfo("Power Word: Shield"))) and 1 or 0 end, -- IsSpellKnown__PowerWordShield
+            function() return select(7, GetSpellInfo("Mind Blast")) and IsSpellKnown(select(7, GetSpellInfo("Mind Blast"))) and 1 or 0 end, -- IsSpellKnown__MindBlast
+            function() return select(7, GetSpellInfo("Renew")) and IsSpellKnown(select(7, GetSpellInfo("Renew"))) and 1 or 0 end, -- IsSpellKnown__Renew
+            function() return select(7, GetSpellInfo("Heal")) and IsSpellKnown(select(7, GetSpellInfo("Heal"))) and 1 or 0 end, -- IsSpellKnown__Heal
+            function() return select(7, GetSpellInfo("Smite")) and IsSpellKnown(select(7, GetSpellInfo("Smite"))) and 1 or 0 end, -- IsSpellKnown__Smite
+            function() return select(7, GetSpellInfo("Shadow Word: Pain")) and IsSpellKnown(select(7, GetSpellInfo("Shadow Word: Pain"))) and 1 or 0 end, -- IsSpellKnown__ShadowWordPain
+            function() return select(7, GetSpellInfo("Power Word: Fortitude")) and IsSpellKnown(select(7, GetSpellInfo("Power Word: Fortitude"))) and 1 or 0 end, -- IsSpellKnown__PowerWordFortitude
+            function() return select(7, GetSpellInfo("Lesser Heal")) and IsSpellKnown(select(7, GetSpellInfo("Lesser Heal"))) and 1 or 0 end, -- IsSpellKnown__LesserHeal
+            function() return select(7, GetSpellInfo("Shoot")) and IsSpellKnown(select(7, GetSpellInfo("Shoot"))) and 1 or 0 end, -- IsSpellKnown__Shoot
+            function() return select(7, GetSpellInfo("Attack")) and IsSpellKnown(select(7, GetSpellInfo("Attack"))) and 1 or 0 end, -- IsSpellKnown__Attack
+            function() return select(3, GetQuestLogCompletionText()) and 1 or 0 end, -- GetQuestLogCompletionText__3
+            function() return HasWandEquipped() and 1 or 0 end, -- HasWandEquipped
+        } },
+        { key = "UnitHealthMax__target", rate = "Slow", column = 3, type = "number", fetch = function() return UnitHealthMax("target") end },
+        { key = "UnitHealthMax__party1", rate = "Slow", column = 4, type = "number", fetch = function() return UnitHealthMax("party1") end },
+        { key = "UnitHealthMax__party2", rate = "Slow", column = 5, type = "number", fetch = function() return UnitHealthMax("party2") end },
+        { key = "UnitHealthMax__party3", rate = "Slow", column = 6, type = "number", fetch = function() return UnitHealthMax("party3") end },
+        { key = "UnitHealthMax__party4", rate = "Slow", column = 7, type = "number", fetch = function() return UnitHealthMax("party4") end },
+        { key = "UnitPowerMax__player", rate = "Slow", column = 8, type = "number", fetch = function() return UnitPowerMax("player") end },
+        { key = "GetZoneText", rate = "Slow", column = 9, type = "number", fetch = function() return internString(GetZoneText()) end },
+        { key = "GetSubZoneText", rate = "Slow", column = 10, type = "number", fetch = function() return internString(GetSubZoneText()) end },
+        { key = "GetNumQuestLogEntries", rate = "Slow", column = 11, type = "number", fetch = function() return GetNumQuestLogEntries() end },
+        { key = "UnitXP__player", rate = "Slow", column = 12, type = "number", fetch = function() return UnitXP("player") end },
+        { key = "UnitXPMax__player", rate = "Slow", column = 13, type = "number", fetch = function() return UnitXPMax("player") end },
+        { key = "GetXPExhaustion", rate = "Slow", column = 14, type = "number", fetch = function() return GetXPExhaustion() or 0 end },
+        { key = "GetMoney", rate = "Slow", column = 15, type = "number", fetch = function() return GetMoney() end },
+        { key = "UnitName__player", rate = "Slow", column = 16, type = "number", fetch = function() return internString(UnitName("player")) end },
+        { key = "Slow_Check_17", rate = "Slow", column = 17, type = "check" },
     }
-    
-    -- Initialize offsets
-    for _, unit in ipairs(units) do
-        table.insert(offsets, createOffset("UnitHealth__" .. unit, function() return UnitHealth(unit) end, "number"))
-        table.insert(offsets, createOffset("UnitHealthMax__" .. unit, function() return UnitHealthMax(unit) end, "number"))
-        table.insert(offsets, createOffset("UnitExists__" .. unit, function() return UnitExists(unit) end, "bool"))
-        table.insert(offsets, createOffset("UnitAffectingCombat__" .. unit, function() return UnitAffectingCombat(unit) end, "bool"))
-        for _, unit2 in ipairs(units) do
-            table.insert(offsets, createOffset("UnitThreatSituation__" .. unit .. "_" ..  unit2, function() return UnitThreatSituation(unit, unit2) end, "number"))
-        end
-        
-        
-        for _, buff in ipairs(buffs) do
-            table.insert(offsets, createAuraOffset(unit, "Buff", buff))
-        end
-        
-        for _, debuff in ipairs(debuffs) do
-            table.insert(offsets, createAuraOffset(unit, "Debuff", debuff))
-        end
-    end
-    
-    -- Add offsets for spell cooldowns
-    for _, spell in ipairs(spells) do
-        table.insert(offsets, createOffset("GetSpellCooldown__" .. spell:gsub(" ", ""), function()
-                    return GetSpellCooldown(spell)
-        end, "number"))
-        
-        table.insert(offsets,createOffset("IsSpellKnown__"..spell:gsub(" ", ""), function()
-                    local spellID = select(7, GetSpellInfo(spell)) 
-                    if spellID and IsSpellKnown(spellID)
-                    then return 1 else return 0 end
-        end, "bool"))
-        
-        table.insert(offsets, createOffset("IsSpellInRange__" .. spell:gsub(" ", ""), function()
-                    return IsSpellInRange(spell) and 1 or 0 
-        end, "bool"))
-    end
-    
-    -- Player-specific buffs
-    local playerOnlyBuffs = { "Drink", "Food" }
-    for _, buff in ipairs(playerOnlyBuffs) do
-        table.insert(offsets, createAuraOffset("player", "Buff", buff))
-    end
-    
-    -- Add specific offsets for unique checks
-    table.insert(offsets, createOffset("HasWandEquipped", function()
-                local wandEquipped = HasWandEquipped()
-                return wandEquipped and 1 or 0
-    end, "bool"))
-    return offsets
 end
+-- END GENERATED OFFSETS
 
-
--- Update offsets dynamically based on their fetch functions
+-- Only textures whose color changed since the last paint are touched. Check pixels follow their
+-- group in `offsets`, so each one takes the XOR of the colors computed since the previous one.
 local function updateOffsets(panel, offsets)
+    local check = CHECK_SEED
     for _, offset in ipairs(offsets) do
-        local value = offset.fetch and offset.fetch() or 0
-        local hex = encodeToHex(value, offset.type)
-        if panel.offsets[offset.key] then
-            setHexColor(panel.offsets[offset.key].texture, hex)
+        local hex
+        if offset.type == "check" then
+            hex = check
+            check = CHECK_SEED
+        else
+            hex = encodeToHex(offset)
+            check = bit.bxor(check, hex)
+        end
+        local pixel = panel.offsets[offset.key]
+        if pixel and hex ~= pixel.hex then
+            setHexColor(pixel.texture, hex)
+            pixel.hex = hex
         end
     end
 end
 
+local function updateFastOffsets(panel, offsets)
+    tickCounter = (tickCounter + 1) % 0x1000000
+    gameTime = math.floor(GetTime() * 1000) % 0x1000000
+    updateMailbox()
+    updateOffsets(panel, offsets)
+end
+
 -- Fetch screen size and scaling
 local function fetchScreenData()
     local screenWidth, screenHeight = GetPhysicalScreenSize()
@@ -229,31 +421,59 @@ local function fetchScreenData()
     debugLog("Screen Size: " .. screenWidth .. "x" .. screenHeight .. " Scale: " .. uiScale)
 end
 
-local function updateLoop()
-    updateOffsets(panel, offsets)
-end
+-- Create one pixel row per rate class at the columns assigned by the generator. The slow row,
+-- one row below the fast one, starts with a calibration marker of its own.
+local function initializePanel(offsets, size, spacing)
+    local panel = CreateFrame("Frame", "MommyGliderPanel", UIParent)
+    panel:SetFrameStrata("TOOLTIP")
+    panel:SetPoint("TOPLEFT", UIParent, "TOPLEFT", 0, 0)
+    panel:SetSize(size, size)
+    panel.offsets = {}
 
--- Generate Memory.h C++ code
-local function generateCppFromOffsets()
-    local offsets = initializeOffsets()
+    local function addPixel(key, column, row)
+        local texture = panel:CreateTexture(nil, "OVERLAY")
+        texture:SetSize(size, size)
+        texture:SetPoint("TOPLEFT", panel, "TOPLEFT", column * spacing, -row * spacing)
+        setHexColor(texture, 0x000000)
+        panel.offsets[key] = { texture = texture }
+        return texture
+    end
 
-    for index, offset in ipairs(offsets) do
-        print(createCppOffset(offset, index - 1))
+    setHexColor(addPixel("SlowCalibration", 0, 1), 0xFFD904)
+    for _, offset in ipairs(offsets) do
+        addPixel(offset.key, offset.column, offset.rate == "Slow" and 1 or 0)
     end
+    return panel
+end
 
+-- Pixels of one rate class
+local function offsetsWithRate(offsets, rate)
+    local selected = {}
+    for _, offset in ipairs(offsets) do
+        if offset.rate == rate then
+            table.insert(selected, offset)
+        end
+    end
+    return selected
 end
 
 local function executeForWow()
     -- Initialize and start
     fetchScreenData()
+    watchAuras()
     local offsets = initializeOffsets()
     local size = 2  -- Pixel size
     local spacing = 3 -- Spacing between squares
     local panel = initializePanel(offsets, size, spacing)
+    local fastOffsets = offsetsWithRate(offsets, "Fast")
+    local slowOffsets = offsetsWithRate(offsets, "Slow")
+    updateOffsets(panel, slowOffsets)
     if not aura_env.updateTimer then
-        aura_env.updateTimer = C_Timer.NewTicker(0.05, updateLoop)
+        aura_env.updateTimer = C_Timer.NewTicker(FAST_PERIOD, function() updateFastOffsets(panel, fastOffsets) end)
+    end
+    if not aura_env.slowUpdateTimer then
+        aura_env.slowUpdateTimer = C_Timer.NewTicker(SLOW_PERIOD, function() updateOffsets(panel, slowOffsets) end)
     end
 end
--- Execute the generation
-generateCppFromOffsets()
 
+executeForWow()
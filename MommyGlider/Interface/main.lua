@@ -7,38 +7,19 @@ local CoreRotations = {}
 global_lastMoveTime = 0
 global_lastDrinkTime = 0
 
-local function GetTime()
-    return os.time()
-end
+-- Keep the timers when the engine hot-reloads this script
+Persist("global_lastMoveTime", "global_lastDrinkTime")
 
 -- Function to perform initial calibration
 local function IsCalibration()
     return Calibration() == 0xFFD904
 end
 
--- Helper function to check if a unit's health is below a threshold
-local function isHealthBelow(unit, threshold)
-    local health = UnitHealth(unit)
-    local maxHealth = UnitHealthMax(unit)
-    if maxHealth == 0 then return false end
-    return (health / maxHealth * 100) < threshold
-end
-
 -- Helper function to check if a unit exists
 local function UnitExists(unit)
     return UnitHealth(unit) > 0
 end
 
--- Helper function to iterate over units
-local function iterateUnits(unitTypes, conditionCallback)
-    for _, unit in ipairs(unitTypes) do
-        if conditionCallback(unit) then
-            return true, unit
-        end
-    end
-    return false, nil
-end
-
 -- Helper function for target selection in combat
 local function selectTargetInCombat()
     print("Searching for a valid target...")
@@ -79,50 +60,12 @@ end
 
 
 function CoreRotations:addSpellRotation(spell, options)
+    -- The declarative checks are compiled once and evaluated natively against the latest frame;
+    -- options.condition is still called back from the same point of the check order
+    local program = CompileRotation(spell, options)
     self:addRotation({
-        condition = function() 
-        
-          --  print(spell)
-
-           -- if GetSpellCooldown(spell) > 0 then return false end
-           -- print(spell)
-
-            if not options.notKnownSpell and 0 == IsSpellKnown(spell) then return false end
-
-            -- Player-specific checks
-            local manaPercent = UnitPower("player") / UnitPowerMax("player") * 100
-            if options.isMoving and not IsPlayerMoving() then return false end
-            if options.minPower and manaPercent < options.minPower then return false end
-            if options.maxPower and manaPercent > options.maxPower then return false end
-            if options.castingCheck and UnitCastingInfo("player") then return false end
-            if options.condition and not options.condition() then return false end
-            -- print(spell)
-
-            if true == options.notInCombat and UnitAffectingCombat("player") then return false end
-
-            local unitsToIterate = {"player", "party1", "party2", "party3", "party4"}
-            local unitToTarget = options.unit or "player"
-
-            if unitToTarget == "player" then unitsToIterate = {"player"} end
-            if unitToTarget == "target" then unitsToIterate = {"target"} end
-
-            -- Handle party unit iteration
-           -- print(UnitExists("player"))
-            local ready, target = iterateUnits(unitsToIterate, function(unit)
-                return UnitExists(unit)
-                    and (not options.healthThreshold or isHealthBelow(unit, options.healthThreshold))
-                    and (not options.maxHealthThreshold or UnitHealth(unit) / UnitHealthMax(unit) * 100 >= options.maxHealthThreshold)
-                    and (not options.buff or not UnitBuff(unit, options.buff))
-                    and (not options.debuff or not UnitDebuff(unit, options.debuff))
-            end)
-
-           -- print(target)
-
-            if not ready then return false end
-            if not UnitExists(target) then return false end
-            
-           -- print(target)
-            return true, target
+        condition = function()
+            return EvaluateRotation(program, options.condition)
         end,
         action = function(target)
             if options.action then return options.action() end
@@ -156,10 +99,11 @@ function CoreRotations:initialize()
         healthThreshold = 35,
     })
 
-    -- Heal party members if health is low
+    -- Heal party members if health is low, most injured first
     self:addSpellRotation("Heal", {
         unit = "party",
         healthThreshold = 80,
+        lowestHealth = true,
         minPower = 5,
         cancelSpell = true, -- Cancel current spell if needed
     })
@@ -167,6 +111,7 @@ function CoreRotations:initialize()
     self:addSpellRotation("Lesser Heal", {
         unit = "party",
         healthThreshold = 80,
+        lowestHealth = true,
         minPower = 5,
         cancelSpell = true, -- Cancel current spell if needed
     })
@@ -274,9 +219,6 @@ end
 
 -- Execute the rotation queue
 function CoreRotations:execute()
-    -- Register movement tracking
-    if IsPlayerMoving() then onMove() end
-    
     for _, rotation in ipairs(self.rotationQueue) do
         if rotation.condition then
             local result = { rotation.condition() }
@@ -288,25 +230,29 @@ function CoreRotations:execute()
     end
 end
 
--- Main game loop
-local function gameLoop()
-    print("Starting grinding bot...")
-
-    local controlKeyPressed = false
+-- Ctrl-held edge detection, kept between ticks
+local controlKeyPressed = false
 
-    -- Enter the rotation execution loop
-    while true do
-        if IsControlKeyDown() and IsCalibration() then
-            if not controlKeyPressed then
-                CoreRotations:execute()
-                controlKeyPressed = true
-            end
-        else
-            controlKeyPressed = false
+-- Main game loop body, called by the engine once per captured frame
+function OnTick()
+    if IsControlKeyDown() and IsCalibration() then
+        if not controlKeyPressed then
+            CoreRotations:execute()
+            controlKeyPressed = true
         end
+    else
+        controlKeyPressed = false
     end
 end
 
--- Initialize CoreRotations and start the game loop
+-- Track movement on every frame, not only while the rotation is executing
+Spawn(function()
+    while true do
+        if IsPlayerMoving() then onMove() end
+        WaitFrames(1)
+    end
+end)
+
+-- Initialize CoreRotations; the engine drives OnTick from here on
+print("Starting grinding bot...")
 CoreRotations:initialize()
-gameLoop()
@@ -0,0 +1,279 @@
+/**
+ * @file LuaAllocator.cpp
+ * @brief Implementation of the size-class allocator used by the embedded Lua state.
+ *
+ * Each state's arena owns one free list per size class. An empty list is refilled by carving a
+ * new chunk from malloc. Chunks live as long as the state, which bounds its heap by the peak
+ * working set of its scripts, and are freed together when the state is closed.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+extern "C" {
+#include "lua.h"
+}
+#include "AllocationTracker.h"
+#include "LuaAllocator.h"
+#include "MetricsServer.h"
+
+namespace {
+
+    // Size classes are multiples of 16 so every block keeps malloc's alignment
+    constexpr size_t CLASS_SIZES[] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512 };
+    constexpr int CLASS_COUNT = sizeof(CLASS_SIZES) / sizeof(CLASS_SIZES[0]);
+    constexpr size_t CHUNK_SIZE = 32 * 1024;
+
+    static_assert(CLASS_SIZES[CLASS_COUNT - 1] == LuaAllocator::MAX_SMALL_BLOCK, "Largest size class must match MAX_SMALL_BLOCK");
+
+    // Maps ceil(size / 16) to the smallest class that fits
+    constexpr std::array<uint8_t, LuaAllocator::MAX_SMALL_BLOCK / 16 + 1> buildClassTable() {
+        std::array<uint8_t, LuaAllocator::MAX_SMALL_BLOCK / 16 + 1> table{};
+        int sizeClass = 0;
+        for (size_t units = 0; units < table.size(); ++units) {
+            while (CLASS_SIZES[sizeClass] < units * 16) {
+                ++sizeClass;
+            }
+            table[units] = static_cast<uint8_t>(sizeClass);
+        }
+        return table;
+    }
+
+    constexpr auto CLASS_TABLE = buildClassTable();
+
+    inline int sizeClassFor(size_t size) {
+        return CLASS_TABLE[(size + 15) / 16];
+    }
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Header at the start of every chunk; 16 bytes so the blocks after it keep malloc's alignment
+    struct alignas(16) ChunkHeader {
+        ChunkHeader* next;
+    };
+
+    /**
+     * @brief Carves a new chunk into a list of free blocks of one class.
+     * @return Null if malloc failed.
+     */
+    FreeBlock* carveChunk(int sizeClass, ChunkHeader*& chunks) {
+        char* chunk = static_cast<char*>(std::malloc(CHUNK_SIZE));
+        if (!chunk) {
+            return nullptr;
+        }
+        ChunkHeader* header = reinterpret_cast<ChunkHeader*>(chunk);
+        header->next = chunks;
+        chunks = header;
+
+        char* blocks = chunk + sizeof(ChunkHeader);
+        size_t blockSize = CLASS_SIZES[sizeClass];
+        size_t count = (CHUNK_SIZE - sizeof(ChunkHeader)) / blockSize;
+        for (size_t i = 0; i < count; ++i) {
+            reinterpret_cast<FreeBlock*>(blocks + i * blockSize)->next =
+                (i + 1 < count) ? reinterpret_cast<FreeBlock*>(blocks + (i + 1) * blockSize) : nullptr;
+        }
+        return reinterpret_cast<FreeBlock*>(blocks);
+    }
+
+} // namespace
+
+struct LuaAllocator::Arena {
+    LuaAllocator* owner;
+    FreeBlock* heads[CLASS_COUNT] = {};
+    ChunkHeader* chunks = nullptr;
+
+    explicit Arena(LuaAllocator* allocator) : owner(allocator) {}
+
+    ~Arena() {
+        while (chunks) {
+            ChunkHeader* next = chunks->next;
+            std::free(chunks);
+            chunks = next;
+        }
+    }
+
+    /**
+     * @param fromSystem Set to true when a new chunk had to be taken from malloc.
+     */
+    void* allocateSmall(int sizeClass, bool& fromSystem) {
+        FreeBlock*& head = heads[sizeClass];
+        if (!head) {
+            head = carveChunk(sizeClass, chunks);
+            if (!head) {
+                return nullptr;
+            }
+            fromSystem = true;
+        }
+        FreeBlock* block = head;
+        head = block->next;
+        return block;
+    }
+
+    /**
+     * @brief Keeps a malloc block shrinking to `size` on the system heap as a chunk of one block,
+     *        for when its class has no block left. Lua later frees it into the class's list; as a
+     *        chunk it is still freed with the arena.
+     * @return The moved block, or null if realloc failed and `ptr` is unchanged.
+     */
+    void* adoptLarge(void* ptr, size_t size) {
+        char* chunk = static_cast<char*>(std::realloc(ptr, sizeof(ChunkHeader) + CLASS_SIZES[sizeClassFor(size)]));
+        if (!chunk) {
+            return nullptr;
+        }
+        std::memmove(chunk + sizeof(ChunkHeader), chunk, size);
+        ChunkHeader* header = reinterpret_cast<ChunkHeader*>(chunk);
+        header->next = chunks;
+        chunks = header;
+        return chunk + sizeof(ChunkHeader);
+    }
+
+    void freeSmall(void* ptr, int sizeClass) {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = heads[sizeClass];
+        heads[sizeClass] = block;
+    }
+};
+
+lua_State* LuaAllocator::newState() {
+    Arena* arena = new Arena(this);
+    lua_State* L = lua_newstate(allocate, arena);
+    if (!L) {
+        delete arena;
+    }
+    return L;
+}
+
+void LuaAllocator::closeState(lua_State* L) {
+    void* ud = nullptr;
+    lua_getallocf(L, &ud);
+    // lua_close has returned every block to the arena's free lists before the chunks go
+    lua_close(L);
+    delete static_cast<Arena*>(ud);
+}
+
+void* LuaAllocator::allocate(void* ud, void* ptr, size_t osize, size_t nsize) {
+    Arena* arena = static_cast<Arena*>(ud);
+    return arena->owner->reallocate(*arena, ptr, ptr ? osize : 0, nsize);
+}
+
+void* LuaAllocator::reallocate(Arena& arena, void* ptr, size_t osize, size_t nsize) {
+    bool oldSmall = osize <= MAX_SMALL_BLOCK;
+    bool newSmall = nsize <= MAX_SMALL_BLOCK;
+
+    // Free
+    if (nsize == 0) {
+        if (ptr) {
+            if (oldSmall) {
+                arena.freeSmall(ptr, sizeClassFor(osize));
+            }
+            else {
+                std::free(ptr);
+            }
+        }
+        track(osize, 0);
+        return nullptr;
+    }
+
+    // Resize within the same class
+    if (ptr && oldSmall && newSmall && sizeClassFor(osize) == sizeClassFor(nsize)) {
+        track(osize, nsize);
+        return ptr;
+    }
+
+    // Large to large stays on the system heap
+    if (!newSmall && (!ptr || !oldSmall)) {
+        void* block = std::realloc(ptr, nsize);
+        systemAllocations.fetch_add(1, std::memory_order_relaxed);
+        AllocationTracker::countSystemAllocation();
+        if (!block) {
+            return nullptr;
+        }
+        if (!ptr) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        track(osize, nsize);
+        return block;
+    }
+
+    // Moving into a size class, or from a size class to the system heap
+    bool fromSystem = false;
+    void* block = newSmall ? arena.allocateSmall(sizeClassFor(nsize), fromSystem) : std::malloc(nsize);
+    if (!newSmall || fromSystem) {
+        systemAllocations.fetch_add(1, std::memory_order_relaxed);
+        AllocationTracker::countSystemAllocation();
+    }
+    if (!block) {
+        // A malloc block must not be handed back as a class block: its free would never reach free()
+        if (ptr && !oldSmall) {
+            block = arena.adoptLarge(ptr, nsize);
+            systemAllocations.fetch_add(1, std::memory_order_relaxed);
+            AllocationTracker::countSystemAllocation();
+            if (block) {
+                track(osize, nsize);
+            }
+            return block;
+        }
+        // Rather than fail a shrink, keep the block; a class block is valid in any smaller class
+        if (ptr && nsize <= osize) {
+            track(osize, nsize);
+            return ptr;
+        }
+        return nullptr;
+    }
+
+    if (ptr) {
+        std::memcpy(block, ptr, osize < nsize ? osize : nsize);
+        if (oldSmall) {
+            arena.freeSmall(ptr, sizeClassFor(osize));
+        }
+        else {
+            std::free(ptr);
+        }
+    }
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    track(osize, nsize);
+    return block;
+}
+
+void LuaAllocator::track(size_t oldSize, size_t newSize) {
+    if (newSize >= oldSize) {
+        uint64_t live = liveBytes.fetch_add(newSize - oldSize, std::memory_order_relaxed) + (newSize - oldSize);
+        if (live > peak.load(std::memory_order_relaxed)) {
+            peak.store(live, std::memory_order_relaxed);
+        }
+    }
+    else {
+        liveBytes.fetch_sub(oldSize - newSize, std::memory_order_relaxed);
+    }
+}
+
+void LuaAllocator::beginTick() {
+    uint64_t currentAllocations = allocations.load(std::memory_order_relaxed);
+    uint64_t currentSystemAllocations = systemAllocations.load(std::memory_order_relaxed);
+
+    lastTickAllocations.store(currentAllocations - tickStartAllocations, std::memory_order_relaxed);
+    lastTickSystemAllocations.store(currentSystemAllocations - tickStartSystemAllocations, std::memory_order_relaxed);
+
+    tickStartAllocations = currentAllocations;
+    tickStartSystemAllocations = currentSystemAllocations;
+}
+
+void LuaAllocator::collectMetrics(MetricsWriter& metrics) const {
+    metrics.gauge("mommyglider_lua_heap_bytes", "Bytes currently allocated by the Lua state.",
+        static_cast<double>(bytesLive()));
+    metrics.gauge("mommyglider_lua_heap_peak_bytes", "Highest number of bytes ever allocated by the Lua state.",
+        static_cast<double>(peakBytes()));
+    metrics.counter("mommyglider_lua_allocations_total", "Blocks handed to the Lua state.",
+        static_cast<double>(allocations.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_lua_system_allocations_total", "Lua allocations that reached malloc/realloc, including chunk refills.",
+        static_cast<double>(systemAllocations.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_lua_tick_allocations", "Blocks allocated by Lua during the previous tick.",
+        static_cast<double>(allocationsLastTick()));
+    metrics.gauge("mommyglider_lua_tick_system_allocations", "Lua allocations that reached malloc during the previous tick.",
+        static_cast<double>(systemAllocationsLastTick()));
+}
@@ -8,117 +8,536 @@
  * @author [Your Name]
  */
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <new>
 #include <string>
-#include "Memory.h"
-#include "Controller.h"
-extern "C" {
-#include "lua.h"
-#include "lauxlib.h"
-#include "lualib.h"
-}
+#include <string_view>
+#include <vector>
+#include "AllocationTracker.h"
+#include "FlightRecorder.h"
+#include "LuaEngine.h"
+#include "MetricsServer.h"
+#include "PartyQueries.h"
+#include "RotationEngine.h"
+#include "Util.h"
 
-// LuaEngine class definition
-class LuaEngine {
-private:
-    lua_State* luaState;         // Lua state
-    Memory& memory;              // Reference to Memory instance
-    Controller& controller;      // Reference to Controller instance
-
-    static LuaEngine* instance;  // Static instance pointer for Lua callbacks
-
-    // Lua bindings
-
-    static int lua_UnitHealth(lua_State* L);
-    static int lua_UnitHealthMax(lua_State* L);
-    static int lua_UnitPower(lua_State* L);
-    static int lua_UnitPowerMax(lua_State* L);
-    static int lua_IsPlayerMoving(lua_State* L);
-    static int lua_UnitAffectingCombat(lua_State* L);
-    static int lua_GetMoney(lua_State* L);
-    static int lua_UnitBuff(lua_State* L);
-    static int lua_UnitDebuff(lua_State* L);
-    static int lua_CastSpell(lua_State* L);
-    static int lua_TargetNearestEnemy(lua_State* L);
-    static int lua_IsControlKeyDown(lua_State* L);
-    static int lua_Calibration(lua_State* L);
-    static int lua_UnitPosition(lua_State* L);
-    static int lua_UnitCastingInfo(lua_State* L);
-    static int lua_TargetUnit(lua_State* L);
-    static int lua_GetSpellCooldown(lua_State* L);
-    static int lua_GetNumLootItems(lua_State* L);
-    static int lua_HasWandEquipped(lua_State* L);
-    static int lua_UnitExists(lua_State* L);
-    static int lua_UnitThreatSituation(lua_State* L);
-    static int lua_UnitIsPlayer(lua_State* L);
-    static int lua_SpellStopCasting(lua_State* L);
-    static int lua_IsSpellKnown(lua_State* L);
-    static int lua_IsSpellInRange(lua_State* L);
-    static int lua_JumpOrAscendStart(lua_State* L);
-    static int lua_MoveForwardStart(lua_State* L);
+// Registry table holding the names passed to Persist()
+static const char* const PERSISTENT_REGISTRY_KEY = "MommyGlider.persistent";
+
+// Metatable of the userdata returned by CompileRotation()
+static const char* const ROTATION_METATABLE = "MommyGlider.RotationProgram";
+
+// Registry table caching the Lua string of each StringId; [0] holds its dictionary generation
+static const char* const STRING_CACHE_REGISTRY_KEY = "MommyGlider.strings";
+
+/**
+ * @brief Offset name built in a fixed buffer, so bindings look offsets up without allocating.
+ *
+ * A name that does not fit comes out empty, which no offset matches.
+ */
+class OffsetKey {
 public:
-    LuaEngine(Memory& mem, Controller& ctrl);
-    ~LuaEngine();
+    explicit OffsetKey(const char* prefix) { append(prefix); }
 
-    void executeScript(const std::string& filePath);
-    void callFunction(const std::string& functionName);
+    OffsetKey& append(const char* text) {
+        for (; *text; ++text) {
+            push(*text);
+        }
+        return *this;
+    }
+
+    // Keeps only letters and digits, as the schema does for spell and aura names
+    OffsetKey& appendSanitized(const char* text) {
+        for (; *text; ++text) {
+            if (isalnum(static_cast<unsigned char>(*text))) {
+                push(*text);
+            }
+        }
+        return *this;
+    }
+
+    std::string_view view() const { return overflowed ? std::string_view() : std::string_view(buffer, length); }
+
+private:
+    void push(char c) {
+        if (length == sizeof(buffer)) {
+            overflowed = true;
+            return;
+        }
+        buffer[length++] = c;
+    }
+
+    char buffer[96];
+    size_t length = 0;
+    bool overflowed = false;
 };
 
-// Static member initialization
-LuaEngine* LuaEngine::instance = nullptr;
-
-LuaEngine::LuaEngine(Memory& mem, Controller& ctrl) : memory(mem), controller(ctrl) {
-    luaState = luaL_newstate();
-    luaL_openlibs(luaState);
-    instance = this;
-
-    lua_register(luaState, "UnitHealth", lua_UnitHealth);
-    lua_register(luaState, "UnitHealthMax", lua_UnitHealthMax);
-    lua_register(luaState, "UnitPower", lua_UnitPower);
-    lua_register(luaState, "UnitPowerMax", lua_UnitPowerMax);
-    lua_register(luaState, "IsPlayerMoving", lua_IsPlayerMoving);
-    lua_register(luaState, "GetMoney", lua_GetMoney);
-    lua_register(luaState, "UnitBuff", lua_UnitBuff);
-    lua_register(luaState, "UnitDebuff", lua_UnitDebuff);
-    lua_register(luaState, "CastSpell", lua_CastSpell);
-    lua_register(luaState, "TargetNearestEnemy", lua_TargetNearestEnemy);
-    lua_register(luaState, "IsControlKeyDown", lua_IsControlKeyDown);
-    lua_register(luaState, "Calibration", lua_Calibration);
-    lua_register(luaState, "UnitPosition", lua_UnitPosition);
-    lua_register(luaState, "UnitCastingInfo", lua_UnitCastingInfo);
-    lua_register(luaState, "TargetUnit", lua_TargetUnit);
-    lua_register(luaState, "GetSpellCooldown", lua_GetSpellCooldown);
-    lua_register(luaState, "GetNumLootItems", lua_GetNumLootItems);
-    lua_register(luaState, "HasWandEquipped", lua_HasWandEquipped);
-    lua_register(luaState, "UnitExists", lua_UnitExists);
-    lua_register(luaState, "UnitAffectingCombat", lua_UnitAffectingCombat);
-    lua_register(luaState, "UnitThreatSituation", lua_UnitThreatSituation);
-    lua_register(luaState, "UnitIsPlayer", lua_UnitIsPlayer);
-    lua_register(luaState, "SpellStopCasting", lua_SpellStopCasting);
-    lua_register(luaState, "IsSpellKnown", lua_IsSpellKnown); // Breaks signature
-    lua_register(luaState, "IsSpellInRange", lua_IsSpellInRange);
-    lua_register(luaState, "JumpOrAscendStart", lua_JumpOrAscendStart);
-    lua_register(luaState, "MoveForwardStart", lua_MoveForwardStart);
+LuaEngine::LuaEngine(Memory& mem, Controller& ctrl, BytecodeCache& cache)
+    : bytecodeCache(cache), memory(mem), controller(ctrl), gcBudgetNs(1000000), heapAfterCycleKb(0), gcCycleInProgress(false),
+      lastFrame(0), scheduler(nullptr), tickBudget{ 5000000, 100000000 }, pendingState(nullptr), retiredState(nullptr),
+      flightRecorder(nullptr), flightClient(0) {
+    registerBinding("UnitHealth", lua_UnitHealth);
+    registerBinding("UnitHealthMax", lua_UnitHealthMax);
+    registerBinding("UnitPower", lua_UnitPower);
+    registerBinding("UnitPowerMax", lua_UnitPowerMax);
+    registerBinding("IsPlayerMoving", lua_IsPlayerMoving);
+    registerBinding("GetMoney", lua_GetMoney);
+    registerBinding("UnitBuff", lua_UnitBuff);
+    registerBinding("UnitDebuff", lua_UnitDebuff);
+    registerBinding("CastSpell", lua_CastSpell);
+    registerBinding("TargetNearestEnemy", lua_TargetNearestEnemy);
+    registerBinding("IsControlKeyDown", lua_IsControlKeyDown);
+    registerBinding("Calibration", lua_Calibration);
+    registerBinding("UnitPosition", lua_UnitPosition);
+    registerBinding("UnitCastingInfo", lua_UnitCastingInfo);
+    registerBinding("TargetUnit", lua_TargetUnit);
+    registerBinding("GetSpellCooldown", lua_GetSpellCooldown);
+    registerBinding("GetNumLootItems", lua_GetNumLootItems);
+    registerBinding("HasWandEquipped", lua_HasWandEquipped);
+    registerBinding("UnitExists", lua_UnitExists);
+    registerBinding("UnitAffectingCombat", lua_UnitAffectingCombat);
+    registerBinding("UnitThreatSituation", lua_UnitThreatSituation);
+    registerBinding("UnitIsPlayer", lua_UnitIsPlayer);
+    registerBinding("SpellStopCasting", lua_SpellStopCasting);
+    registerBinding("IsSpellKnown", lua_IsSpellKnown); // Breaks signature
+    registerBinding("IsSpellInRange", lua_IsSpellInRange);
+    registerBinding("JumpOrAscendStart", lua_JumpOrAscendStart);
+    registerBinding("MoveForwardStart", lua_MoveForwardStart);
+    registerBinding("Persist", lua_Persist);
+    registerBinding("CompileRotation", lua_CompileRotation);
+    registerBinding("EvaluateRotation", lua_EvaluateRotation);
+    registerBinding("PartyHealth", lua_PartyHealth);
+    registerBinding("LowestHealthUnit", lua_LowestHealthUnit);
+    registerBinding("UnitsBelowHealth", lua_UnitsBelowHealth);
+    registerBinding("UnitsMissingAura", lua_UnitsMissingAura);
+    registerBinding("GetTime", lua_GetTime);
+    registerBinding("Spawn", lua_Spawn);
+    registerBinding("WaitFrames", lua_WaitFrames);
+    registerBinding("Sleep", lua_Sleep);
+    registerBinding("WaitUntil", lua_WaitUntil);
+    registerBinding("Every", lua_Every);
+    registerBinding("Cancel", lua_Cancel);
+    registerBinding("GetZoneText", lua_GetZoneText);
+    registerBinding("GetSubZoneText", lua_GetSubZoneText);
+    registerBinding("UnitName", lua_UnitName);
+    registerBinding("DumpFrames", lua_DumpFrames);
+
+    luaState = createState();
+    scheduler = Scheduler::from(luaState);
     std::cout << "Lua engine initialized.\n";
 }
 
 // LuaEngine destructor
 LuaEngine::~LuaEngine() {
-    lua_close(luaState);
+    if (lua_State* pending = pendingState.exchange(nullptr)) {
+        LuaAllocator::closeState(pending);
+    }
+    if (lua_State* retired = retiredState.exchange(nullptr)) {
+        LuaAllocator::closeState(retired);
+    }
+    LuaAllocator::closeState(luaState);
+}
+
+void LuaEngine::registerBinding(const char* name, lua_CFunction function) {
+    bindings.emplace_back(name, function);
+}
+
+lua_State* LuaEngine::createState() {
+    lua_State* L = allocator.newState();
+    lua_atpanic(L, panicHandler);
+
+    // Bindings find their engine here; threads created later copy the main thread's extra space
+    *static_cast<LuaEngine**>(lua_getextraspace(L)) = this;
+    luaL_openlibs(L);
+
+    // Small incremental steps; the collector only runs between ticks from collectGarbage()
+    lua_gc(L, LUA_GCINC, 0, 0, 10);
+    lua_gc(L, LUA_GCSTOP);
+
+    // Every binding goes through the instrumented trampoline; stats are shared across states
+    for (auto& binding : bindings) {
+        lua_pushlightuserdata(L, &binding);
+        lua_pushcclosure(L, instrumentedBinding, 1);
+        lua_setglobal(L, binding.name);
+    }
+    Scheduler::install(L, schedulerStats);
+
+    // Coroutines inherit the hook from the state they are created in
+    lua_sethook(L, hookDispatcher, LUA_MASKCOUNT, TickBudget::HOOK_INTERVAL);
+    return L;
+}
+
+void LuaEngine::hookDispatcher(lua_State* L, lua_Debug* ar) {
+    if (ar->event == LUA_HOOKCOUNT) {
+        Profiler& profiler = from(L)->profiler;
+        if (profiler.samplePending()) {
+            profiler.sample(L, nullptr);
+        }
+        TickBudget::onCount(L, ar);
+    }
+}
+
+int LuaEngine::panicHandler(lua_State* L) {
+    const char* message = lua_type(L, -1) == LUA_TSTRING ? lua_tostring(L, -1) : "error object is not a string";
+    std::cerr << "PANIC: unprotected error in call to Lua API (" << message << ")\n";
+    return 0; // Return to Lua to abort
+}
+
+int LuaEngine::instrumentedBinding(lua_State* L) {
+    auto* binding = static_cast<BindingStats*>(lua_touserdata(L, lua_upvalueindex(1)));
+
+    int64_t start = monotonicNanos();
+    int results = binding->function(L);
+    uint64_t elapsed = static_cast<uint64_t>(monotonicNanos() - start);
+
+    // The count hook never fires inside native code, so bindings take their own samples
+    Profiler& profiler = from(L)->profiler;
+    if (profiler.samplePending()) {
+        profiler.sample(L, binding->name);
+    }
+
+    // Only the Lua thread writes these, so a plain load/store is enough for the maximum
+    binding->calls.fetch_add(1, std::memory_order_relaxed);
+    binding->totalNs.fetch_add(elapsed, std::memory_order_relaxed);
+    if (elapsed > binding->maxNs.load(std::memory_order_relaxed)) {
+        binding->maxNs.store(elapsed, std::memory_order_relaxed);
+    }
+    return results;
+}
+
+void LuaEngine::collectMetrics(MetricsWriter& metrics) const {
+    allocator.collectMetrics(metrics);
+    schedulerStats.collectMetrics(metrics);
+    budgetStats.collectMetrics(metrics);
+    profiler.collectMetrics(metrics);
+
+    metrics.counter("mommyglider_lua_ticks_total", "Completed script ticks.",
+        static_cast<double>(tickStats.ticks.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_lua_tick_seconds", "Duration of the last script tick, excluding GC.",
+        tickStats.lastTickNs.load(std::memory_order_relaxed) / 1e9);
+    metrics.gauge("mommyglider_lua_gc_pause_seconds", "GC time spent after the last tick.",
+        tickStats.lastGcNs.load(std::memory_order_relaxed) / 1e9);
+    metrics.gauge("mommyglider_lua_gc_pause_max_seconds", "Longest GC slice after a tick.",
+        tickStats.maxGcNs.load(std::memory_order_relaxed) / 1e9);
+    metrics.counter("mommyglider_lua_gc_pause_seconds_total", "Accumulated GC time between ticks.",
+        tickStats.totalGcNs.load(std::memory_order_relaxed) / 1e9);
+    metrics.counter("mommyglider_lua_gc_cycles_total", "Completed Lua GC cycles.",
+        static_cast<double>(tickStats.gcCycles.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_lua_gc_forced_cycles_total", "GC cycles finished past the idle budget because the heap doubled.",
+        static_cast<double>(tickStats.forcedGcCycles.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_lua_reloads_total", "Script reloads swapped in between ticks.",
+        static_cast<double>(tickStats.reloads.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_lua_reload_failures_total", "Script reloads discarded because a script failed to load.",
+        static_cast<double>(tickStats.reloadFailures.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_lua_reload_swap_seconds", "Time the tick loop was paused to swap in the last reload.",
+        tickStats.lastSwapNs.load(std::memory_order_relaxed) / 1e9);
+    for (const auto& binding : bindings) {
+        std::string labels = std::string("binding=\"") + binding.name + "\"";
+        metrics.counter("mommyglider_lua_binding_calls_total", "Calls made by scripts to a native binding.",
+            static_cast<double>(binding.calls.load(std::memory_order_relaxed)), labels);
+        metrics.counter("mommyglider_lua_binding_seconds_total", "Wall time spent inside a native binding.",
+            binding.totalNs.load(std::memory_order_relaxed) / 1e9, labels);
+        metrics.gauge("mommyglider_lua_binding_max_seconds", "Slowest single call to a native binding.",
+            binding.maxNs.load(std::memory_order_relaxed) / 1e9, labels);
+    }
 }
 
 int LuaEngine::lua_JumpOrAscendStart(lua_State* L) {
-    instance->controller.pressKey(VK_SPACE);
+    from(L)->controller.pressKey(VK_SPACE);
     return 1;
 }
 
 int LuaEngine::lua_MoveForwardStart(lua_State* L) {
-    instance->controller.pressKey(VK_NUMLOCK);
+    from(L)->controller.pressKey(VK_NUMLOCK);
+    return 1;
+}
+
+// Persist("name", ...) marks globals whose values survive a hot reload
+int LuaEngine::lua_Persist(lua_State* L) {
+    int count = lua_gettop(L);
+    luaL_getsubtable(L, LUA_REGISTRYINDEX, PERSISTENT_REGISTRY_KEY);
+    for (int i = 1; i <= count; ++i) {
+        lua_pushboolean(L, true);
+        lua_setfield(L, -2, luaL_checkstring(L, i));
+    }
+    return 0;
+}
+
+/**
+ * @brief CompileRotation(spell, options) -> program
+ *
+ * The program is a userdata owned by the calling state, so it is collected with the state on reload.
+ */
+int LuaEngine::lua_CompileRotation(lua_State* L) {
+    const char* spell = luaL_checkstring(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    void* memoryBlock = lua_newuserdatauv(L, sizeof(RotationProgram), 0);
+    RotationProgram* program = new (memoryBlock) RotationProgram();
+    if (luaL_newmetatable(L, ROTATION_METATABLE)) {
+        lua_pushcfunction(L, [](lua_State* L) -> int {
+            static_cast<RotationProgram*>(luaL_checkudata(L, 1, ROTATION_METATABLE))->~RotationProgram();
+            return 0;
+        });
+        lua_setfield(L, -2, "__gc");
+    }
+    lua_setmetatable(L, -2);
+
+    program->compile(L, 2, spell);
+    // Rotations read their offsets from whole snapshots, so their indices are recorded here
+    for (int index : program->offsetsRead()) {
+        from(L)->memory.noteOffsetRead(index);
+    }
+    return 1;
+}
+
+/**
+ * @brief Records the party health offsets as read; PartyView reads them from whole snapshots.
+ */
+static void notePartyHealthRead(const Memory& memory) {
+    static const std::vector<int> indices = PartyView::healthIndices();
+    for (int index : indices) {
+        memory.noteOffsetRead(index);
+    }
+}
+
+/**
+ * @brief EvaluateRotation(program [, condition]) -> ready, target
+ *
+ * Reads one consistent frame, so every check of the rotation sees the same capture.
+ */
+int LuaEngine::lua_EvaluateRotation(lua_State* L) {
+    const RotationProgram* program = static_cast<const RotationProgram*>(luaL_checkudata(L, 1, ROTATION_METATABLE));
+
+    Snapshot snapshot;
+    if (!from(L)->memory.snapshots().read(snapshot)) {
+        lua_pushboolean(L, false);
+        return 1;
+    }
+
+    const char* target = program->evaluate(snapshot, L, lua_gettop(L) >= 2 ? 2 : 0);
+    if (!target) {
+        lua_pushboolean(L, false);
+        return 1;
+    }
+    lua_pushboolean(L, true);
+    lua_pushstring(L, target);
+    return 2;
+}
+
+/**
+ * @brief PartyHealth() -> player, party1, ..., party4 health percentages (0 if absent)
+ */
+int LuaEngine::lua_PartyHealth(lua_State* L) {
+    notePartyHealthRead(from(L)->memory);
+    Snapshot snapshot;
+    if (!from(L)->memory.snapshots().read(snapshot)) {
+        return 0;
+    }
+
+    alignas(16) float percents[PartyView::LANE_COUNT];
+    PartyView(snapshot).healthPercents(percents);
+    for (int unit = 0; unit < PartyView::UNIT_COUNT; ++unit) {
+        lua_pushnumber(L, percents[unit]);
+    }
+    return PartyView::UNIT_COUNT;
+}
+
+/**
+ * @brief LowestHealthUnit() -> unit, percent, or nil when nobody is alive
+ */
+int LuaEngine::lua_LowestHealthUnit(lua_State* L) {
+    notePartyHealthRead(from(L)->memory);
+    Snapshot snapshot;
+    float percent = 0.0f;
+    int unit = from(L)->memory.snapshots().read(snapshot) ? PartyView(snapshot).lowestHealthUnit(percent) : -1;
+    if (unit < 0) {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushstring(L, PartyView::UNIT_NAMES[unit]);
+    lua_pushnumber(L, percent);
+    return 2;
+}
+
+/**
+ * @brief UnitsBelowHealth(percent) -> bitmask, bit 0 = player, bits 1-4 = party1-4
+ */
+int LuaEngine::lua_UnitsBelowHealth(lua_State* L) {
+    float threshold = static_cast<float>(luaL_checknumber(L, 1));
+    notePartyHealthRead(from(L)->memory);
+    Snapshot snapshot;
+    uint32_t mask = from(L)->memory.snapshots().read(snapshot) ? PartyView(snapshot).unitsBelowHealth(threshold) : 0;
+    lua_pushinteger(L, mask);
+    return 1;
+}
+
+/**
+ * @brief UnitsMissingAura(aura [, "HARMFUL"]) -> bitmask of living units without the buff (or debuff)
+ */
+int LuaEngine::lua_UnitsMissingAura(lua_State* L) {
+    size_t length = 0;
+    const char* aura = luaL_checklstring(L, 1, &length);
+    const char* filter = luaL_optstring(L, 2, "HELPFUL");
+    bool harmful = std::strcmp(filter, "HARMFUL") == 0;
+
+    const PartyView::AuraIndices& indices = PartyView::auraIndices(std::string_view(aura, length), harmful);
+    notePartyHealthRead(from(L)->memory);
+    for (int index : indices.index) {
+        from(L)->memory.noteOffsetRead(index);
+    }
+    Snapshot snapshot;
+    uint32_t mask = from(L)->memory.snapshots().read(snapshot) ? PartyView(snapshot).unitsMissingAura(indices) : 0;
+    lua_pushinteger(L, mask);
+    return 1;
+}
+
+/**
+ * @brief GetTime() -> seconds on a monotonic clock, with sub-millisecond resolution
+ */
+int LuaEngine::lua_GetTime(lua_State* L) {
+    lua_pushnumber(L, monotonicNanos() / 1e9);
+    return 1;
+}
+
+/**
+ * @brief Spawn(fn, ...) -> handle; runs fn as a task until its first wait
+ */
+int LuaEngine::lua_Spawn(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    uint64_t handle = 0;
+    Scheduler::from(L)->spawn(L, lua_gettop(L) - 1, &handle);
+    lua_pushinteger(L, static_cast<lua_Integer>(handle));
+    return 1;
+}
+
+/**
+ * @brief WaitFrames([n]) suspends the calling task for n captured frames (default 1)
+ */
+int LuaEngine::lua_WaitFrames(lua_State* L) {
+    lua_Integer frames = luaL_optinteger(L, 1, 1);
+    Scheduler::from(L)->waitFrames(L, frames > 0 ? static_cast<uint64_t>(frames) : 1);
+    return lua_yield(L, 0);
+}
+
+/**
+ * @brief Sleep(ms) suspends the calling task for at least ms milliseconds
+ */
+int LuaEngine::lua_Sleep(lua_State* L) {
+    lua_Integer ms = luaL_checkinteger(L, 1);
+    Scheduler::from(L)->sleep(L, ms > 0 ? static_cast<uint64_t>(ms) : 0);
+    return lua_yield(L, 0);
+}
+
+/**
+ * @brief WaitUntil(pred) suspends the calling task until pred() is truthy, checked once per frame
+ */
+int LuaEngine::lua_WaitUntil(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    Scheduler::from(L)->waitUntil(L, 1);
+    return lua_yield(L, 0);
+}
+
+/**
+ * @brief Every(ms, fn) -> handle; calls fn every ms milliseconds until cancelled or it errors
+ */
+int LuaEngine::lua_Every(lua_State* L) {
+    lua_Integer ms = luaL_checkinteger(L, 1);
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+    uint64_t handle = Scheduler::from(L)->every(L, ms > 0 ? static_cast<uint64_t>(ms) : 1, 2);
+    lua_pushinteger(L, static_cast<lua_Integer>(handle));
+    return 1;
+}
+
+/**
+ * @brief Cancel(handle) -> true if a live task or timer was stopped
+ */
+int LuaEngine::lua_Cancel(lua_State* L) {
+    uint64_t handle = static_cast<uint64_t>(luaL_checkinteger(L, 1));
+    lua_pushboolean(L, Scheduler::from(L)->cancel(L, handle));
+    return 1;
+}
+
+/**
+ * @brief Pushes the text of a StringId offset, or nil when it is empty or its text has not arrived.
+ *
+ * Each id's Lua string is created once and kept in a registry table, so repeated reads push the
+ * same interned string without copying the text again. The table is dropped when the addon
+ * reloads and its ids start over.
+ */
+static int pushCapturedString(lua_State* L, const Memory& memory, std::string_view key) {
+    StringId id = 0;
+    if (!memory.tryGetCapturedValue(key, id) || id <= 0) {
+        lua_pushnil(L);
+        return 1;
+    }
+    Published<StringDictionary>::Reader dictionary = memory.stringDictionary();
+
+    lua_getfield(L, LUA_REGISTRYINDEX, STRING_CACHE_REGISTRY_KEY);
+    bool current = false;
+    if (lua_istable(L, -1)) {
+        lua_rawgeti(L, -1, 0);
+        current = lua_tointeger(L, -1) == dictionary->generation;
+        lua_pop(L, 1);
+    }
+    if (!current) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushinteger(L, dictionary->generation);
+        lua_rawseti(L, -2, 0);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, LUA_REGISTRYINDEX, STRING_CACHE_REGISTRY_KEY);
+    }
+
+    if (lua_rawgeti(L, -1, id) == LUA_TNIL && static_cast<size_t>(id) < dictionary->strings.size()
+        && !dictionary->strings[id].empty()) {
+        lua_pop(L, 1);
+        const std::string& text = dictionary->strings[id];
+        lua_pushlstring(L, text.data(), text.size());
+        lua_pushvalue(L, -1);
+        lua_rawseti(L, -3, id);
+    }
+    lua_remove(L, -2);
+    return 1;
+}
+
+/**
+ * @brief GetZoneText() -> zone name, or nil until the addon's dictionary delivered it
+ */
+int LuaEngine::lua_GetZoneText(lua_State* L) {
+    return pushCapturedString(L, from(L)->memory, "GetZoneText");
+}
+
+/**
+ * @brief GetSubZoneText() -> subzone name, or nil outside any subzone
+ */
+int LuaEngine::lua_GetSubZoneText(lua_State* L) {
+    return pushCapturedString(L, from(L)->memory, "GetSubZoneText");
+}
+
+/**
+ * @brief UnitName(unit) -> name, or nil if the unit does not exist or its name has not arrived
+ */
+int LuaEngine::lua_UnitName(lua_State* L) {
+    const char* unit = luaL_checkstring(L, 1);
+    return pushCapturedString(L, from(L)->memory, OffsetKey("UnitName__").append(unit).view());
+}
+
+/**
+ * @brief DumpFrames([reason]) -> true if the retained frames will be written, false if dumps are off
+ */
+int LuaEngine::lua_DumpFrames(lua_State* L) {
+    const char* reason = luaL_optstring(L, 1, "script");
+    lua_pushboolean(L, from(L)->memory.dumpFrames(reason));
     return 1;
 }
 
 int LuaEngine::lua_GetMoney(lua_State* L) {
-    lua_pushinteger(L, instance->memory.GetMoney());
+    lua_pushinteger(L, from(L)->memory.GetMoney());
     return 1;
 }
 
@@ -126,20 +545,20 @@ int LuaEngine::lua_TargetUnit(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
     std::cout << "Lua requests targeting unit: " << unit << "\n";
 
-    if (std::string(unit) == "party1") {
-        instance->controller.pressKey(VK_F2);
+    if (std::string_view(unit) == "party1") {
+        from(L)->controller.pressKey(VK_F2);
     }
-    else if (std::string(unit) == "party2") {
-        instance->controller.pressKey(VK_F3);
+    else if (std::string_view(unit) == "party2") {
+        from(L)->controller.pressKey(VK_F3);
     }
-    else if (std::string(unit) == "party3") {
-        instance->controller.pressKey(VK_F4);
+    else if (std::string_view(unit) == "party3") {
+        from(L)->controller.pressKey(VK_F4);
     }
-    else if (std::string(unit) == "party4") {
-        instance->controller.pressKey(VK_F5);
+    else if (std::string_view(unit) == "party4") {
+        from(L)->controller.pressKey(VK_F5);
     }
-    else if (std::string(unit) == "player") {
-        instance->controller.pressKey(VK_F1);
+    else if (std::string_view(unit) == "player") {
+        from(L)->controller.pressKey(VK_F1);
     }
     else {
         std::cerr << "Unknown unit: " << unit << "\n";
@@ -150,34 +569,21 @@ int LuaEngine::lua_TargetUnit(lua_State* L) {
 int LuaEngine::lua_IsSpellInRange(lua_State* L) {
     const char* aura = luaL_checkstring(L, 1);
 
-    // Remove non-alphanumeric characters from aura
-    std::string sanitizedAura;
-    for (const char& c : std::string(aura)) {
-        if (isalnum(c)) {
-            sanitizedAura += c;
-        }
-    }
-
     // Construct the dynamic function name
-    std::string callKey = "IsSpellInRange__" + sanitizedAura;
+    OffsetKey callKey("IsSpellInRange__");
+    callKey.appendSanitized(aura);
 
     // Check if the memory offset exists
-    auto it = instance->memory.offsetIndices.find(callKey);
-    if (it == instance->memory.offsetIndices.end()) {
-        std::cerr << "Error: Function not found for " << callKey << "\n";
+    auto it = from(L)->memory.offsetIndices.find(callKey.view());
+    if (it == from(L)->memory.offsetIndices.end()) {
+        std::cerr << "Error: Function not found for " << callKey.view() << "\n";
         lua_pushboolean(L, false);
         return 1;
     }
 
-    // Call the function dynamically
-    try {
-        bool hasBuff = instance->memory.getCapturedValue(callKey) > 0;
-        lua_pushboolean(L, hasBuff);
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error accessing value for " << callKey << ": " << e.what() << "\n";
-        lua_pushboolean(L, false);
-    }
+    // No frame yet reads as not present
+    int value = 0;
+    lua_pushboolean(L, from(L)->memory.tryGetCapturedValue(callKey.view(), value) && value > 0);
 
     return 1;
 }
@@ -185,14 +591,16 @@ int LuaEngine::lua_IsSpellInRange(lua_State* L) {
 
 int LuaEngine::lua_UnitExists(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
-    bool exists = instance->memory.getCapturedValue("UnitExists__" + std::string(unit)) == 1;
+    int value = 0;
+    bool exists = from(L)->memory.tryGetCapturedValue(OffsetKey("UnitExists__").append(unit).view(), value) && value == 1;
     lua_pushboolean(L, exists);
     return 1;
 }
 
 int LuaEngine::lua_UnitAffectingCombat(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
-    bool inCombat = instance->memory.getCapturedValue("UnitAffectingCombat__" + std::string(unit)) == 1;
+    int value = 0;
+    bool inCombat = from(L)->memory.tryGetCapturedValue(OffsetKey("UnitAffectingCombat__").append(unit).view(), value) && value == 1;
     lua_pushboolean(L, inCombat);
     return 1;
 }
@@ -201,8 +609,10 @@ int LuaEngine::lua_UnitThreatSituation(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
     const char* otherUnit = luaL_checkstring(L, 2);
 
-    std::string offsetKey = "UnitThreatSituation__" + std::string(unit) + "_" + std::string(otherUnit);
-    int threatLevel = instance->memory.getCapturedValue(offsetKey);
+    OffsetKey offsetKey("UnitThreatSituation__");
+    offsetKey.append(unit).append("_").append(otherUnit);
+    int threatLevel = 0;
+    from(L)->memory.tryGetCapturedValue(offsetKey.view(), threatLevel);
 
     lua_pushinteger(L, threatLevel);
     return 1;
@@ -212,14 +622,14 @@ int LuaEngine::lua_UnitCastingInfo(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
     bool isCasting = false;
 
-    if (std::string(unit) == "player") {
-        isCasting = instance->memory.UnitCastingInfo__player();
+    if (std::string_view(unit) == "player") {
+        isCasting = from(L)->memory.UnitCastingInfo__player();
     }
-    else if (std::string(unit) == "target") {
-        isCasting = instance->memory.UnitCastingInfo__target();
+    else if (std::string_view(unit) == "target") {
+        isCasting = from(L)->memory.UnitCastingInfo__target();
     }
-    else if (std::string(unit) == "focus") {
-        isCasting = instance->memory.UnitCastingInfo__focus();
+    else if (std::string_view(unit) == "focus") {
+        isCasting = from(L)->memory.UnitCastingInfo__focus();
     }
     else {
         lua_pushnil(L); // Invalid unit
@@ -232,12 +642,12 @@ int LuaEngine::lua_UnitCastingInfo(lua_State* L) {
 
 
 int LuaEngine::lua_SpellStopCasting(lua_State* L) {
-    instance->controller.pressKey(0x30);
+    from(L)->controller.pressKey(0x30);
     return 0;
 }
 
 int LuaEngine::lua_HasWandEquipped(lua_State* L) {
-    bool hasWand = instance->memory.HasWandEquipped();
+    bool hasWand = from(L)->memory.HasWandEquipped();
     lua_pushboolean(L, hasWand);
     return 1;
 }
@@ -263,34 +673,21 @@ int LuaEngine::lua_UnitBuff(lua_State* L) {
     const char* aura = luaL_checkstring(L, 2);
     const char* unit = luaL_checkstring(L, 1);
 
-    // Remove non-alphanumeric characters from aura
-    std::string sanitizedAura;
-    for (const char& c : std::string(aura)) {
-        if (isalnum(c)) {
-            sanitizedAura += c;
-        }
-    }
-
     // Construct the dynamic function name
-    std::string buffKey = "UnitBuff__" + std::string(unit) + "_"  + sanitizedAura;
+    OffsetKey buffKey("UnitBuff__");
+    buffKey.append(unit).append("_").appendSanitized(aura);
 
     // Check if the memory offset exists
-    auto it = instance->memory.offsetIndices.find(buffKey);
-    if (it == instance->memory.offsetIndices.end()) {
-        std::cerr << "Error: Buff function not found for " << buffKey << "\n";
+    auto it = from(L)->memory.offsetIndices.find(buffKey.view());
+    if (it == from(L)->memory.offsetIndices.end()) {
+        std::cerr << "Error: Buff function not found for " << buffKey.view() << "\n";
         lua_pushboolean(L, false);
         return 1;
     }
 
-    // Call the function dynamically
-    try {
-        bool hasBuff = instance->memory.getCapturedValue(buffKey) > 0;
-        lua_pushboolean(L, hasBuff);
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error accessing buff value for " << buffKey << ": " << e.what() << "\n";
-        lua_pushboolean(L, false);
-    }
+    // No frame yet reads as not present
+    int value = 0;
+    lua_pushboolean(L, from(L)->memory.tryGetCapturedValue(buffKey.view(), value) && value > 0);
 
     return 1;
 }
@@ -300,34 +697,21 @@ int LuaEngine::lua_UnitDebuff(lua_State* L) {
     const char* debuff = luaL_checkstring(L, 2);
     const char* unit = luaL_checkstring(L, 1);
 
-    // Remove non-alphanumeric characters from debuff
-    std::string sanitizedDebuff;
-    for (const char& c : std::string(debuff)) {
-        if (isalnum(c)) {
-            sanitizedDebuff += c;
-        }
-    }
-
     // Construct the dynamic function name
-    std::string debuffKey = "UnitDebuff__" + std::string(unit) + "_" + sanitizedDebuff;
+    OffsetKey debuffKey("UnitDebuff__");
+    debuffKey.append(unit).append("_").appendSanitized(debuff);
 
     // Check if the memory offset exists
-    auto it = instance->memory.offsetIndices.find(debuffKey);
-    if (it == instance->memory.offsetIndices.end()) {
-        std::cerr << "Error: Debuff function not found for " << debuffKey << "\n";
+    auto it = from(L)->memory.offsetIndices.find(debuffKey.view());
+    if (it == from(L)->memory.offsetIndices.end()) {
+        std::cerr << "Error: Debuff function not found for " << debuffKey.view() << "\n";
         lua_pushboolean(L, false);
         return 1;
     }
 
-    // Call the function dynamically
-    try {
-        bool hasDebuff = instance->memory.getCapturedValue(debuffKey) > 0;
-        lua_pushboolean(L, hasDebuff);
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error accessing debuff value for " << debuffKey << ": " << e.what() << "\n";
-        lua_pushboolean(L, false);
-    }
+    // No frame yet reads as not present
+    int value = 0;
+    lua_pushboolean(L, from(L)->memory.tryGetCapturedValue(debuffKey.view(), value) && value > 0);
 
     return 1;
 }
@@ -337,34 +721,22 @@ int LuaEngine::lua_UnitDebuff(lua_State* L) {
 int LuaEngine::lua_GetSpellCooldown(lua_State* L) {
     const char* spell = luaL_checkstring(L, 1);
 
-    // Remove non-alphanumeric characters from spell
-    std::string sanitizedSpell;
-    for (const char& c : std::string(spell)) {
-        if (isalnum(c)) {
-            sanitizedSpell += c;
-        }
-    }
-
     // Construct the dynamic function name
-    std::string cooldownKey = "GetSpellCooldown__" + sanitizedSpell;
+    OffsetKey cooldownKey("GetSpellCooldown__");
+    cooldownKey.appendSanitized(spell);
 
     // Check if the memory offset exists
-    auto it = instance->memory.offsetIndices.find(cooldownKey);
-    if (it == instance->memory.offsetIndices.end()) {
-        std::cerr << "Error: Cooldown function not found for " << cooldownKey << "\n";
+    auto it = from(L)->memory.offsetIndices.find(cooldownKey.view());
+    if (it == from(L)->memory.offsetIndices.end()) {
+        std::cerr << "Error: Cooldown function not found for " << cooldownKey.view() << "\n";
         lua_pushinteger(L, 0);
         return 1;
     }
 
-    // Call the function dynamically
-    try {
-        int cooldown = instance->memory.getCapturedValue(cooldownKey);
-        lua_pushinteger(L, cooldown);
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error accessing cooldown value for " << cooldownKey << ": " << e.what() << "\n";
-        lua_pushinteger(L, 0);
-    }
+    // No frame yet reads as 0
+    int cooldown = 0;
+    from(L)->memory.tryGetCapturedValue(cooldownKey.view(), cooldown);
+    lua_pushinteger(L, cooldown);
 
     return 1;
 }
@@ -372,46 +744,34 @@ int LuaEngine::lua_GetSpellCooldown(lua_State* L) {
 int LuaEngine::lua_IsSpellKnown(lua_State* L) {
     const char* spell = luaL_checkstring(L, 1);
 
-    // Remove non-alphanumeric characters from spell
-    std::string sanitizedSpell;
-    for (const char& c : std::string(spell)) {
-        if (isalnum(c)) {
-            sanitizedSpell += c;
-        }
-    }
-
     // Construct the dynamic function name
-    std::string cooldownKey = "IsSpellKnown__" + sanitizedSpell;
+    OffsetKey cooldownKey("IsSpellKnown__");
+    cooldownKey.appendSanitized(spell);
 
     // Check if the memory offset exists
-    auto it = instance->memory.offsetIndices.find(cooldownKey);
-    if (it == instance->memory.offsetIndices.end()) {
-        std::cerr << "Error: Cooldown function not found for " << cooldownKey << "\n";
+    auto it = from(L)->memory.offsetIndices.find(cooldownKey.view());
+    if (it == from(L)->memory.offsetIndices.end()) {
+        std::cerr << "Error: Cooldown function not found for " << cooldownKey.view() << "\n";
         lua_pushinteger(L, 0);
         return 1;
     }
 
-    // Call the function dynamically
-    try {
-        int cooldown = instance->memory.getCapturedValue(cooldownKey);
-        lua_pushinteger(L, cooldown);
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error accessing cooldown value for " << cooldownKey << ": " << e.what() << "\n";
-        lua_pushinteger(L, 0);
-    }
+    // No frame yet reads as 0
+    int cooldown = 0;
+    from(L)->memory.tryGetCapturedValue(cooldownKey.view(), cooldown);
+    lua_pushinteger(L, cooldown);
 
     return 1;
 }
 
 
 int LuaEngine::lua_GetNumLootItems(lua_State* L) {
-    lua_pushinteger(L, instance->memory.GetNumLootItems());
+    lua_pushinteger(L, from(L)->memory.GetNumLootItems());
     return 1;
 }
 
 int LuaEngine::lua_IsPlayerMoving(lua_State* L) {
-    lua_pushboolean(L, instance->memory.IsPlayerMoving());
+    lua_pushboolean(L, from(L)->memory.IsPlayerMoving());
     return 1;
 }
 
@@ -419,23 +779,23 @@ int LuaEngine::lua_UnitHealth(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
     int health = 0;
 
-    if (std::string(unit) == "party1") {
-        health = instance->memory.UnitHealth__party1();
+    if (std::string_view(unit) == "party1") {
+        health = from(L)->memory.UnitHealth__party1();
     }
-    else if (std::string(unit) == "party2") {
-        health = instance->memory.UnitHealth__party2();
+    else if (std::string_view(unit) == "party2") {
+        health = from(L)->memory.UnitHealth__party2();
     }
-    else if (std::string(unit) == "party3") {
-        health = instance->memory.UnitHealth__party3();
+    else if (std::string_view(unit) == "party3") {
+        health = from(L)->memory.UnitHealth__party3();
     }
-    else if (std::string(unit) == "party4") {
-        health = instance->memory.UnitHealth__party4();
+    else if (std::string_view(unit) == "party4") {
+        health = from(L)->memory.UnitHealth__party4();
     }
-    else if (std::string(unit) == "target") {
-        health = instance->memory.UnitHealth__target();
+    else if (std::string_view(unit) == "target") {
+        health = from(L)->memory.UnitHealth__target();
     }
-    else if (std::string(unit) == "player") {
-        health = instance->memory.UnitHealth__player();
+    else if (std::string_view(unit) == "player") {
+        health = from(L)->memory.UnitHealth__player();
     }
     else {
         lua_pushnil(L);
@@ -450,7 +810,7 @@ int LuaEngine::lua_UnitIsPlayer(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
 
     // Determine if the unit is a player
-    bool isPlayer = instance->memory.UnitIsPlayer__target();
+    bool isPlayer = from(L)->memory.UnitIsPlayer__target();
     lua_pushboolean(L, isPlayer);
     return 1;
 }
@@ -459,23 +819,23 @@ int LuaEngine::lua_UnitHealthMax(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
     int maxHealth = 0;
 
-    if (std::string(unit) == "party1") {
-        maxHealth = instance->memory.UnitHealthMax__party1();
+    if (std::string_view(unit) == "party1") {
+        maxHealth = from(L)->memory.UnitHealthMax__party1();
     }
-    else if (std::string(unit) == "party2") {
-        maxHealth = instance->memory.UnitHealthMax__party2();
+    else if (std::string_view(unit) == "party2") {
+        maxHealth = from(L)->memory.UnitHealthMax__party2();
     }
-    else if (std::string(unit) == "party3") {
-        maxHealth = instance->memory.UnitHealthMax__party3();
+    else if (std::string_view(unit) == "party3") {
+        maxHealth = from(L)->memory.UnitHealthMax__party3();
     }
-    else if (std::string(unit) == "party4") {
-        maxHealth = instance->memory.UnitHealthMax__party4();
+    else if (std::string_view(unit) == "party4") {
+        maxHealth = from(L)->memory.UnitHealthMax__party4();
     }
-    else if (std::string(unit) == "target") {
-        maxHealth = instance->memory.UnitHealthMax__target();
+    else if (std::string_view(unit) == "target") {
+        maxHealth = from(L)->memory.UnitHealthMax__target();
     }
-    else if (std::string(unit) == "player") {
-        maxHealth = instance->memory.UnitHealthMax__player();
+    else if (std::string_view(unit) == "player") {
+        maxHealth = from(L)->memory.UnitHealthMax__player();
     }
     else {
         lua_pushnil(L);
@@ -488,14 +848,14 @@ int LuaEngine::lua_UnitHealthMax(lua_State* L) {
 
 int LuaEngine::lua_UnitPower(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
-    int power = (std::string(unit) == "player") ? instance->memory.UnitPower__player() : 0;
+    int power = (std::string_view(unit) == "player") ? from(L)->memory.UnitPower__player() : 0;
     lua_pushinteger(L, power);
     return 1;
 }
 
 int LuaEngine::lua_UnitPowerMax(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
-    int powerMax = (std::string(unit) == "player") ? instance->memory.UnitPowerMax__player() : 0;
+    int powerMax = (std::string_view(unit) == "player") ? from(L)->memory.UnitPowerMax__player() : 0;
     lua_pushinteger(L, powerMax);
     return 1;
 }
@@ -511,17 +871,17 @@ int LuaEngine::lua_IsControlKeyDown(lua_State* L) {
 }
 
 int LuaEngine::lua_Calibration(lua_State* L) {
-    lua_pushinteger(L, instance->memory.Calibration());
+    lua_pushinteger(L, from(L)->memory.Calibration());
     return 1;
 }
 
 int LuaEngine::lua_UnitPosition(lua_State* L) {
     const char* unit = luaL_checkstring(L, 1);
 
-    if (std::string(unit) == "player") {
-        float x = instance->memory.UnitPosition__player_1();
-        float y = instance->memory.UnitPosition__player_2();
-        float z = instance->memory.UnitPosition__player_3();
+    if (std::string_view(unit) == "player") {
+        float x = from(L)->memory.UnitPosition__player_1();
+        float y = from(L)->memory.UnitPosition__player_2();
+        float z = from(L)->memory.UnitPosition__player_3();
         lua_pushnumber(L, x);
         lua_pushnumber(L, y);
         lua_pushnumber(L, z);
@@ -537,43 +897,46 @@ int LuaEngine::lua_UnitPosition(lua_State* L) {
 
 int LuaEngine::lua_TargetNearestEnemy(lua_State* L) {
     std::cout << "Lua requests targeting nearest enemy\n";
-    instance->controller.pressKey(VK_TAB);
+    from(L)->controller.pressKey(VK_TAB);
     return 0;
 }
 
 int LuaEngine::lua_CastSpell(lua_State* L) {
-    const char* spell = luaL_checkstring(L, 1);
+    size_t length = 0;
+    const char* spell = luaL_checklstring(L, 1, &length);
+    // A view over Lua's copy, so long spell names are compared without allocating
+    std::string_view name(spell, length);
     std::cout << "Lua requests casting spell: " << spell << "\n";
 
-    if (std::string(spell) == "Smite") {
-        instance->controller.pressKey(0x31); // VK code for '1'
+    if (name == "Smite") {
+        from(L)->controller.pressKey(0x31); // VK code for '1'
     }
-    else if (std::string(spell) == "Shadow Word: Pain") {
-        instance->controller.pressKey(0x32); // VK code for '2'
+    else if (name == "Shadow Word: Pain") {
+        from(L)->controller.pressKey(0x32); // VK code for '2'
     }
-    else if (std::string(spell) == "Power Word: Shield") {
-        instance->controller.pressKey(0x33); // VK code for '3'
+    else if (name == "Power Word: Shield") {
+        from(L)->controller.pressKey(0x33); // VK code for '3'
     }
-    else if (std::string(spell) == "Shoot") {
-        instance->controller.pressKey(0x34); // VK code for '4'
+    else if (name == "Shoot") {
+        from(L)->controller.pressKey(0x34); // VK code for '4'
     }
-    else if (std::string(spell) == "Heal" || std::string(spell) == "Lesser Heal") {
-        instance->controller.pressKey(0x48); // VK code for '1' (Heal and Smite share the same key)
+    else if (name == "Heal" || name == "Lesser Heal") {
+        from(L)->controller.pressKey(0x48); // VK code for '1' (Heal and Smite share the same key)
     }
-    else if (std::string(spell) == "Power Word: Fortitude") {
-        instance->controller.pressKey(0x58); // VK code for 'X'
+    else if (name == "Power Word: Fortitude") {
+        from(L)->controller.pressKey(0x58); // VK code for 'X'
     }
-    else if (std::string(spell) == "Drink") {
-        instance->controller.pressKey(0x37); // VK code for '7'
+    else if (name == "Drink") {
+        from(L)->controller.pressKey(0x37); // VK code for '7'
     }
-    else if (std::string(spell) == "Eat") {
-        instance->controller.pressKey(0x36); // VK code for '6'
+    else if (name == "Eat") {
+        from(L)->controller.pressKey(0x36); // VK code for '6'
     }
-    else if (std::string(spell) == "Mind Blast") {
-        instance->controller.pressKey(0x47); // VK code for 'G'
+    else if (name == "Mind Blast") {
+        from(L)->controller.pressKey(0x47); // VK code for 'G'
     }
-    else if (std::string(spell) == "Renew") {
-        instance->controller.pressKey(0x52); // VK code for '2'
+    else if (name == "Renew") {
+        from(L)->controller.pressKey(0x52); // VK code for '2'
     }
     else {
         std::cerr << "Unknown spell: " << spell << "\n";
@@ -583,14 +946,260 @@ int LuaEngine::lua_CastSpell(lua_State* L) {
 
 
 void LuaEngine::executeScript(const std::string& filePath) {
-    if (luaL_dofile(luaState, filePath.c_str())) {
-        std::cerr << "Lua error: " << lua_tostring(luaState, -1) << "\n";
+    scriptPaths.push_back(filePath);
+    runScripts(luaState, { filePath });
+}
+
+bool LuaEngine::runScripts(lua_State* L, const std::vector<std::string>& paths) {
+    Scheduler* stateScheduler = Scheduler::from(L);
+    for (const auto& path : paths) {
+        TickBudget::Scope budget(tickBudget, budgetStats);
+        int top = lua_gettop(L);
+        if (bytecodeCache.load(L, path) != LUA_OK) {
+            std::cerr << "Lua error: " << lua_tostring(L, -1) << "\n";
+            lua_settop(L, top);
+            return false;
+        }
+        // Each script body runs as a task, so top-level code may wait as well
+        if (!stateScheduler->spawn(L, 0)) {
+            lua_settop(L, top);
+            return false;
+        }
+        lua_settop(L, top);
     }
+    return true;
 }
 
-void LuaEngine::callFunction(const std::string& functionName) {
+void LuaEngine::loadAddons(const std::string& directory) {
+    std::error_code error;
+    std::vector<std::filesystem::path> scripts;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".lua") {
+            scripts.push_back(entry.path());
+        }
+    }
+    if (error) {
+        std::cerr << "Error: Unable to list addons in " << directory << ": " << error.message() << "\n";
+    }
+
+    std::sort(scripts.begin(), scripts.end());
+    for (const auto& script : scripts) {
+        executeScript(script.generic_string());
+    }
+}
+
+bool LuaEngine::callFunction(const std::string& functionName) {
+    TickBudget::Scope budget(tickBudget, budgetStats);
+    allocator.beginTick();
     lua_getglobal(luaState, functionName.c_str());
     if (lua_pcall(luaState, 0, 0, 0) != LUA_OK) {
         std::cerr << "Error calling Lua function '" << functionName << "': " << lua_tostring(luaState, -1) << "\n";
+        lua_pop(luaState, 1);
+        return false;
+    }
+    return true;
+}
+
+bool LuaEngine::tick(const std::string& tickFunction) {
+    applyPendingReload();
+    uint64_t frame = memory.latestFrame();
+    bool newFrame = frame != lastFrame;
+    if (!newFrame && scheduler->msUntilNextTimer() != 0) {
+        return false;
+    }
+    // Reloads are allowed to allocate; the tick itself should not once it is warm
+    uint64_t allocationsBefore = AllocationTracker::threadAllocations();
+    profiler.discardPending();
+
+    int64_t start = monotonicNanos();
+    bool succeeded = true;
+    {
+        // A runaway tick function leaves the scheduler's due tasks for the next loop
+        TickBudget::Scope budget(tickBudget, budgetStats);
+        if (newFrame) {
+            lastFrame = frame;
+            succeeded = callFunction(tickFunction);
+        }
+        scheduler->run(luaState, newFrame);
+    }
+    // Offsets first read during this tick join the captured region from the next frame on
+    memory.updateCaptureInterest();
+    AllocationTracker::checkFrame(AllocationTracker::Stage::Tick, AllocationTracker::threadAllocations() - allocationsBefore);
+    if (flightRecorder) {
+        flightRecorder->recordTick(flightClient, newFrame ? frame : 0, monotonicNanos() - start,
+            budgetStats.lastInstructions.load(std::memory_order_relaxed), !succeeded);
+    }
+    if (newFrame) {
+        tickStats.lastTickNs.store(static_cast<uint64_t>(monotonicNanos() - start), std::memory_order_relaxed);
+        tickStats.ticks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The next frame is at least a capture interval away
+    collectGarbage();
+    return true;
+}
+
+int64_t LuaEngine::msUntilNextTimer() const {
+    return scheduler->msUntilNextTimer();
+}
+
+bool LuaEngine::reload() {
+    // runScripts budgets every script like a tick, so a runaway top level cannot stall the watcher
+    lua_State* next = createState();
+    if (!runScripts(next, scriptPaths)) {
+        LuaAllocator::closeState(next);
+        tickStats.reloadFailures.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "Reload failed; keeping the running scripts.\n";
+        return false;
+    }
+
+    // A reload the tick loop never picked up is superseded by this one
+    if (lua_State* stale = pendingState.exchange(next)) {
+        LuaAllocator::closeState(stale);
+    }
+    return true;
+}
+
+void LuaEngine::closeRetiredState() {
+    if (lua_State* retired = retiredState.exchange(nullptr)) {
+        LuaAllocator::closeState(retired);
+    }
+}
+
+void LuaEngine::applyPendingReload() {
+    lua_State* next = pendingState.exchange(nullptr);
+    if (!next) {
+        return;
+    }
+
+    int64_t start = monotonicNanos();
+    copyPersistentState(luaState, next);
+    lua_State* previous = luaState;
+    luaState = next;
+    scheduler = Scheduler::from(luaState);
+    heapAfterCycleKb = 0;
+    gcCycleInProgress = false;
+
+    // Closing a state can take longer than the swap itself; leave it to the watcher
+    if (lua_State* unclosed = retiredState.exchange(previous)) {
+        LuaAllocator::closeState(unclosed);
+    }
+
+    tickStats.lastSwapNs.store(static_cast<uint64_t>(monotonicNanos() - start), std::memory_order_relaxed);
+    tickStats.reloads.fetch_add(1, std::memory_order_relaxed);
+    std::cout << "Scripts reloaded.\n";
+}
+
+void LuaEngine::copyPersistentState(lua_State* from, lua_State* to) {
+    if (lua_getfield(to, LUA_REGISTRYINDEX, PERSISTENT_REGISTRY_KEY) != LUA_TTABLE) {
+        lua_pop(to, 1);
+        return;
+    }
+
+    lua_pushnil(to);
+    while (lua_next(to, -2)) {
+        lua_pop(to, 1); // Keep the name for the next iteration
+        const char* name = lua_tostring(to, -1);
+
+        lua_getglobal(from, name);
+        if (copyValue(from, -1, to, 0)) {
+            lua_setglobal(to, name);
+        }
+        lua_pop(from, 1);
+    }
+    lua_pop(to, 1);
+}
+
+bool LuaEngine::copyValue(lua_State* from, int index, lua_State* to, int depth) {
+    index = lua_absindex(from, index);
+    switch (lua_type(from, index)) {
+    case LUA_TNIL:
+        lua_pushnil(to);
+        return true;
+    case LUA_TBOOLEAN:
+        lua_pushboolean(to, lua_toboolean(from, index));
+        return true;
+    case LUA_TNUMBER:
+        if (lua_isinteger(from, index)) {
+            lua_pushinteger(to, lua_tointeger(from, index));
+        }
+        else {
+            lua_pushnumber(to, lua_tonumber(from, index));
+        }
+        return true;
+    case LUA_TSTRING: {
+        size_t length;
+        const char* value = lua_tolstring(from, index, &length);
+        lua_pushlstring(to, value, length);
+        return true;
+    }
+    case LUA_TTABLE:
+        if (depth >= 8) {
+            return false; // Also stops reference cycles
+        }
+        lua_newtable(to);
+        lua_pushnil(from);
+        while (lua_next(from, index)) {
+            if (copyValue(from, -2, to, depth + 1)) {
+                if (copyValue(from, -1, to, depth + 1)) {
+                    lua_rawset(to, -3);
+                }
+                else {
+                    lua_pop(to, 1);
+                }
+            }
+            lua_pop(from, 1);
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+void LuaEngine::setGcBudget(int64_t budgetUs) {
+    gcBudgetNs = budgetUs * 1000;
+}
+
+void LuaEngine::setTickBudget(uint64_t instructions, int64_t budgetMs) {
+    tickBudget.instructions = instructions;
+    tickBudget.timeNs = budgetMs * 1000000;
+}
+
+void LuaEngine::setFlightRecorder(FlightRecorder* recorder, int client) {
+    flightRecorder = recorder;
+    flightClient = client;
+}
+
+void LuaEngine::collectGarbage() {
+    size_t heapKb = static_cast<size_t>(lua_gc(luaState, LUA_GCCOUNT));
+
+    // Don't start a new cycle until the heap has grown by half since the last one
+    if (!gcCycleInProgress && heapKb < heapAfterCycleKb + heapAfterCycleKb / 2 + 64) {
+        tickStats.lastGcNs.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    // If the heap doubled, the budget is not keeping up: finish the cycle regardless
+    bool forced = heapKb > 2 * heapAfterCycleKb + 1024;
+
+    int64_t start = monotonicNanos();
+    gcCycleInProgress = true;
+    do {
+        if (lua_gc(luaState, LUA_GCSTEP, 0)) {
+            gcCycleInProgress = false;
+            heapAfterCycleKb = static_cast<size_t>(lua_gc(luaState, LUA_GCCOUNT));
+            tickStats.gcCycles.fetch_add(1, std::memory_order_relaxed);
+            if (forced) {
+                tickStats.forcedGcCycles.fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+        }
+    } while (forced || monotonicNanos() - start < gcBudgetNs);
+
+    uint64_t elapsed = static_cast<uint64_t>(monotonicNanos() - start);
+    tickStats.lastGcNs.store(elapsed, std::memory_order_relaxed);
+    tickStats.totalGcNs.fetch_add(elapsed, std::memory_order_relaxed);
+    if (elapsed > tickStats.maxGcNs.load(std::memory_order_relaxed)) {
+        tickStats.maxGcNs.store(elapsed, std::memory_order_relaxed);
     }
 }
@@ -28,12 +28,58 @@
 #ifndef LUAENGINE_H
 #define LUAENGINE_H
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
 #include <string>
+#include <thread>
+#include <vector>
+extern "C" {
 #include "lua.h"
 #include "lauxlib.h"
 #include "lualib.h"
+}
 #include "Memory.h"
 #include "Controller.h"
+#include "LuaAllocator.h"
+#include "BytecodeCache.h"
+#include "Profiler.h"
+#include "Scheduler.h"
+#include "TickBudget.h"
+
+class FlightRecorder;
+class MetricsWriter;
+
+/**
+ * @brief Call statistics for one native function exposed to Lua.
+ */
+struct BindingStats {
+    const char* name;                       ///< Global name seen by scripts
+    lua_CFunction function;                 ///< Native implementation
+    std::atomic<uint64_t> calls{ 0 };       ///< Completed calls
+    std::atomic<uint64_t> totalNs{ 0 };     ///< Accumulated wall time
+    std::atomic<uint64_t> maxNs{ 0 };       ///< Slowest single call
+
+    BindingStats(const char* bindingName, lua_CFunction bindingFunction)
+        : name(bindingName), function(bindingFunction) {}
+};
+
+/**
+ * @brief Tick and garbage-collector timing, written by the Lua thread.
+ */
+struct TickStats {
+    std::atomic<uint64_t> ticks{ 0 };           ///< Completed ticks
+    std::atomic<uint64_t> lastTickNs{ 0 };      ///< Duration of the last tick, excluding GC
+    std::atomic<uint64_t> lastGcNs{ 0 };        ///< GC time spent after the last tick
+    std::atomic<uint64_t> totalGcNs{ 0 };       ///< Accumulated GC time
+    std::atomic<uint64_t> maxGcNs{ 0 };         ///< Longest GC slice
+    std::atomic<uint64_t> gcCycles{ 0 };        ///< Completed collection cycles
+    std::atomic<uint64_t> forcedGcCycles{ 0 };  ///< Cycles finished past the budget because the heap outgrew it
+    std::atomic<uint64_t> reloads{ 0 };         ///< Script reloads swapped in
+    std::atomic<uint64_t> reloadFailures{ 0 };  ///< Reloads discarded because a script failed to load
+    std::atomic<uint64_t> lastSwapNs{ 0 };      ///< Time the tick loop spent swapping in the last reload
+};
 
  /**
   * @class LuaEngine
@@ -41,19 +87,145 @@
   */
 class LuaEngine {
 private:
+    LuaAllocator allocator;      ///< Size-class arenas of luaState and of reloaded states
     lua_State* luaState;         ///< Lua state
+    BytecodeCache& bytecodeCache; ///< Precompiled chunks for executeScript/loadAddons, shared by every client
     Memory& memory;              ///< Reference to Memory instance
     Controller& controller;      ///< Reference to Controller instance
+    std::deque<BindingStats> bindings; ///< Registered bindings; deque keeps addresses stable for closures
+    TickStats tickStats;         ///< Tick and GC timing
+    int64_t gcBudgetNs;          ///< Idle time the collector may use after each tick
+    size_t heapAfterCycleKb;     ///< Heap size when the last GC cycle finished
+    bool gcCycleInProgress;      ///< True between the first and last step of a cycle
+    uint64_t lastFrame;          ///< Sequence of the last frame the tick function ran on
+    SchedulerStats schedulerStats; ///< Task counters shared by every state's scheduler
+    Scheduler* scheduler;        ///< Scheduler owned by luaState
+    TickBudgetLimits tickBudget; ///< Instruction and time limits of one tick
+    BudgetStats budgetStats;     ///< Budget usage and overrun locations
+    Profiler profiler;           ///< Stack sampler fed by the hook and the binding trampoline
+
+    // Hot reload
+    std::vector<std::string> scriptPaths;       ///< Scripts run by executeScript, in order
+    std::atomic<lua_State*> pendingState;       ///< Fully loaded state waiting to be swapped in
+    std::atomic<lua_State*> retiredState;       ///< Replaced state waiting to be closed off the tick thread
+
+    FlightRecorder* flightRecorder;             ///< Records every tick, if set
+    int flightClient;                           ///< Client id of the recorded ticks
+
+    /**
+     * @brief Engine owning a Lua state or any of its threads, stored in the state's extra space.
+     */
+    static LuaEngine* from(lua_State* L) { return *static_cast<LuaEngine**>(lua_getextraspace(L)); }
+
+    /**
+     * @brief Adds a native function to the set installed into every Lua state.
+     * @param name Global name of the function.
+     * @param function Native implementation.
+     */
+    void registerBinding(const char* name, lua_CFunction function);
+
+    /**
+     * @brief Creates a Lua state with the standard libraries, GC settings and all bindings.
+     */
+    lua_State* createState();
+
+    /**
+     * @brief Loads and runs scripts in the given state.
+     * @return False if any script failed; the error has been reported.
+     */
+    bool runScripts(lua_State* L, const std::vector<std::string>& paths);
 
-    static LuaEngine* instance;  ///< Static instance pointer for Lua callbacks
+    /**
+     * @brief Swaps in a reloaded state, carrying over persistent globals. Called between ticks.
+     */
+    void applyPendingReload();
+
+    /**
+     * @brief Copies every global designated with Persist() in `to` from `from`.
+     */
+    static void copyPersistentState(lua_State* from, lua_State* to);
+
+    /**
+     * @brief Pushes a copy of the value at `index` in `from` onto `to`.
+     * @return False (and nothing pushed) for functions, userdata, threads, or tables nested too deep.
+     */
+    static bool copyValue(lua_State* from, int index, lua_State* to, int depth);
+
+    /**
+     * @brief Trampoline installed for every binding; upvalue 1 is its BindingStats.
+     */
+    static int instrumentedBinding(lua_State* L);
+
+    /**
+     * @brief Hook installed in every state; routes count events to the profiler and the tick budget.
+     */
+    static void hookDispatcher(lua_State* L, lua_Debug* ar);
+
+    /**
+     * @brief Reports unprotected Lua errors before the state aborts.
+     */
+    static int panicHandler(lua_State* L);
+
+    /**
+     * @brief Runs incremental GC steps until the cycle ends or the idle budget is spent.
+     */
+    void collectGarbage();
+
+    // Lua bindings
+    static int lua_UnitHealth(lua_State* L);
+    static int lua_UnitHealthMax(lua_State* L);
+    static int lua_UnitPower(lua_State* L);
+    static int lua_UnitPowerMax(lua_State* L);
+    static int lua_IsPlayerMoving(lua_State* L);
+    static int lua_UnitAffectingCombat(lua_State* L);
+    static int lua_GetMoney(lua_State* L);
+    static int lua_UnitBuff(lua_State* L);
+    static int lua_UnitDebuff(lua_State* L);
+    static int lua_CastSpell(lua_State* L);
+    static int lua_TargetNearestEnemy(lua_State* L);
+    static int lua_IsControlKeyDown(lua_State* L);
+    static int lua_Calibration(lua_State* L);
+    static int lua_UnitPosition(lua_State* L);
+    static int lua_UnitCastingInfo(lua_State* L);
+    static int lua_TargetUnit(lua_State* L);
+    static int lua_GetSpellCooldown(lua_State* L);
+    static int lua_GetNumLootItems(lua_State* L);
+    static int lua_HasWandEquipped(lua_State* L);
+    static int lua_UnitExists(lua_State* L);
+    static int lua_UnitThreatSituation(lua_State* L);
+    static int lua_UnitIsPlayer(lua_State* L);
+    static int lua_SpellStopCasting(lua_State* L);
+    static int lua_IsSpellKnown(lua_State* L);
+    static int lua_IsSpellInRange(lua_State* L);
+    static int lua_JumpOrAscendStart(lua_State* L);
+    static int lua_MoveForwardStart(lua_State* L);
+    static int lua_Persist(lua_State* L);
+    static int lua_CompileRotation(lua_State* L);
+    static int lua_EvaluateRotation(lua_State* L);
+    static int lua_PartyHealth(lua_State* L);
+    static int lua_LowestHealthUnit(lua_State* L);
+    static int lua_UnitsBelowHealth(lua_State* L);
+    static int lua_UnitsMissingAura(lua_State* L);
+    static int lua_GetTime(lua_State* L);
+    static int lua_Spawn(lua_State* L);
+    static int lua_WaitFrames(lua_State* L);
+    static int lua_Sleep(lua_State* L);
+    static int lua_WaitUntil(lua_State* L);
+    static int lua_Every(lua_State* L);
+    static int lua_Cancel(lua_State* L);
+    static int lua_GetZoneText(lua_State* L);
+    static int lua_GetSubZoneText(lua_State* L);
+    static int lua_UnitName(lua_State* L);
+    static int lua_DumpFrames(lua_State* L);
 
 public:
     /**
      * @brief Constructor to initialize LuaEngine with references to Memory and Controller.
      * @param mem Reference to Memory instance.
      * @param ctrl Reference to Controller instance.
+     * @param cache Bytecode cache; one cache can serve the engines of every client.
      */
-    LuaEngine(Memory& mem, Controller& ctrl);
+    LuaEngine(Memory& mem, Controller& ctrl, BytecodeCache& cache);
 
     /**
      * @brief Destructor to clean up Lua state.
@@ -66,11 +238,75 @@ public:
      */
     void executeScript(const std::string& filePath);
 
+    /**
+     * @brief Runs the executed scripts in a fresh state, off the tick thread, and queues it to be
+     *        swapped in between ticks. Called by the ScriptWatcher once the scripts have been executed.
+     * @return False if a script failed to load; the running scripts are kept.
+     */
+    bool reload();
+
+    /**
+     * @brief Closes the state replaced by the last swap, if any. Called off the tick thread.
+     */
+    void closeRetiredState();
+
+    /**
+     * @brief Executes every .lua file below a directory, in path order.
+     * @param directory Root directory of the addons.
+     */
+    void loadAddons(const std::string& directory);
+
     /**
      * @brief Calls a Lua function by its name.
      * @param functionName Name of the Lua function to call.
+     * @return False if the function raised an error; it has been reported.
+     */
+    bool callFunction(const std::string& functionName);
+
+    /**
+     * @brief Runs the script once without blocking: the tick function if a new frame was captured,
+     *        then any due tasks, then GC. Driven by the ClientRuntime workers.
+     * @param tickFunction Name of the global Lua function to call each frame.
+     * @return False if there was nothing to do.
+     */
+    bool tick(const std::string& tickFunction);
+
+    /**
+     * @brief Milliseconds until a script timer may fire, or -1 if none is pending.
+     */
+    int64_t msUntilNextTimer() const;
+
+    /**
+     * @brief Sets how much idle time the collector may use after each tick.
+     * @param budgetUs Budget in microseconds.
+     */
+    void setGcBudget(int64_t budgetUs);
+
+    /**
+     * @brief Sets the limits after which a tick's scripts are aborted as runaway.
+     * @param instructions Lua VM instructions per tick.
+     * @param budgetMs Wall time per tick in milliseconds.
+     */
+    void setTickBudget(uint64_t instructions, int64_t budgetMs);
+
+    /**
+     * @brief Appends every tick to a flight recorder; set before the first tick.
+     * @param recorder Recorder outliving this engine, or null to stop recording.
+     * @param client Client id stored with each tick.
+     */
+    void setFlightRecorder(FlightRecorder* recorder, int client);
+
+    /**
+     * @brief Sampling profiler of the scripts, switched on and off at runtime.
+     */
+    Profiler& getProfiler() { return profiler; }
+
+    /**
+     * @brief Reports per-binding call counts and latencies, Lua heap statistics, GC pauses,
+     *        reloads and tick budget overruns. The shared bytecode cache reports separately.
+     * @param metrics Writer collecting the samples.
      */
-    void callFunction(const std::string& functionName);
+    void collectMetrics(MetricsWriter& metrics) const;
 };
 
 #endif // LUAENGINE_H
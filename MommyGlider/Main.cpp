@@ -3,10 +3,87 @@
  * @brief Entry point for the application. Initializes calibration, memory, controller, and Lua engine.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
-#include "LuaEngine.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AllocationTracker.h"
+#include "ClientRuntime.h"
+#include "FrameDumper.h"
+#include "MetricsServer.h"
+
+int main(int argc, char* argv[]) {
+    // Optional command line settings
+    std::string metricsSocket;
+    bool hotReload = true;
+    uint64_t tickInstructions = 5000000;
+    int64_t tickBudgetMs = 100;
+    int workers = 0;
+    bool sharedFrames = false;
+    std::string captureBackend;
+    std::string dumpDirectory;
+    size_t dumpRetain = FrameDumper::DEFAULT_RETAINED_FRAMES;
+    bool allocCheck = false;
+    uint64_t allocBudget = 0;
+    uint64_t allocWarmup = 300;
+    uint64_t allocFrames = 1000;
+    std::string flightPath = "MommyGlider.flight";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--metrics-socket" && i + 1 < argc) {
+            metricsSocket = argv[++i];
+        }
+        else if (arg == "--no-hot-reload") {
+            hotReload = false;
+        }
+        else if (arg == "--tick-instructions" && i + 1 < argc) {
+            tickInstructions = std::stoull(argv[++i]);
+        }
+        else if (arg == "--tick-budget-ms" && i + 1 < argc) {
+            tickBudgetMs = std::stoll(argv[++i]);
+        }
+        else if (arg == "--workers" && i + 1 < argc) {
+            workers = std::stoi(argv[++i]);
+        }
+        else if (arg == "--shared-frames") {
+            sharedFrames = true;
+        }
+        else if (arg == "--capture-backend" && i + 1 < argc) {
+            captureBackend = argv[++i];
+        }
+        else if (arg == "--dump-frames" && i + 1 < argc) {
+            dumpDirectory = argv[++i];
+        }
+        else if (arg == "--dump-retain" && i + 1 < argc) {
+            dumpRetain = std::stoull(argv[++i]);
+        }
+        else if (arg == "--flight-recorder" && i + 1 < argc) {
+            flightPath = argv[++i];
+        }
+        else if (arg == "--alloc-check" && i + 1 < argc) {
+            allocCheck = true;
+            allocBudget = std::stoull(argv[++i]);
+        }
+        else if (arg == "--alloc-check-warmup" && i + 1 < argc) {
+            allocWarmup = std::stoull(argv[++i]);
+        }
+        else if (arg == "--alloc-check-frames" && i + 1 < argc) {
+            allocFrames = std::stoull(argv[++i]);
+        }
+    }
+
+    // Counting needs the replaced operator new; a build without it would always pass
+    if (allocCheck && !AllocationTracker::ENABLED) {
+        std::cerr << "Error: --alloc-check needs a build with MOMMYGLIDER_ALLOC_TRACKING defined.\n";
+        return 1;
+    }
+    if (allocCheck) {
+        AllocationTracker::configure(allocBudget, allocWarmup, allocFrames);
+    }
 
-int main() {
     // Example calibration data
     CalibrationData calibration = {
         2560,   // screenWidth
@@ -18,17 +95,91 @@ int main() {
         1       // spacing
     };
 
-    // Initialize Memory
-    Memory memory(calibration);
+    // One capture, input and script pipeline per game window
+    ClientRuntime runtime(calibration, "Interface/.bytecode", captureBackend);
+    runtime.flightRecorder().installCrashHandlers(flightPath);
+    size_t clientCount = runtime.discoverClients();
+    if (workers <= 0) {
+        workers = static_cast<int>(std::min<size_t>(clientCount, std::max(1u, std::thread::hardware_concurrency())));
+    }
 
-    // Corrected instantiation of Controller
-    Controller controller;
+    // Initialize the optional metrics endpoint; offset queries, the profiler and frame dumps take a
+    // trailing client index and address the first client without one
+    std::unique_ptr<MetricsServer> metricsServer;
+    if (!metricsSocket.empty()) {
+        std::vector<Memory*> memories;
+        for (size_t i = 0; i < clientCount; ++i) {
+            memories.push_back(runtime.client(i).memory.get());
+        }
+        metricsServer = std::make_unique<MetricsServer>(metricsSocket, std::move(memories));
+        metricsServer->addCollector([&runtime](MetricsWriter& metrics) { runtime.collectMetrics(metrics); });
+        // `profile start <hz> <client>`: a client after `start` needs the rate spelled out
+        metricsServer->addCommand("profile", [&runtime](const std::string& arguments) {
+            std::string profilerArguments = arguments;
+            size_t client = MetricsServer::takeClient(profilerArguments, arguments.rfind("start", 0) == 0 ? 2 : 1);
+            if (client >= runtime.clientCount()) {
+                return "ERR no client " + std::to_string(client) + "\n";
+            }
+            return runtime.client(client).engine->getProfiler().handleCommand(profilerArguments);
+        });
+        metricsServer->addCommand("flight", [&runtime](const std::string&) {
+            return runtime.flightRecorder().dump() ? std::string("Flight recorder dumped.\n")
+                : std::string("Flight recorder dump failed.\n");
+        });
+        metricsServer->addCommand("dump", [&runtime](const std::string& arguments) {
+            std::string reason = arguments;
+            size_t client = MetricsServer::takeClient(reason);
+            if (client >= runtime.clientCount()) {
+                return "ERR no client " + std::to_string(client) + "\n";
+            }
+            return runtime.client(client).memory->dumpFrames(reason.empty() ? "manual" : reason)
+                ? std::string("Dumping retained frames.\n") : std::string("Frame dumps are not enabled.\n");
+        });
+        metricsServer->start();
+    }
 
-    // Initialize LuaEngine
-    LuaEngine luaEngine(memory, controller);
+    // Out-of-process readers open "MommyGlider.Frames.<client>" with FrameReader (FrameRing.h)
+    if (sharedFrames) {
+        for (size_t i = 0; i < clientCount; ++i) {
+            runtime.client(i).memory->enableSharedFrames("MommyGlider.Frames." + std::to_string(i));
+        }
+    }
+
+    // Each client keeps its last frames; a dump lands in "<dir>/<client>/<dump>-<reason>/"
+    if (!dumpDirectory.empty()) {
+        for (size_t i = 0; i < clientCount; ++i) {
+            runtime.client(i).memory->enableFrameDumps(dumpDirectory + "/" + std::to_string(i), dumpRetain);
+        }
+    }
 
     std::cout << "Starting Lua engine.\n";
-    //luaEngine.loadAddons("Interface/Addons/");
-    luaEngine.executeScript("Interface/main.lua");
+    for (size_t i = 0; i < clientCount; ++i) {
+        LuaEngine& luaEngine = *runtime.client(i).engine;
+        luaEngine.setTickBudget(tickInstructions, tickBudgetMs);
+        //luaEngine.loadAddons("Interface/Addons/");
+        luaEngine.executeScript("Interface/main.lua");
+    }
+    if (hotReload) {
+        runtime.enableHotReload("Interface");
+    }
+
+    // An allocation check stops once every stage checked its frames, failing the run if any was over budget
+    std::thread allocWatcher;
+    if (allocCheck && allocFrames > 0) {
+        allocWatcher = std::thread([&runtime]() {
+            while (!AllocationTracker::finished()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            runtime.requestStop();
+        });
+    }
+    runtime.run("OnTick", workers);
+    if (allocWatcher.joinable()) {
+        allocWatcher.join();
+    }
+    if (allocCheck) {
+        AllocationTracker::report();
+        return AllocationTracker::passed() ? 0 : 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
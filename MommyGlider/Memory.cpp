@@ -21,30 +21,101 @@
 #include <thread>
 #include <chrono>
 #include "Memory.h"
+#include "CaptureSource.h"
+#include "FlightRecorder.h"
+#include "FrameDumper.h"
+#include "FramePublisher.h"
 #include "Util.h"
 #include "CalibrationData.h"
+#include "MetricsServer.h"
 #include <fstream>
 
+#pragma comment(lib, "Synchronization.lib")
 
 // Static member initialization
-std::map<std::string, OffsetMetadata> Memory::offsetIndices;
+OffsetSchema Memory::offsetIndices;
 
 // Constructor
-Memory::Memory(const CalibrationData& calibrationData) : calibration(calibrationData), stopThread(false) {
-    // Start the data capture thread
-    captureThread = std::thread(&Memory::captureOffsets, this);
+Memory::Memory(const CalibrationData& calibrationData, std::atomic<uint64_t>* sharedSignal, CaptureSource* sharedSource)
+    : calibration(calibrationData), frameSignal(sharedSignal), source(sharedSource) {
+    auto indexOf = [](const char* key) {
+        auto it = offsetIndices.find(key);
+        return it == offsetIndices.end() ? -1 : it->second.index;
+    };
+    tickCounterIndex = indexOf("TickCounter");
+    tickCounterTailIndex = indexOf("TickCounterTail");
+    gameTimeIndex = indexOf("GameTime");
+    generationIndex = indexOf("DictionaryGeneration");
+    mailboxHeaderIndex = indexOf("MailboxHeader");
+    for (int i = 1; indexOf(("MailboxData_" + std::to_string(i)).c_str()) >= 0; ++i) {
+        mailboxDataIndices.push_back(indexOf(("MailboxData_" + std::to_string(i)).c_str()));
+    }
+    dictionary.publish(std::make_unique<const StringDictionary>());
+
+    // Pixel positions only depend on the calibration, so they are resolved once
+    auto columnX = [this](int column) {
+        return translateToMonitorCoords(((column + 1) * calibration.spacing) - calibration.pixelSize, 0, calibration).first;
+    };
+    auto groupOf = [](OffsetRate rate, int column) {
+        for (int group = 0; group < OFFSET_CHECK_GROUP_COUNT; ++group) {
+            const OffsetCheckGroup& layout = OFFSET_CHECK_GROUPS[group];
+            if (layout.panel == static_cast<int>(rate) && column >= layout.firstColumn && column < layout.checkColumn) {
+                return group;
+            }
+        }
+        return -1;
+    };
+    for (int group = 0; group < OFFSET_CHECK_GROUP_COUNT; ++group) {
+        const OffsetCheckGroup& layout = OFFSET_CHECK_GROUPS[group];
+        for (int column = layout.firstColumn; column < layout.checkColumn; ++column) {
+            checkGroups[group].xs.push_back(columnX(column));
+        }
+        checkGroups[group].checkX = columnX(layout.checkColumn);
+    }
+
+    std::vector<CaptureSource::Panel> panels;
+    for (OffsetRate rate : { OffsetRate::Fast, OffsetRate::Slow }) {
+        RECT boundingBox = calculateBoundingBox(rate);
+        int width = boundingBox.right - boundingBox.left;
+        panelWidths[static_cast<int>(rate)] = width;
+        std::vector<StripColumn>& panelColumns = columns[static_cast<int>(rate)];
+
+        for (const auto& [key, metadata] : offsetIndices) {
+            if (metadata.rate != rate) {
+                continue;
+            }
+            int x = columnX(metadata.column);
+            if (x < 0 || x >= width) {
+                std::cerr << "Error: Offset " << key << " lies outside the captured strip." << std::endl;
+                continue;
+            }
+            if (key == "LayoutHash") {
+                layoutHashX = x;
+                continue;
+            }
+            panelColumns.push_back({ metadata.index, x, metadata.bit, groupOf(rate, metadata.column), &key, &metadata.type });
+        }
+        // Packed bools share a pixel, so each pixel is read once in a row
+        std::stable_sort(panelColumns.begin(), panelColumns.end(), [](const StripColumn& a, const StripColumn& b) { return a.x < b.x; });
+
+        // `width` pixels right of the reference, pixelSize rows high
+        RECT area = { boundingBox.left, boundingBox.top, boundingBox.left + width, boundingBox.top + calibration.pixelSize };
+        panels.push_back({ area, rate == OffsetRate::Slow ? SLOW_FRAME_INTERVAL : 1 });
+    }
+
+    // Start capturing; frames may be decoded from here on
+    if (!source) {
+        ownSource = std::make_unique<CaptureSource>();
+        source = ownSource.get();
+    }
+    source->addStrip(this, panels);
 }
 
 // Destructor
 Memory::~Memory() {
-    // Signal the thread to stop and join it
-    {
-        std::lock_guard<std::mutex> lock(threadMutex);
-        stopThread = true;
-    }
-    if (captureThread.joinable()) {
-        captureThread.join();
-    }
+    // Returns once the capture thread no longer decodes into this instance
+    source->removeStrip(this);
+    stats.state = CaptureState::Stopped;
 }
 
 /**
@@ -62,7 +133,7 @@ Color Memory::getPixelColor(int x, int y) const {
 }
 
 /**
- * @brief Calculates the pixel coordinates for a given offset key, assuming a single row.
+ * @brief Calculates the pixel coordinates for a given offset key within its panel row.
  *
  * @param key The offset key as a string.
  * @return A pair containing the x and y coordinates in monitor coordinates.
@@ -74,24 +145,39 @@ std::pair<int, int> Memory::calculatePixelCoordinates(const std::string& key) co
     }
 
     auto meta = it->second;
-    int column = meta.index + 1;
+    int column = meta.column + 1;
+    // The slow panel is painted one row below the fast one
+    float row = meta.rate == OffsetRate::Slow ? static_cast<float>(calibration.spacing) : 0.0f;
 
     float uiX = calibration.refX + (column * calibration.spacing) - calibration.pixelSize;
-    float uiY = calibration.refY - calibration.pixelSize;
+    float uiY = calibration.refY - row - calibration.pixelSize;
 
     return translateToMonitorCoords(uiX, uiY, calibration);
 }
 /**
- * @brief Calculates the bounding box for the offsets and converts it to monitor coordinates.
+ * @brief Calculates the bounding box of one panel and converts it to monitor coordinates.
  *
+ * @param rate Rate class whose panel is measured.
  * @return A RECT structure defining the bounding box in monitor coordinates.
  */
-RECT Memory::calculateBoundingBox() const {
+RECT Memory::calculateBoundingBox(OffsetRate rate) const {
+    size_t panelSize = 1; // At least the slow panel's calibration marker
+    for (const auto& [key, metadata] : offsetIndices) {
+        if (metadata.rate == rate) {
+            panelSize = std::max(panelSize, static_cast<size_t>(metadata.column) + 1);
+        }
+    }
+    for (const OffsetCheckGroup& group : OFFSET_CHECK_GROUPS) {
+        if (group.panel == static_cast<int>(rate)) {
+            panelSize = std::max(panelSize, static_cast<size_t>(group.checkColumn) + 1);
+        }
+    }
+
     // Initial bounding box based on calibration
     RECT boundingBox;
     boundingBox.left = static_cast<int>(calibration.refX);
-    boundingBox.top = static_cast<int>(calibration.refY);
-    boundingBox.right = boundingBox.left + static_cast<int>(offsetIndices.size() * calibration.spacing);
+    boundingBox.top = static_cast<int>(calibration.refY) - (rate == OffsetRate::Slow ? calibration.spacing : 0);
+    boundingBox.right = boundingBox.left + static_cast<int>(panelSize * calibration.spacing);
     boundingBox.bottom = boundingBox.top + calibration.pixelSize;
 
     std::cout << "Initial Bounding Box (UI Coordinates): "
@@ -102,10 +188,11 @@ RECT Memory::calculateBoundingBox() const {
     auto [screenLeft, screenTop] = translateToMonitorCoords(boundingBox.left, boundingBox.top, calibration);
     auto [screenRight, screenBottom] = translateToMonitorCoords(boundingBox.right, boundingBox.bottom, calibration);
 
-    boundingBox.left = screenLeft;
-    boundingBox.top = screenTop;
-    boundingBox.right = screenRight;
-    boundingBox.bottom = screenBottom;
+    // Windowed clients are offset by the position of their client area
+    boundingBox.left = screenLeft + calibration.originX;
+    boundingBox.top = screenTop + calibration.originY;
+    boundingBox.right = screenRight + calibration.originX;
+    boundingBox.bottom = screenBottom + calibration.originY;
 
     std::cout << "Bounding Box After Conversion (Monitor Coordinates): "
         << "Left: " << boundingBox.left << ", Top: " << boundingBox.top
@@ -114,64 +201,228 @@ RECT Memory::calculateBoundingBox() const {
     return boundingBox;
 }
 /**
- * @brief Captures all offset values in a thread-safe manner and saves the screen region to a file.
+ * @brief Decodes the captured panels and publishes the frame to the snapshot store.
+ *
+ * Only the capture thread calls this, so it is the only writer of the store and no lock is
+ * held while decoding. Values of a panel that was not captured this frame, of offsets outside
+ * the captured region and of offsets in a group failing its check keep their last decoded value.
+ *
+ * @param panels Top-left pixel of each panel in the shared capture buffer, indexed by OffsetRate.
+ * @param captureTime monotonicNanos() when the screen copy finished.
+ * @param interest Region the panels were captured with, or null if they were captured whole.
  */
-void Memory::captureOffsets() {
-    HDC hdc = GetDC(NULL);
-    RECT boundingBox = calculateBoundingBox();
-
-    int width = boundingBox.right - boundingBox.left;
-    int height = calibration.pixelSize;
-
-    auto [spacing, _] = translateToMonitorCoords(calibration.spacing, 0, calibration);
+void Memory::decodeFrame(const uint32_t* const panels[PANEL_COUNT], int64_t captureTime, const CaptureInterest* interest) {
+    auto toColor = [](uint32_t pixel) -> Color {
+        return { static_cast<int>((pixel >> 16) & 0xFF), static_cast<int>((pixel >> 8) & 0xFF), static_cast<int>(pixel & 0xFF) };
+    };
+    auto calibrated = [&](const uint32_t* strip) {
+        Color calibrationColor = toColor(strip[0]);
+        return calibrationColor.r == 255 && calibrationColor.g == 217 && calibrationColor.b == 4;
+    };
+    uint64_t frame = stats.framesCaptured.fetch_add(1, std::memory_order_relaxed) + 1;
+    // Rejected frames are retained too; they are often the ones worth looking at
+    if (FrameDumper* frameDumper = dumper.load(std::memory_order_acquire)) {
+        frameDumper->record(panels, frame);
+    }
 
-    HDC memDC = CreateCompatibleDC(hdc);
-    HBITMAP hBitmap = CreateCompatibleBitmap(hdc, width, height);
-    SelectObject(memDC, hBitmap);
+    // Validate calibration color; without the fast panel there is no frame at all
+    const uint32_t* fast = panels[static_cast<int>(OffsetRate::Fast)];
+    if (!fast || !calibrated(fast)) {
+        stats.framesDropped.fetch_add(1, std::memory_order_relaxed);
+        stats.panelsDropped[static_cast<int>(OffsetRate::Fast)].fetch_add(1, std::memory_order_relaxed);
+        stats.state = CaptureState::WaitingForCalibration;
+        return;
+    }
 
-    while (true) {
-        {
-            std::lock_guard<std::mutex> lock(threadMutex);
-            if (stopThread) break;
+    // Offsets.h and the addon are generated together; any other pairing would decode garbage
+    if (layoutHashX >= 0 && (fast[layoutHashX] & 0xFFFFFF) != OFFSET_LAYOUT_HASH) {
+        if (!layoutMismatchReported) {
+            std::cerr << "Error: The addon's offset layout (0x" << std::hex << (fast[layoutHashX] & 0xFFFFFF)
+                << ") does not match Offsets.h (0x" << OFFSET_LAYOUT_HASH << std::dec
+                << "). Regenerate both with GenerateOffsets.lua." << std::endl;
+            layoutMismatchReported = true;
+        }
+        stats.framesDropped.fetch_add(1, std::memory_order_relaxed);
+        stats.state = CaptureState::LayoutMismatch;
+        return;
+    }
 
-            // Copy the screen region to memory
-            BOOL result = BitBlt(memDC, 0, 0, width, height, hdc, boundingBox.left, boundingBox.top, SRCCOPY);
-            if (!result) {
-                std::cerr << "Error: BitBlt failed. Check coordinates and device contexts." << std::endl;
-                continue;
+    // Extract pixel data into a copy, so a rejected frame leaves the last accepted values intact
+    int values[OFFSET_COUNT];
+    std::copy(std::begin(frameValues), std::end(frameValues), values);
+    bool groupValid[OFFSET_CHECK_GROUP_COUNT];
+    bool slowDecoded = false;
+    for (int panel = 0; panel < PANEL_COUNT; ++panel) {
+        const uint32_t* strip = panels[panel];
+        if (!strip) {
+            continue;
+        }
+        if (!calibrated(strip)) {
+            stats.panelsDropped[panel].fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        // Offsets of a corrupted group are stale: they keep their previous value
+        verifyGroups(strip, panel, interest ? &interest->groups[panel] : nullptr, groupValid);
+        if (panel == static_cast<int>(OffsetRate::Fast)) {
+            bool metadataValid = true;
+            for (const StripColumn& column : columns[panel]) {
+                if (isFrameMetadata(column.index) && column.group >= 0 && !groupValid[column.group]) {
+                    metadataValid = false;
+                }
+            }
+            // Without trustworthy counters there is no telling which frame this is
+            if (!metadataValid) {
+                stats.framesDropped.fetch_add(1, std::memory_order_relaxed);
+                stats.state = CaptureState::Running;
+                return;
             }
+        }
+        auto decode = [&](const StripColumn& column) {
+            if (column.group >= 0 && !groupValid[column.group]) {
+                return;
+            }
+            if (column.bit >= 0) {
+                values[column.index] = static_cast<int>((strip[column.x] >> column.bit) & 1);
+                return;
+            }
+            try {
+                values[column.index] = decodeRGBToValue<int>(toColor(strip[column.x]), *column.type);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Error capturing offset for key " << *column.key << ": " << e.what() << std::endl;
+            }
+        };
+        if (interest) {
+            for (int position : interest->columns[panel]) {
+                decode(columns[panel][position]);
+            }
+        }
+        else {
+            for (const StripColumn& column : columns[panel]) {
+                decode(column);
+            }
+        }
+        stats.panelsDecoded[panel].fetch_add(1, std::memory_order_relaxed);
+        slowDecoded |= panel == static_cast<int>(OffsetRate::Slow);
+    }
 
-            // Validate calibration color
-            COLORREF firstPixel = GetPixel(memDC, 0, 0);
-            Color calibrationColor = { GetRValue(firstPixel), GetGValue(firstPixel), GetBValue(firstPixel) };
+    // TickCounter is painted at both ends of the fast panel; if they differ, the copy caught the
+    // addon halfway through a repaint and the strip mixes two ticks
+    if (tickCounterIndex >= 0 && tickCounterTailIndex >= 0 && values[tickCounterIndex] != values[tickCounterTailIndex]) {
+        stats.framesTorn.fetch_add(1, std::memory_order_relaxed);
+        stats.state = CaptureState::Running;
+        return;
+    }
+    std::copy(std::begin(values), std::end(values), frameValues);
+    readMailbox(frameValues);
+
+    // The addon bumps TickCounter on every fast tick: the same value means the game has not painted
+    // since the last grab, so nothing is published and no reader is woken for identical data
+    if (tickCounterIndex >= 0) {
+        int tick = frameValues[tickCounterIndex];
+        if (snapshotStore.sequence() != 0 && tick == lastTickCounter && !slowDecoded) {
+            stats.framesRepeated.fetch_add(1, std::memory_order_relaxed);
+            stats.state = CaptureState::Running;
+            return;
+        }
+        lastTickCounter = tick;
+    }
 
-            if (calibrationColor.r != 255 || calibrationColor.g != 217 || calibrationColor.b != 4) {
-                continue;
-            }
+    if (gameTimeIndex >= 0) {
+        recordLatency(frameValues[gameTimeIndex], captureTime);
+    }
+    snapshotStore.publish(frameValues, captureTime);
+    publishedFrames.store(snapshotStore.sequence(), std::memory_order_release);
+    if (FramePublisher* shared = publisher.load(std::memory_order_acquire)) {
+        shared->publish(snapshotStore.sequence(), frameValues, captureTime);
+    }
+    if (FlightRecorder* recorder = flightRecorder.load(std::memory_order_acquire)) {
+        recorder->recordFrame(flightClient, snapshotStore.sequence(), captureTime, frameValues);
+    }
+    WakeByAddressAll(&publishedFrames);
+    if (frameSignal) {
+        frameSignal->fetch_add(1, std::memory_order_release);
+        WakeByAddressAll(frameSignal);
+    }
+    stats.framesDecoded.fetch_add(1, std::memory_order_relaxed);
+    stats.state = CaptureState::Running;
+}
 
-            // Extract pixel data
-            for (const auto& [key, metadata] : offsetIndices) {
-                auto [x, _] = translateToMonitorCoords(((metadata.index + 1) * calibration.spacing) - calibration.pixelSize, 0, calibration);
+/**
+ * @brief Records a screen copy that failed.
+ */
+void Memory::captureFailed() {
+    stats.framesDropped.fetch_add(1, std::memory_order_relaxed);
+    stats.state = CaptureState::BlitFailed;
+}
 
-                COLORREF pixel = GetPixel(memDC, x, 0);
-                Color color = { GetRValue(pixel), GetGValue(pixel), GetBValue(pixel) };
+/**
+ * @brief Starts copying every decoded frame into a shared-memory ring other processes can read.
+ *
+ * @param name Ring name, e.g. "MommyGlider.Frames.0".
+ * @return False if the ring could not be created or was already enabled.
+ */
+bool Memory::enableSharedFrames(const std::string& name) {
+    if (sharedFrames) {
+        std::cerr << "Error: Shared frames are already enabled." << std::endl;
+        return false;
+    }
+    auto ring = std::make_unique<FramePublisher>();
+    if (!ring->open(name, offsetIndices, OFFSET_COUNT)) {
+        return false;
+    }
+    sharedFrames = std::move(ring);
+    publisher.store(sharedFrames.get(), std::memory_order_release);
+    return true;
+}
 
-                try {
-                    capturedData[key] = decodeRGBToValue<int>(color, metadata.type);
-                }
-                catch (const std::exception& e) {
-                    std::cerr << "Error capturing offset for key " << key << ": " << e.what() << std::endl;
-                }
-            }
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+/**
+ * @brief Starts retaining captured strips for dumpFrames().
+ *
+ * @param directory Directory receiving one subdirectory of QOI images per dump.
+ * @param retainedFrames Number of most recent frames written by each dump.
+ * @return False if dumps were already enabled or the directory cannot be created.
+ */
+bool Memory::enableFrameDumps(const std::string& directory, size_t retainedFrames) {
+    if (frameDumps) {
+        std::cerr << "Error: Frame dumps are already enabled." << std::endl;
+        return false;
     }
+    auto frames = std::make_unique<FrameDumper>();
+    if (!frames->open(directory, std::vector<int>(std::begin(panelWidths), std::end(panelWidths)), retainedFrames)) {
+        return false;
+    }
+    frameDumps = std::move(frames);
+    dumper.store(frameDumps.get(), std::memory_order_release);
+    return true;
+}
 
-    DeleteObject(hBitmap);
-    DeleteDC(memDC);
-    ReleaseDC(NULL, hdc);
+/**
+ * @brief Writes the retained strips out, without waiting for the files.
+ *
+ * @param reason Appended to the dump's directory name.
+ * @return False if enableFrameDumps() was not called.
+ */
+bool Memory::dumpFrames(const std::string& reason) {
+    FrameDumper* frameDumper = dumper.load(std::memory_order_acquire);
+    if (!frameDumper) {
+        return false;
+    }
+    frameDumper->trigger(reason);
+    return true;
 }
 
+/**
+ * @brief Starts appending published frames to a flight recorder.
+ *
+ * @param recorder Recorder outliving this Memory, or null to stop recording.
+ * @param client Client id stored with each frame.
+ */
+void Memory::setFlightRecorder(FlightRecorder* recorder, int client) {
+    flightClient = client;
+    flightRecorder.store(recorder, std::memory_order_release);
+}
 
 /**
  * @brief Saves a bitmap to a file.
@@ -201,10 +452,11 @@ void Memory::saveBitmapToFile(HBITMAP hBitmap, int width, int height, const std:
     bi.biClrImportant = 0;
 
     DWORD dwBmpSize = ((width * bi.biBitCount + 31) / 32) * 4 * height;
-    HANDLE hDIB = GlobalAlloc(GHND, dwBmpSize);
-    char* lpbitmap = (char*)GlobalLock(hDIB);
+    std::vector<char> bitmap(dwBmpSize);
 
-    GetDIBits(GetDC(0), hBitmap, 0, (UINT)height, lpbitmap, (BITMAPINFO*)&bi, DIB_RGB_COLORS);
+    HDC screenDC = GetDC(NULL);
+    GetDIBits(screenDC, hBitmap, 0, (UINT)height, bitmap.data(), (BITMAPINFO*)&bi, DIB_RGB_COLORS);
+    ReleaseDC(NULL, screenDC);
 
     // Create the .bmp file
     std::ofstream file(filename, std::ios::binary);
@@ -223,11 +475,7 @@ void Memory::saveBitmapToFile(HBITMAP hBitmap, int width, int height, const std:
     file.write(reinterpret_cast<const char*>(&bi), sizeof(BITMAPINFOHEADER));
 
     // Write the bitmap data
-    file.write(lpbitmap, dwBmpSize);
-
-    // Cleanup
-    GlobalUnlock(hDIB);
-    GlobalFree(hDIB);
+    file.write(bitmap.data(), dwBmpSize);
     file.close();
 
     std::cout << "Bitmap saved to file: " << filename << std::endl;
@@ -239,14 +487,414 @@ void Memory::saveBitmapToFile(HBITMAP hBitmap, int width, int height, const std:
  *
  * @param key The key for the offset value.
  * @return The captured value.
+ * @throws std::runtime_error If the key is unknown or no frame was captured yet.
+ */
+int Memory::getCapturedValue(std::string_view key) const {
+    int value = 0;
+    if (!tryGetCapturedValue(key, value)) {
+        throw std::runtime_error("Captured value not found for key: " + std::string(key));
+    }
+    return value;
+}
+
+/**
+ * @brief Retrieves the captured value for an offset index without a key lookup.
+ *
+ * @param index The offset index as declared in Offsets.h.
+ * @return The captured value.
+ * @throws std::runtime_error If the index is out of range or no frame was captured yet.
+ */
+int Memory::getCapturedValue(int index) const {
+    int value = 0;
+    if (!tryGetCapturedValue(index, value)) {
+        throw std::runtime_error("Captured value not found for index: " + std::to_string(index));
+    }
+    return value;
+}
+
+/**
+ * @brief Retrieves the captured value for a specific key without throwing or allocating.
+ *
+ * @param key The key for the offset value.
+ * @param value Receives the captured value; left unchanged on a miss.
+ * @return False if the key is unknown or no frame was captured yet.
+ */
+bool Memory::tryGetCapturedValue(std::string_view key, int& value) const {
+    auto it = offsetIndices.find(key);
+    if (it == offsetIndices.end()) {
+        return false;
+    }
+    return tryGetCapturedValue(it->second.index, value);
+}
+
+/**
+ * @brief Retrieves the captured value for an offset index without throwing or allocating.
+ *
+ * @param index The offset index as declared in Offsets.h.
+ * @param value Receives the captured value; left unchanged on a miss.
+ * @return False if the index is out of range or no frame was captured yet.
+ */
+bool Memory::tryGetCapturedValue(int index, int& value) const {
+    noteOffsetRead(index);
+    if (index < 0 || index >= OFFSET_COUNT || snapshotStore.sequence() == 0) {
+        return false;
+    }
+    value = snapshotStore.value(index);
+    return true;
+}
+
+/**
+ * @brief Records that a script reads an offset, so it stays in the captured region.
+ *
+ * @param index The offset index as declared in Offsets.h; out-of-range indices are ignored.
+ */
+void Memory::noteOffsetRead(int index) const {
+    if (index < 0 || index >= OFFSET_COUNT) {
+        return;
+    }
+    uint64_t bit = uint64_t(1) << (index & 63);
+    std::atomic<uint64_t>& word = offsetsRead[index >> 6];
+    // Reads of known offsets only cost a load
+    if (!(word.load(std::memory_order_relaxed) & bit)) {
+        word.fetch_or(bit, std::memory_order_relaxed);
+        offsetsReadChanged.store(true, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Rebuilds the capture region from the offsets read so far.
+ *
+ * Each panel keeps its calibration pixel, the layout hash and the check groups holding the frame
+ * metadata or an offset that was read. Columns closer than SPAN_MERGE_GAP pixels are merged into one
+ * span, as one wider copy is cheaper than two separate ones.
  */
-int Memory::getCapturedValue(const std::string& key) const {
-    std::lock_guard<std::mutex> lock(threadMutex);
-    auto it = capturedData.find(key);
-    if (it == capturedData.end()) {
-        throw std::runtime_error("Captured value not found for key: " + key);
+void Memory::updateCaptureInterest() {
+    if (!offsetsReadChanged.exchange(false, std::memory_order_acquire)) {
+        return;
     }
-    return it->second;
+    auto isRead = [this](int index) {
+        return index >= 0 && (offsetsRead[index >> 6].load(std::memory_order_relaxed) >> (index & 63)) & 1;
+    };
+
+    auto next = std::make_unique<CaptureInterest>();
+    size_t captured = 0;
+    for (int panel = 0; panel < PANEL_COUNT; ++panel) {
+        std::vector<int> xs = { 0 }; // Calibration pixel
+        if (panel == static_cast<int>(OffsetRate::Fast) && layoutHashX >= 0) {
+            xs.push_back(layoutHashX);
+        }
+        // An offset is only decoded once its check group verified, so the whole group is captured
+        std::vector<bool> wanted(OFFSET_CHECK_GROUP_COUNT, false);
+        std::vector<bool> decoded(columns[panel].size(), false);
+        for (size_t i = 0; i < columns[panel].size(); ++i) {
+            const StripColumn& column = columns[panel][i];
+            if (!isRead(column.index) && !isFrameMetadata(column.index) && !isMailbox(column.index)) {
+                continue;
+            }
+            if (column.group >= 0) {
+                wanted[column.group] = true;
+            }
+            else {
+                decoded[i] = true;
+                xs.push_back(column.x);
+            }
+        }
+        for (int group = 0; group < OFFSET_CHECK_GROUP_COUNT; ++group) {
+            if (wanted[group]) {
+                next->groups[panel].push_back(group);
+                xs.insert(xs.end(), checkGroups[group].xs.begin(), checkGroups[group].xs.end());
+                xs.push_back(checkGroups[group].checkX);
+            }
+        }
+        std::sort(xs.begin(), xs.end());
+
+        std::vector<ColumnSpan>& spans = next->spans[panel];
+        for (int x : xs) {
+            if (!spans.empty() && x < spans.back().right + SPAN_MERGE_GAP) {
+                spans.back().right = std::max(spans.back().right, x + 1);
+            }
+            else {
+                spans.push_back({ x, x + 1 });
+            }
+        }
+
+        // Offsets sharing a group with a read one are decoded too; their pixels are fresh anyway
+        for (size_t i = 0; i < columns[panel].size(); ++i) {
+            if (decoded[i] || (columns[panel][i].group >= 0 && wanted[columns[panel][i].group])) {
+                next->columns[panel].push_back(static_cast<int>(i));
+            }
+        }
+        captured += next->columns[panel].size();
+    }
+    stats.offsetsCaptured.store(captured, std::memory_order_relaxed);
+    interest.publish(std::move(next));
+}
+
+/**
+ * @brief Verifies the check groups of one captured panel.
+ *
+ * The addon paints after each group a check pixel holding the XOR of the group's colors and
+ * OFFSET_CHECK_SEED. Scaling, gamma or an overlay changing any pixel of the group breaks it.
+ *
+ * @param strip Top-left pixel of the panel.
+ * @param panel Panel index (OffsetRate).
+ * @param groups Groups to verify, or null for every group of the panel; only those were captured whole.
+ * @param valid Receives, by group index, whether the group may be decoded.
+ */
+void Memory::verifyGroups(const uint32_t* strip, int panel, const std::vector<int>* groups, bool valid[]) {
+    auto verify = [&](int group) {
+        uint32_t check = OFFSET_CHECK_SEED;
+        for (int x : checkGroups[group].xs) {
+            check ^= strip[x];
+        }
+        valid[group] = ((check ^ strip[checkGroups[group].checkX]) & 0xFFFFFF) == 0;
+        stats.groupsVerified[panel].fetch_add(1, std::memory_order_relaxed);
+        if (!valid[group]) {
+            stats.groupsCorrupted[panel].fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+    // Groups outside the region of interest were not captured; their offsets are not decoded either
+    std::fill(valid, valid + OFFSET_CHECK_GROUP_COUNT, false);
+    if (groups) {
+        for (int group : *groups) {
+            verify(group);
+        }
+        return;
+    }
+    for (int group = 0; group < OFFSET_CHECK_GROUP_COUNT; ++group) {
+        if (OFFSET_CHECK_GROUPS[group].panel == panel) {
+            verify(group);
+        }
+    }
+}
+
+/**
+ * @brief Tells whether an offset describes the frame rather than the game state.
+ *
+ * @param index Offset index.
+ * @return True for TickCounter, TickCounterTail and GameTime.
+ */
+bool Memory::isFrameMetadata(int index) const {
+    return index >= 0 && (index == tickCounterIndex || index == tickCounterTailIndex || index == gameTimeIndex);
+}
+
+/**
+ * @brief Tells whether an offset belongs to the string dictionary mailbox.
+ *
+ * @param index Offset index.
+ * @return True for DictionaryGeneration, MailboxHeader and the MailboxData offsets.
+ */
+bool Memory::isMailbox(int index) const {
+    if (index < 0) {
+        return false;
+    }
+    if (index == generationIndex || index == mailboxHeaderIndex) {
+        return true;
+    }
+    return std::find(mailboxDataIndices.begin(), mailboxDataIndices.end(), index) != mailboxDataIndices.end();
+}
+
+/**
+ * @brief Takes the dictionary chunk shown in the mailbox of an accepted frame.
+ *
+ * The addon shows each chunk of each string for a few captures and then cycles through its whole
+ * dictionary again, so chunks arrive repeatedly and in any order; a string is published once all
+ * chunks up to its terminating zero byte are in. Ids are only valid within one
+ * DictionaryGeneration, so a new generation starts an empty dictionary.
+ *
+ * @param values Decoded values of the frame.
+ */
+void Memory::readMailbox(const int* values) {
+    if (generationIndex < 0 || mailboxHeaderIndex < 0 || mailboxDataIndices.empty()) {
+        return;
+    }
+    // Only this thread publishes dictionaries, so the current one needs no hazard slot
+    const StringDictionary* current = dictionary.latest();
+    int generation = values[generationIndex];
+    if (generation != current->generation) {
+        pendingStrings.clear();
+        auto next = std::make_unique<StringDictionary>();
+        next->generation = generation;
+        stats.dictionaryStrings.store(0, std::memory_order_relaxed);
+        dictionary.publish(std::move(next));
+        current = dictionary.latest();
+    }
+
+    int header = values[mailboxHeaderIndex];
+    int id = (header >> 8) & 0xFFFF;
+    int chunk = header & 0xFF;
+    if (id == 0 || (static_cast<size_t>(id) < current->strings.size() && !current->strings[id].empty())) {
+        return; // Empty mailbox, or a string repeated by the addon's cycle that is already known
+    }
+    std::string bytes;
+    for (int index : mailboxDataIndices) {
+        bytes.push_back(static_cast<char>((values[index] >> 16) & 0xFF));
+        bytes.push_back(static_cast<char>((values[index] >> 8) & 0xFF));
+        bytes.push_back(static_cast<char>(values[index] & 0xFF));
+    }
+    std::map<int, std::string>& chunks = pendingStrings[id];
+    if (!chunks.emplace(chunk, std::move(bytes)).second) {
+        return;
+    }
+    stats.mailboxChunks.fetch_add(1, std::memory_order_relaxed);
+
+    // Complete once chunks 0..n are in and chunk n holds the terminator
+    std::string text;
+    int expected = 0;
+    for (const auto& [position, part] : chunks) {
+        if (position != expected++) {
+            return;
+        }
+        size_t end = part.find('\0');
+        text.append(part, 0, end);
+        if (end != std::string::npos) {
+            auto next = std::make_unique<StringDictionary>(*current);
+            if (next->strings.size() <= static_cast<size_t>(id)) {
+                next->strings.resize(id + 1);
+            }
+            next->strings[id] = std::move(text);
+            pendingStrings.erase(id);
+            stats.dictionaryStrings.fetch_add(1, std::memory_order_relaxed);
+            dictionary.publish(std::move(next));
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Records how long after the game painted a frame it was captured.
+ *
+ * GetTime() and monotonicNanos() have unrelated origins, so only the difference between the two
+ * stamps of a frame is known: the clock offset plus the frame's latency. The smallest difference
+ * seen recently stands in for the offset, and each frame reports its latency above that fastest
+ * frame. Differences far above the offset mean a clock jumped; they are counted as skipped until
+ * the window moves past them.
+ *
+ * @param gameTimeMs GameTime offset of the frame, GetTime() in milliseconds modulo 2^24.
+ * @param captureTime monotonicNanos() when the screen copy finished.
+ */
+void Memory::recordLatency(int gameTimeMs, int64_t captureTime) {
+    // Both stamps are reduced to 24 bits of milliseconds, the range of the painted one
+    constexpr int64_t WRAP_US = (int64_t(1) << 24) * 1000;
+    auto wrap = [](int64_t us) { return (us % WRAP_US + WRAP_US) % WRAP_US; };
+    int64_t differenceUs = wrap(captureTime / 1000 - int64_t(gameTimeMs) * 1000);
+
+    if (++latencyWindowFrames > LATENCY_WINDOW_FRAMES) {
+        latencyWindowMinUs[0] = latencyWindowMinUs[1];
+        latencyWindowMinUs[1] = -1;
+        latencyWindowFrames = 1;
+    }
+    // Minimum modulo the wrap: a difference "below" the offset lies in the upper half past it
+    auto below = [&](int64_t a, int64_t b) { return b < 0 || (a != b && wrap(b - a) < WRAP_US / 2); };
+    if (below(differenceUs, latencyWindowMinUs[1])) {
+        latencyWindowMinUs[1] = differenceUs;
+    }
+    int64_t offsetUs = latencyWindowMinUs[1];
+    if (latencyWindowMinUs[0] >= 0 && below(latencyWindowMinUs[0], offsetUs)) {
+        offsetUs = latencyWindowMinUs[0];
+    }
+
+    int64_t latencyUs = wrap(differenceUs - offsetUs);
+    if (latencyUs > MAX_FRAME_LATENCY_MS * 1000) {
+        stats.latencySkipped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    stats.lastLatencyUs.store(static_cast<uint64_t>(latencyUs), std::memory_order_relaxed);
+    if (static_cast<uint64_t>(latencyUs) > stats.maxLatencyUs.load(std::memory_order_relaxed)) {
+        stats.maxLatencyUs.store(static_cast<uint64_t>(latencyUs), std::memory_order_relaxed);
+    }
+    stats.latencyTotalUs.fetch_add(static_cast<uint64_t>(latencyUs), std::memory_order_relaxed);
+    stats.latencySamples.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Waits for the capture thread to publish a new frame.
+ *
+ * @param lastSequence Sequence number of the last frame the caller processed.
+ * @param timeoutMs Maximum time to wait in milliseconds.
+ * @return The latest sequence number, equal to lastSequence if the wait timed out.
+ */
+uint64_t Memory::waitForFrame(uint64_t lastSequence, DWORD timeoutMs) const {
+    uint64_t current = publishedFrames.load(std::memory_order_acquire);
+    if (current == lastSequence) {
+        WaitOnAddress(const_cast<std::atomic<uint64_t>*>(&publishedFrames), &lastSequence, sizeof(lastSequence), timeoutMs);
+        current = publishedFrames.load(std::memory_order_acquire);
+    }
+    return current;
+}
+
+/**
+ * @brief Reports capture counters and state.
+ *
+ * @param metrics Writer collecting the samples.
+ */
+void Memory::collectMetrics(MetricsWriter& metrics) const {
+    // A shared source is reported once by its owner
+    if (ownSource) {
+        ownSource->collectMetrics(metrics);
+    }
+    if (sharedFrames) {
+        sharedFrames->collectMetrics(metrics);
+    }
+    if (frameDumps) {
+        frameDumps->collectMetrics(metrics);
+    }
+    metrics.counter("mommyglider_frames_captured_total", "Strips copied from the screen.",
+        static_cast<double>(stats.framesCaptured.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_frames_decoded_total", "Frames decoded and published to the snapshot store.",
+        static_cast<double>(stats.framesDecoded.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_offsets_captured", "Offsets inside the captured region of interest (all of them until scripts have read any).",
+        static_cast<double>(stats.offsetsCaptured.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_frames_repeated_total", "Frames skipped because the addon had not painted a new tick since the last grab.",
+        static_cast<double>(stats.framesRepeated.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_frames_torn_total", "Frames discarded because the strip was copied while the addon was repainting it.",
+        static_cast<double>(stats.framesTorn.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_frame_latency_seconds", "Game-paint to capture latency of the last published frame, above that of the fastest recent frame.",
+        stats.lastLatencyUs.load(std::memory_order_relaxed) / 1e6);
+    metrics.gauge("mommyglider_frame_latency_max_seconds", "Longest latency of any published frame above that of the fastest recent frame.",
+        stats.maxLatencyUs.load(std::memory_order_relaxed) / 1e6);
+    metrics.counter("mommyglider_frame_latency_seconds_total", "Sum of the latencies of published frames above that of the fastest recent frame.",
+        stats.latencyTotalUs.load(std::memory_order_relaxed) / 1e6);
+    metrics.counter("mommyglider_frame_latency_samples_total", "Published frames whose latency could be measured.",
+        static_cast<double>(stats.latencySamples.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_frame_latency_skipped_total", "GameTime stamps skipped because they were too far from the estimated clock offset.",
+        static_cast<double>(stats.latencySkipped.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_dictionary_strings", "Strings received through the addon's string dictionary mailbox.",
+        static_cast<double>(stats.dictionaryStrings.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_dictionary_chunks_total", "New string dictionary chunks read from the mailbox.",
+        static_cast<double>(stats.mailboxChunks.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_frames_dropped_total", "Frames discarded because the copy failed or calibration did not match.",
+        static_cast<double>(stats.framesDropped.load(std::memory_order_relaxed)));
+
+    static const char* const panelLabels[PANEL_COUNT] = { "panel=\"fast\"", "panel=\"slow\"" };
+    for (int panel = 0; panel < PANEL_COUNT; ++panel) {
+        metrics.counter("mommyglider_panels_decoded_total", "Offset panels decoded, by rate class.",
+            static_cast<double>(stats.panelsDecoded[panel].load(std::memory_order_relaxed)), panelLabels[panel]);
+        metrics.counter("mommyglider_panels_dropped_total", "Captured offset panels whose calibration marker did not match.",
+            static_cast<double>(stats.panelsDropped[panel].load(std::memory_order_relaxed)), panelLabels[panel]);
+        metrics.counter("mommyglider_check_groups_verified_total", "Pixel groups whose check pixel was verified, by panel.",
+            static_cast<double>(stats.groupsVerified[panel].load(std::memory_order_relaxed)), panelLabels[panel]);
+        metrics.counter("mommyglider_check_groups_corrupted_total", "Pixel groups that failed their check; their offsets kept the previous values.",
+            static_cast<double>(stats.groupsCorrupted[panel].load(std::memory_order_relaxed)), panelLabels[panel]);
+    }
+
+    static const std::pair<CaptureState, const char*> states[] = {
+        { CaptureState::Starting, "starting" },
+        { CaptureState::Running, "running" },
+        { CaptureState::WaitingForCalibration, "waiting_for_calibration" },
+        { CaptureState::BlitFailed, "blit_failed" },
+        { CaptureState::LayoutMismatch, "layout_mismatch" },
+        { CaptureState::Stopped, "stopped" },
+    };
+    CaptureState current = stats.state.load(std::memory_order_relaxed);
+    for (const auto& [state, label] : states) {
+        metrics.gauge("mommyglider_capture_state", "Current capture thread state (1 for the active state).",
+            state == current ? 1 : 0, std::string("state=\"") + label + "\"");
+    }
+
+    int64_t lastCapture = snapshotStore.lastCaptureTimeNs();
+    double age = lastCapture == 0 ? -1.0 : (monotonicNanos() - lastCapture) / 1e9;
+    metrics.gauge("mommyglider_last_frame_age_seconds", "Seconds since the last decoded frame was captured (-1 before the first frame).", age);
 }
 
 /**
@@ -263,7 +911,7 @@ T Memory::decodeRGBToValue(const Color& color, const std::string& type) const {
     if (type == "bool") {
         return static_cast<T>(color.g > 128);
     }
-    else if (type == "int") {
+    else if (type == "int" || type == "StringId") {
         return static_cast<T>((color.r << 16) | (color.g << 8) | color.b);
     }
     else {
@@ -1,57 +1,201 @@
     #ifndef MEMORY_H
     #define MEMORY_H
 
+    #include <atomic>
+    #include <iostream>
     #include <map>
+    #include <memory>
     #include <string>
-    #include <unordered_map>
-    #include <mutex>
-    #include <thread>
+    #include <string_view>
+    #include <vector>
     #include <windows.h>
     #include "CalibrationData.h"
+    #include "OffsetLayout.h"
+    #include "Published.h"
+    #include "Snapshot.h"
+
+    class CaptureSource;
+    class FlightRecorder;
+    class FrameDumper;
+    class FramePublisher;
+    class MetricsWriter;
 
     // Color structure for RGB values
     struct Color {
         int r, g, b;
     };
 
+    // How often an offset is painted by the addon and decoded. Each rate class has its own panel
+    // (pixel row): the fast panel is captured every frame, the slow one every SLOW_FRAME_INTERVAL.
+    enum class OffsetRate {
+        Fast,   // Changes from one frame to the next (health, casts, cooldowns)
+        Slow    // Changes rarely (money, XP, known spells)
+    };
+    constexpr int PANEL_COUNT = 2;
+
+    // Value of a text offset: the id of its string in the addon's string dictionary, 0 for no text
+    using StringId = int;
+
+    // Strings received through the dictionary mailbox
+    struct StringDictionary {
+        int generation = 0;                 // DictionaryGeneration the ids belong to
+        std::vector<std::string> strings;   // Indexed by StringId; empty until the text arrived
+    };
+
     // Struct to store offset metadata
     struct OffsetMetadata {
         int index;          // Offset index
         std::string type;   // Offset type ("bool", "int", etc.)
+        OffsetRate rate = OffsetRate::Fast;
+        int column = 0;     // Pixel within the panel of its rate class
+        int bit = -1;       // Bit within a pixel of packed bools, -1 if the offset fills the pixel
+    };
+
+    // Offsets by name; std::less<> lets bindings look names up as string_views without a copy
+    using OffsetSchema = std::map<std::string, OffsetMetadata, std::less<>>;
+
+    // Pixel columns [left, right) of one panel, relative to the panel's left edge
+    struct ColumnSpan {
+        int left;
+        int right;
+    };
+
+    // Region of interest of one Memory: the column spans worth capturing in each panel, the check
+    // groups (indices into OFFSET_CHECK_GROUPS) they cover whole and the positions (into the panel's
+    // decode list) of the offsets in those groups
+    struct CaptureInterest {
+        std::vector<ColumnSpan> spans[PANEL_COUNT];
+        std::vector<int> groups[PANEL_COUNT];
+        std::vector<int> columns[PANEL_COUNT];
+    };
+
+    // Lifecycle of the capture thread, exported as a metric
+    enum class CaptureState {
+        Starting,               // Thread not yet in its loop
+        Running,                // Decoding frames
+        WaitingForCalibration,  // Strip captured but the calibration pixel did not match
+        LayoutMismatch,         // Addon generated from another Offsets.schema.lua than Offsets.h
+        BlitFailed,             // Screen copy failed
+        Stopped                 // Thread exited
+    };
+
+    // Capture counters, written by the capture thread and read lock-free by anyone
+    struct CaptureStats {
+        std::atomic<uint64_t> framesCaptured{ 0 };  // Successful screen copies
+        std::atomic<uint64_t> framesDecoded{ 0 };   // Frames published to the snapshot store
+        std::atomic<uint64_t> framesDropped{ 0 };   // Failed copies and calibration mismatches
+        std::atomic<uint64_t> framesRepeated{ 0 };  // Grabs whose TickCounter matched the previous frame
+        std::atomic<uint64_t> framesTorn{ 0 };      // Strips copied mid-repaint: TickCounter and TickCounterTail differ
+        std::atomic<uint64_t> latencySamples{ 0 };  // Published frames with a usable GameTime stamp
+        std::atomic<uint64_t> latencySkipped{ 0 };  // GameTime stamps too far above the clock offset to be a latency
+        std::atomic<uint64_t> latencyTotalUs{ 0 };  // Sum of their latencies above the fastest frame
+        std::atomic<uint64_t> lastLatencyUs{ 0 };
+        std::atomic<uint64_t> maxLatencyUs{ 0 };
+        std::atomic<uint64_t> offsetsCaptured{ OFFSET_COUNT }; // Offsets inside the region of interest
+        std::atomic<uint64_t> mailboxChunks{ 0 };   // Dictionary chunks taken from the mailbox
+        std::atomic<uint64_t> dictionaryStrings{ 0 }; // Strings known in the current dictionary
+        std::atomic<uint64_t> panelsDecoded[PANEL_COUNT] = {};  // Per rate class
+        std::atomic<uint64_t> panelsDropped[PANEL_COUNT] = {};  // Slow panel mismatches keep the previous values
+        std::atomic<uint64_t> groupsVerified[PANEL_COUNT] = {}; // Check groups whose check pixel was compared
+        std::atomic<uint64_t> groupsCorrupted[PANEL_COUNT] = {}; // Of those, groups that failed; their offsets keep the previous values
+        std::atomic<CaptureState> state{ CaptureState::Starting };
     };
 
     class Memory {
     public:
-        Memory(const CalibrationData& calibrationData);
+        // The slow panel is decoded on every Nth frame only; the addon repaints it at least that often
+        static constexpr int SLOW_FRAME_INTERVAL = 8;
+        // Columns of interest closer than this many pixels are captured as one span
+        static constexpr int SPAN_MERGE_GAP = 8;
+        // Latencies above this are taken as the game clock having jumped and are only counted as skipped
+        static constexpr int64_t MAX_FRAME_LATENCY_MS = 10000;
+        // The clock offset is the smallest capture-minus-game time of the current and the previous
+        // window of this many frames, so it follows slow drift between the two clocks
+        static constexpr uint64_t LATENCY_WINDOW_FRAMES = 4096;
+
+        // frameSignal, if given, is incremented and woken after every published frame, so one
+        // waiter can watch the capture threads of several clients. The strip is captured by
+        // sharedSource if given, otherwise by a capture thread of its own.
+        Memory(const CalibrationData& calibrationData, std::atomic<uint64_t>* frameSignal = nullptr, CaptureSource* sharedSource = nullptr);
         ~Memory();
 
         void saveBitmapToFile(HBITMAP hBitmap, int width, int height, const std::string& filename);
 
         // Public methods
-        int getCapturedValue(const std::string& key) const;
+        // Throw on an unknown offset or before the first frame; for callers outside the tick
+        int getCapturedValue(std::string_view key) const;
+        int getCapturedValue(int index) const;
+        // Same lookups for the tick path: false on a miss instead of building an exception
+        bool tryGetCapturedValue(std::string_view key, int& value) const;
+        bool tryGetCapturedValue(int index, int& value) const;
+
+        // Latest decoded frame, readable without blocking the capture thread
+        const SnapshotStore& snapshots() const { return snapshotStore; }
+        const CaptureStats& captureStats() const { return stats; }
+        void collectMetrics(MetricsWriter& metrics) const;
+
+        // Blocks until a frame newer than lastSequence is published or the timeout expires
+        uint64_t waitForFrame(uint64_t lastSequence, DWORD timeoutMs) const;
+
+        // Sequence of the latest published frame, without waiting
+        uint64_t latestFrame() const { return publishedFrames.load(std::memory_order_acquire); }
+
+        const CalibrationData& calibrationData() const { return calibration; }
+
+        // Called by the CaptureSource: decodes the panels whose top-left pixels are at
+        // `panels[rate]` (BGRA, row 0 only; null for a panel not captured this frame), or
+        // records a failed grab
+        // `interest` is the region the panels were captured with, null for whole panels
+        void decodeFrame(const uint32_t* const panels[PANEL_COUNT], int64_t captureTime, const CaptureInterest* interest = nullptr);
+        void captureFailed();
+
+        // Records that a script depends on an offset. The captured-value lookups record their reads;
+        // readers of whole snapshots record the indices they resolved.
+        void noteOffsetRead(int index) const;
+
+        // Shrinks capture and decode to the offsets read so far, if any were added since the last
+        // call. Called by the script engine after each tick.
+        void updateCaptureInterest();
+
+        // Spans to capture, or null to capture and decode whole panels
+        Published<CaptureInterest>::Reader captureInterest() const { return interest.read(); }
+
+        // Strings of text offsets, replaced whenever one arrives; never null
+        Published<StringDictionary>::Reader stringDictionary() const { return dictionary.read(); }
+
+        // Also publishes every decoded frame to the shared-memory ring `name` (see FrameRing.h)
+        bool enableSharedFrames(const std::string& name);
+
+        // Keeps the last `retainedFrames` captured strips for dumpFrames() (see FrameDumper.h)
+        bool enableFrameDumps(const std::string& directory, size_t retainedFrames);
+
+        // Writes the retained strips to QOI files in the background; false if dumps are not enabled
+        bool dumpFrames(const std::string& reason);
+
+        // Appends every published frame to `recorder` as client `client` (see FlightRecorder.h)
+        void setFlightRecorder(FlightRecorder* recorder, int client);
 
  
 
         // Static member initialization
-        static std::map<std::string, OffsetMetadata> offsetIndices;
+        static OffsetSchema offsetIndices;
         /**
          * @brief Macro to define memory offsets and their getter functions using thread-safe captured values.
          *
          * This macro generates a getter function that retrieves the offset value from the
-         * thread-safe `capturedData` structure maintained by the `Memory` class.
+         * lock-free `SnapshotStore` maintained by the `Memory` class.
          */
-#define DEFINE_MEMORY_OFFSET(name, type, index) \
+#define DEFINE_MEMORY_OFFSET(name, type, index, rate, column, bit) \
     type name() const { \
-        try { \
-            return static_cast<type>(getCapturedValue(#name)); \
-        } catch (const std::exception& e) { \
-            std::cerr << "Error retrieving value for " << #name << ": " << e.what() << std::endl; \
-            return {}; /* Return default value for the type */ \
+        int value = 0; \
+        if (!tryGetCapturedValue(index, value)) { \
+            return {}; /* No frame yet: default value for the type */ \
         } \
+        return static_cast<type>(value); \
     } \
     struct __##name##_Registrar { \
         __##name##_Registrar() { \
-            Memory::offsetIndices[#name] = {index, #type}; \
+            Memory::offsetIndices[#name] = {index, #type, OffsetRate::rate, column, bit}; \
         } \
     } __##name##_registrar_instance;
 #include "Offsets.h" // Include offset definitions
@@ -60,19 +204,71 @@
         // Private methods
         Color getPixelColor(int x, int y) const;
         std::pair<int, int> calculatePixelCoordinates(const std::string& key) const;
-        RECT calculateBoundingBox() const; // Ensure this matches implementation
-        void captureOffsets();
+        RECT calculateBoundingBox(OffsetRate rate) const; // Ensure this matches implementation
+        // Offsets describing the frame itself, decoded whatever scripts read
+        bool isFrameMetadata(int index) const;
+        // Offsets of the dictionary mailbox, also decoded whatever scripts read
+        bool isMailbox(int index) const;
+        void readMailbox(const int* values);
+        void recordLatency(int gameTimeMs, int64_t captureTime);
 
         // Helper template for decoding RGB to value
         template <typename T>
         T decodeRGBToValue(const Color& color, const std::string& type) const;
 
+        // Pixel column of one offset within the strip
+        struct StripColumn {
+            int index;
+            int x;
+            int bit;                    // Bit of a packed bool, -1 for a whole-pixel value
+            int group;                  // Check group (index into OFFSET_CHECK_GROUPS), -1 if none
+            const std::string* key;
+            const std::string* type;
+        };
+
+        // Pixels of one entry of OFFSET_CHECK_GROUPS within its strip
+        struct CheckGroup {
+            std::vector<int> xs;        // Pixels covered by the check
+            int checkX;                 // Check pixel
+        };
+
+        // Compares each group's check pixel with the XOR of its pixels; false marks a corrupted group
+        void verifyGroups(const uint32_t* strip, int panel, const std::vector<int>* groups, bool valid[]);
+
         // Member variables
         CalibrationData calibration;
-        mutable std::mutex threadMutex;
-        std::unordered_map<std::string, int> capturedData;
-        bool stopThread;
-        std::thread captureThread;
+        std::vector<StripColumn> columns[PANEL_COUNT]; // Offsets of each panel in decode order, positions precomputed
+        CheckGroup checkGroups[OFFSET_CHECK_GROUP_COUNT];
+        int frameValues[OFFSET_COUNT] = {};         // Last decoded values; a failed decode keeps the previous one
+        int tickCounterIndex = -1;                  // Index of the TickCounter offset, -1 if not declared
+        int tickCounterTailIndex = -1;              // Index of TickCounterTail, -1 if not declared
+        int gameTimeIndex = -1;                     // Index of GameTime, -1 if not declared
+        int generationIndex = -1;                   // Index of DictionaryGeneration, -1 if not declared
+        int mailboxHeaderIndex = -1;                // Index of MailboxHeader, -1 if not declared
+        std::vector<int> mailboxDataIndices;        // MailboxData_1, _2, ... in order
+        std::map<int, std::map<int, std::string>> pendingStrings; // Chunks by id and chunk, until complete
+        int layoutHashX = -1;                       // Column of the LayoutHash pixel in the fast strip, -1 if not declared
+        bool layoutMismatchReported = false;
+        int lastTickCounter = -1;                   // TickCounter of the last published frame
+        int64_t latencyWindowMinUs[2] = { -1, -1 }; // Smallest capture-minus-game time of the previous and current window, -1 if none
+        uint64_t latencyWindowFrames = 0;           // Stamped frames in the current window
+        SnapshotStore snapshotStore;
+        std::atomic<uint64_t> publishedFrames{ 0 }; // Mirrors snapshotStore.sequence() as a wait address
+        std::atomic<uint64_t>* frameSignal;         // Shared wait address of a multi-client runtime, or null
+        CaptureStats stats;
+        mutable std::atomic<uint64_t> offsetsRead[(OFFSET_COUNT + 63) / 64] = {}; // One bit per offset index
+        mutable std::atomic<bool> offsetsReadChanged{ false };
+        Published<CaptureInterest> interest;        // Written by the script engine, read by the capture thread
+        Published<StringDictionary> dictionary;     // Written by the decoding thread, read by the script engine
+        std::unique_ptr<FramePublisher> sharedFrames;
+        std::atomic<FramePublisher*> publisher{ nullptr }; // sharedFrames once it is ready, read by the capture thread
+        int panelWidths[PANEL_COUNT] = {};          // Captured pixels per panel row
+        std::unique_ptr<FrameDumper> frameDumps;
+        std::atomic<FrameDumper*> dumper{ nullptr };  // frameDumps once it is ready, read by the capture thread
+        std::atomic<FlightRecorder*> flightRecorder{ nullptr }; // Read by the capture thread
+        int flightClient = 0;                       // Client id of the recorded frames
+        std::unique_ptr<CaptureSource> ownSource;   // Capture thread when no shared source was given
+        CaptureSource* source;
     };
 
     #endif // MEMORY_H
@@ -0,0 +1,330 @@
+/**
+ * @file MetricsServer.cpp
+ * @brief Implementation of the Unix domain socket metrics and query server.
+ *
+ * Windows 10 (1803+) supports AF_UNIX stream sockets through Winsock, which lets local tools
+ * (curl --unix-socket, socat, a Prometheus sidecar) read the bot's state without a TCP port.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <winsock2.h>
+#include <afunix.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "MetricsServer.h"
+#include "Util.h"
+
+#pragma comment(lib, "Ws2_32.lib")
+
+void MetricsWriter::counter(const std::string& name, const std::string& help, double value, const std::string& labels) {
+    add("counter", name, help, value, labels);
+}
+
+void MetricsWriter::gauge(const std::string& name, const std::string& help, double value, const std::string& labels) {
+    add("gauge", name, help, value, labels);
+}
+
+void MetricsWriter::add(const std::string& type, const std::string& name, const std::string& help, double value, const std::string& labels) {
+    Family& family = families[name];
+    family.type = type;
+    family.help = help;
+
+    std::ostringstream sample;
+    sample << std::setprecision(15) << name;
+    if (!commonLabels.empty() && !labels.empty()) {
+        sample << "{" << commonLabels << "," << labels << "}";
+    }
+    else if (!commonLabels.empty() || !labels.empty()) {
+        sample << "{" << commonLabels << labels << "}";
+    }
+    sample << " " << value;
+    family.samples.push_back(sample.str());
+}
+
+std::string MetricsWriter::render() const {
+    std::ostringstream out;
+    for (const auto& [name, family] : families) {
+        out << "# HELP " << name << " " << family.help << "\n";
+        out << "# TYPE " << name << " " << family.type << "\n";
+        for (const auto& sample : family.samples) {
+            out << sample << "\n";
+        }
+    }
+    return out.str();
+}
+
+// Constructor
+MetricsServer::MetricsServer(const std::string& socketPath, std::vector<Memory*> clientMemories)
+    : path(socketPath), memories(std::move(clientMemories)), running(false), listenSocket(INVALID_SOCKET) {}
+
+// Destructor
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::addCollector(Collector collector) {
+    collectors.push_back(std::move(collector));
+}
+
+void MetricsServer::addCommand(const std::string& verb, Command command) {
+    commands[verb] = std::move(command);
+}
+
+bool MetricsServer::start() {
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "Error: WSAStartup failed for metrics server.\n";
+        return false;
+    }
+
+    SOCKET sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET) {
+        std::cerr << "Error: Unable to create metrics socket (" << WSAGetLastError() << ").\n";
+        WSACleanup();
+        return false;
+    }
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Metrics socket path is too long: " << path << "\n";
+        closesocket(sock);
+        WSACleanup();
+        return false;
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    // A stale socket file from a previous run would make bind fail
+    std::remove(path.c_str());
+
+    if (bind(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR ||
+        listen(sock, SOMAXCONN) == SOCKET_ERROR) {
+        std::cerr << "Error: Unable to listen on metrics socket " << path << " (" << WSAGetLastError() << ").\n";
+        closesocket(sock);
+        WSACleanup();
+        return false;
+    }
+
+    listenSocket = sock;
+    running = true;
+    serverThread = std::thread(&MetricsServer::serve, this);
+    std::cout << "Metrics server listening on " << path << "\n";
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    // The server thread notices within one poll interval and closes its connections
+    if (serverThread.joinable()) {
+        serverThread.join();
+    }
+    closesocket(static_cast<SOCKET>(listenSocket));
+    listenSocket = INVALID_SOCKET;
+    std::remove(path.c_str());
+    WSACleanup();
+}
+
+void MetricsServer::serve() {
+    std::vector<Connection> connections;
+    std::vector<WSAPOLLFD> polled;
+
+    while (running) {
+        polled.clear();
+        polled.push_back({ static_cast<SOCKET>(listenSocket), POLLRDNORM, 0 });
+        for (const Connection& connection : connections) {
+            polled.push_back({ static_cast<SOCKET>(connection.socket), POLLRDNORM, 0 });
+        }
+        if (WSAPoll(polled.data(), static_cast<ULONG>(polled.size()), POLL_INTERVAL_MS) == SOCKET_ERROR) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+            continue;
+        }
+
+        // Serve the clients that sent something, close the ones that hung up or went quiet
+        int64_t now = monotonicNanos();
+        size_t kept = 0;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            Connection& connection = connections[i];
+            short events = polled[i + 1].revents;
+            bool open = true;
+            if (events & (POLLRDNORM | POLLHUP | POLLERR | POLLNVAL)) {
+                connection.lastActiveNs = now;
+                open = serveConnection(connection);
+            }
+            else if (now - connection.lastActiveNs > IDLE_TIMEOUT_MS * 1000000) {
+                open = false;
+            }
+            if (!open) {
+                closesocket(static_cast<SOCKET>(connection.socket));
+                continue;
+            }
+            if (kept != i) {
+                connections[kept] = std::move(connection);
+            }
+            ++kept;
+        }
+        connections.resize(kept);
+
+        if (polled[0].revents & POLLRDNORM) {
+            SOCKET client = accept(static_cast<SOCKET>(listenSocket), nullptr, nullptr);
+            if (client != INVALID_SOCKET && connections.size() < MAX_CONNECTIONS) {
+                connections.push_back({ static_cast<uintptr_t>(client), std::string(), now });
+            }
+            else if (client != INVALID_SOCKET) {
+                closesocket(client);
+            }
+        }
+    }
+
+    for (const Connection& connection : connections) {
+        closesocket(static_cast<SOCKET>(connection.socket));
+    }
+}
+
+/**
+ * @brief Reads what a readable connection sent and answers every complete line.
+ * @return False once the connection should be closed.
+ */
+bool MetricsServer::serveConnection(Connection& connection) {
+    SOCKET sock = static_cast<SOCKET>(connection.socket);
+    std::string& pending = connection.pending;
+    char buffer[512];
+
+    int received = recv(sock, buffer, sizeof(buffer), 0);
+    if (received <= 0) {
+        return false;
+    }
+    pending.append(buffer, received);
+
+    size_t newline;
+    while ((newline = pending.find('\n')) != std::string::npos) {
+        std::string line = pending.substr(0, newline);
+        pending.erase(0, newline + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        // HTTP scrapers send a single request and expect the connection to close
+        bool isHttp = line.rfind("GET ", 0) == 0;
+        std::string response;
+        if (isHttp) {
+            bool found = line.rfind("GET /metrics", 0) == 0;
+            std::string body = found ? renderMetrics() : "not found\n";
+            response = std::string(found ? "HTTP/1.0 200 OK" : "HTTP/1.0 404 Not Found") +
+                "\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + std::to_string(body.size()) +
+                "\r\nConnection: close\r\n\r\n" + body;
+        }
+        else {
+            response = handleCommand(line);
+        }
+
+        const char* data = response.data();
+        int remaining = static_cast<int>(response.size());
+        while (remaining > 0) {
+            int sent = send(sock, data, remaining, 0);
+            if (sent <= 0) {
+                return false;
+            }
+            data += sent;
+            remaining -= sent;
+        }
+
+        if (isHttp) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string MetricsServer::handleCommand(const std::string& line) {
+    std::istringstream command(line);
+    std::string verb;
+    command >> verb;
+
+    if (verb == "metrics") {
+        return renderMetrics();
+    }
+
+    if (verb == "get" || verb == "offsets") {
+        std::string arguments;
+        std::getline(command >> std::ws, arguments);
+        size_t client = takeClient(arguments, verb == "get" ? 1 : 0);
+        if (client >= memories.size()) {
+            return "ERR no client " + std::to_string(client) + "\n";
+        }
+        // Read the snapshot store directly: getCapturedValue would record the offsets as read by a
+        // script and keep them in the captured strip
+        const SnapshotStore& snapshots = memories[client]->snapshots();
+        return verb == "get" ? getOffset(snapshots, arguments) : listOffsets(snapshots);
+    }
+
+    auto registered = commands.find(verb);
+    if (registered != commands.end()) {
+        std::string arguments;
+        std::getline(command >> std::ws, arguments);
+        return registered->second(arguments);
+    }
+
+    return "ERR unknown command: " + verb + " (expected metrics, get <Offset> [client] or offsets [client])\n";
+}
+
+std::string MetricsServer::getOffset(const SnapshotStore& snapshots, const std::string& key) {
+    auto it = Memory::offsetIndices.find(key);
+    if (it == Memory::offsetIndices.end() || snapshots.sequence() == 0) {
+        return "ERR Captured value not found for key: " + key + "\n";
+    }
+    return key + " " + std::to_string(snapshots.value(it->second.index)) + "\n";
+}
+
+std::string MetricsServer::listOffsets(const SnapshotStore& snapshots) {
+    bool captured = snapshots.sequence() != 0;
+    std::ostringstream out;
+    for (const auto& [key, metadata] : Memory::offsetIndices) {
+        out << key << " " << metadata.index << " " << metadata.type << " ";
+        if (captured) {
+            out << snapshots.value(metadata.index) << "\n";
+        }
+        else {
+            out << "-\n";
+        }
+    }
+    return out.str();
+}
+
+size_t MetricsServer::takeClient(std::string& arguments, size_t keptWords) {
+    std::istringstream in(arguments);
+    std::vector<std::string> words;
+    for (std::string word; in >> word;) {
+        words.push_back(word);
+    }
+    size_t client = 0;
+    if (words.size() > keptWords && words.back().size() <= 9
+        && words.back().find_first_not_of("0123456789") == std::string::npos) {
+        client = std::stoul(words.back());
+        words.pop_back();
+    }
+    arguments.clear();
+    for (const std::string& word : words) {
+        arguments += (arguments.empty() ? "" : " ") + word;
+    }
+    return client;
+}
+
+std::string MetricsServer::renderMetrics() {
+    MetricsWriter writer;
+    for (const auto& collector : collectors) {
+        collector(writer);
+    }
+    return writer.render();
+}
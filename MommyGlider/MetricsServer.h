@@ -0,0 +1,162 @@
+/**
+ * @file MetricsServer.h
+ * @brief Optional local introspection endpoint serving Prometheus-style metrics over a Unix domain socket.
+ *
+ * Components expose their counters through collectors; the server renders them on request from
+ * its own thread. Counters are plain atomics owned by each component, so serving a request never
+ * takes a lock on the capture thread or the Lua thread.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Memory.h"
+
+/**
+ * @class MetricsWriter
+ * @brief Accumulates samples and renders them in the Prometheus text exposition format.
+ *
+ * Samples of the same metric are grouped under a single HELP/TYPE header, so several
+ * collectors may report into the same family.
+ */
+class MetricsWriter {
+public:
+    /**
+     * @brief Adds a monotonically increasing sample.
+     * @param name Metric name, including the `_total` suffix.
+     * @param help One-line description.
+     * @param value Sample value.
+     * @param labels Optional label set without braces, e.g. `binding="UnitHealth"`.
+     */
+    void counter(const std::string& name, const std::string& help, double value, const std::string& labels = "");
+
+    /**
+     * @brief Adds a sample that can go up and down.
+     */
+    void gauge(const std::string& name, const std::string& help, double value, const std::string& labels = "");
+
+    /**
+     * @brief Sets labels added to every following sample, e.g. `client="1"`; empty to clear.
+     */
+    void setCommonLabels(const std::string& labels) { commonLabels = labels; }
+
+    /**
+     * @brief Renders every family collected so far.
+     */
+    std::string render() const;
+
+private:
+    struct Family {
+        std::string type;
+        std::string help;
+        std::vector<std::string> samples;
+    };
+
+    void add(const std::string& type, const std::string& name, const std::string& help, double value, const std::string& labels);
+
+    std::map<std::string, Family> families;
+    std::string commonLabels;
+};
+
+/**
+ * @class MetricsServer
+ * @brief Background server answering metrics and offset queries on a Unix domain socket.
+ *
+ * Several clients can stay connected at once; the server thread polls them all and closes any that
+ * stay idle for IDLE_TIMEOUT_MS. Protocol (one command per line):
+ *  - `metrics`                 Prometheus text exposition.
+ *  - `get <Offset> [client]`  Latest decoded value of an Offsets.h entry.
+ *  - `offsets [client]`       Every offset with its index, type and latest value.
+ *  - `<verb> ...`              Commands registered with addCommand(), e.g. `profile start`.
+ * The client is an index into the runtime's clients and defaults to 0.
+ *  - `GET /metrics HTTP/1.1` is also accepted so HTTP scrapers can be pointed at the socket.
+ */
+class MetricsServer {
+public:
+    using Collector = std::function<void(MetricsWriter&)>;
+    using Command = std::function<std::string(const std::string& arguments)>;
+
+    /**
+     * @brief Creates a stopped server.
+     * @param socketPath Filesystem path of the socket to create.
+     * @param clientMemories Memory of every client, answering offset queries by client index.
+     */
+    MetricsServer(const std::string& socketPath, std::vector<Memory*> clientMemories);
+
+    /**
+     * @brief Stops the server and removes the socket file.
+     */
+    ~MetricsServer();
+
+    /**
+     * @brief Registers a metrics source. Must be called before start().
+     */
+    void addCollector(Collector collector);
+
+    /**
+     * @brief Registers a command answered on the server thread. Must be called before start().
+     * @param verb First word of the command line.
+     * @param command Receives the rest of the line and returns the response.
+     */
+    void addCommand(const std::string& verb, Command command);
+
+    /**
+     * @brief Binds the socket and starts the server thread.
+     * @return False if the socket could not be created.
+     */
+    bool start();
+
+    /**
+     * @brief Closes the socket and joins the server thread.
+     */
+    void stop();
+
+    /**
+     * @brief Splits a trailing client index off a command's arguments, for registered commands
+     *        that address one client.
+     * @param arguments Command arguments; a trailing number is removed and the rest is
+     *        normalized to single spaces.
+     * @param keptWords Words the command itself takes before a client index may follow, so
+     *        `start 500` with 2 kept words stays a profiler rate.
+     * @return The client index, 0 if none was given.
+     */
+    static size_t takeClient(std::string& arguments, size_t keptWords = 0);
+
+    static constexpr int POLL_INTERVAL_MS = 200;        ///< How often the server thread checks for stop()
+    static constexpr int64_t IDLE_TIMEOUT_MS = 60000;   ///< Connections silent this long are closed
+    static constexpr size_t MAX_CONNECTIONS = 32;       ///< Further clients are refused
+
+private:
+    struct Connection {
+        uintptr_t socket;
+        std::string pending;    ///< Received bytes not yet ending in a newline
+        int64_t lastActiveNs;   ///< monotonicNanos() of the last received data
+    };
+
+    void serve();
+    bool serveConnection(Connection& connection);
+    std::string handleCommand(const std::string& line);
+    static std::string getOffset(const SnapshotStore& snapshots, const std::string& key);
+    static std::string listOffsets(const SnapshotStore& snapshots);
+    std::string renderMetrics();
+
+    std::string path;
+    std::vector<Memory*> memories;
+    std::vector<Collector> collectors;
+    std::map<std::string, Command> commands;
+    std::atomic<bool> running;
+    uintptr_t listenSocket;
+    std::thread serverThread;
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,38 @@
+/**
+ * @file OffsetLayout.h
+ * @brief Hash and check groups of the offset layout in Offsets.h.
+ *
+ * The hash is painted by the addon as the LayoutHash offset. Each check group is a run of pixels
+ * followed by a check pixel holding the XOR of their colors and OFFSET_CHECK_SEED.
+ *
+ * Generated by GenerateOffsets.lua from Offsets.schema.lua. Do not edit.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef OFFSETLAYOUT_H
+#define OFFSETLAYOUT_H
+
+#include <cstdint>
+
+constexpr uint32_t OFFSET_LAYOUT_HASH = 0x2FCD76;
+constexpr uint32_t OFFSET_CHECK_SEED = 0x5AA55A;
+
+struct OffsetCheckGroup {
+    int panel;          // Panel of the group, indexed like OffsetRate
+    int firstColumn;    // First pixel of the group
+    int checkColumn;    // Check pixel, right after the group's last pixel
+};
+
+constexpr OffsetCheckGroup OFFSET_CHECK_GROUPS[] = {
+    { 0, 0, 16 },
+    { 0, 17, 33 },
+    { 0, 34, 50 },
+    { 0, 51, 67 },
+    { 0, 68, 80 },
+    { 1, 1, 17 },
+};
+constexpr int OFFSET_CHECK_GROUP_COUNT = static_cast<int>(sizeof(OFFSET_CHECK_GROUPS) / sizeof(OFFSET_CHECK_GROUPS[0]));
+
+#endif // OFFSETLAYOUT_H
@@ -1,151 +1,168 @@
-DEFINE_MEMORY_OFFSET(Calibration, int, 0);
-DEFINE_MEMORY_OFFSET(UnitPosition__player_1, int, 1);
-DEFINE_MEMORY_OFFSET(UnitPosition__player_2, int, 2);
-DEFINE_MEMORY_OFFSET(UnitPosition__player_3, int, 3);
-DEFINE_MEMORY_OFFSET(UnitCastingInfo__player, bool, 4);
-DEFINE_MEMORY_OFFSET(UnitChannelInfo__player, bool, 5);
-DEFINE_MEMORY_OFFSET(UnitCastingInfo__target, bool, 6);
-DEFINE_MEMORY_OFFSET(UnitChannelInfo__target, bool, 7);
-DEFINE_MEMORY_OFFSET(UnitCastingInfo__focus, bool, 8);
-DEFINE_MEMORY_OFFSET(UnitChannelInfo__focus, bool, 9);
-DEFINE_MEMORY_OFFSET(UnitPower__player, int, 10);
-DEFINE_MEMORY_OFFSET(UnitPowerMax__player, int, 11);
-DEFINE_MEMORY_OFFSET(UnitPower__player_0, int, 12);
-DEFINE_MEMORY_OFFSET(UnitPower__player_1, int, 13);
-DEFINE_MEMORY_OFFSET(IsPlayerMoving, bool, 14);
-DEFINE_MEMORY_OFFSET(IsResting, bool, 15);
-DEFINE_MEMORY_OFFSET(GetNumQuestLogEntries, int, 16);
-DEFINE_MEMORY_OFFSET(GetQuestLogCompletionText__3, bool, 17);
-DEFINE_MEMORY_OFFSET(UnitXP__player, int, 18);
-DEFINE_MEMORY_OFFSET(UnitXPMax__player, int, 19);
-DEFINE_MEMORY_OFFSET(GetXPExhaustion, int, 20);
-DEFINE_MEMORY_OFFSET(IsSwimming, bool, 21);
-DEFINE_MEMORY_OFFSET(IsFalling, bool, 22);
-DEFINE_MEMORY_OFFSET(GetMoney, int, 23);
-DEFINE_MEMORY_OFFSET(GetNumLootItems, int, 24);
-DEFINE_MEMORY_OFFSET(LootFrame_IsShown, bool, 25);
-DEFINE_MEMORY_OFFSET(IsControlKeyDown, bool, 26);
-DEFINE_MEMORY_OFFSET(UnitIsPlayer__target, bool, 27);
-DEFINE_MEMORY_OFFSET(UnitHealth__player, int, 28);
-DEFINE_MEMORY_OFFSET(UnitHealthMax__player, int, 29);
-DEFINE_MEMORY_OFFSET(UnitExists__player, bool, 30);
-DEFINE_MEMORY_OFFSET(UnitAffectingCombat__player, bool, 31);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_player, int, 32);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_target, int, 33);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_party1, int, 34);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_party2, int, 35);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_party3, int, 36);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_party4, int, 37);
-DEFINE_MEMORY_OFFSET(UnitBuff__player_PowerWordShield, bool, 38);
-DEFINE_MEMORY_OFFSET(UnitBuff__player_PowerWordFortitude, bool, 39);
-DEFINE_MEMORY_OFFSET(UnitBuff__player_Renew, bool, 40);
-DEFINE_MEMORY_OFFSET(UnitDebuff__player_ShadowWordPain, bool, 41);
-DEFINE_MEMORY_OFFSET(UnitDebuff__player_WeakenedSoul, bool, 42);
-DEFINE_MEMORY_OFFSET(UnitHealth__target, int, 43);
-DEFINE_MEMORY_OFFSET(UnitHealthMax__target, int, 44);
-DEFINE_MEMORY_OFFSET(UnitExists__target, bool, 45);
-DEFINE_MEMORY_OFFSET(UnitAffectingCombat__target, bool, 46);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_player, int, 47);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_target, int, 48);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_party1, int, 49);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_party2, int, 50);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_party3, int, 51);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_party4, int, 52);
-DEFINE_MEMORY_OFFSET(UnitBuff__target_PowerWordShield, bool, 53);
-DEFINE_MEMORY_OFFSET(UnitBuff__target_PowerWordFortitude, bool, 54);
-DEFINE_MEMORY_OFFSET(UnitBuff__target_Renew, bool, 55);
-DEFINE_MEMORY_OFFSET(UnitDebuff__target_ShadowWordPain, bool, 56);
-DEFINE_MEMORY_OFFSET(UnitDebuff__target_WeakenedSoul, bool, 57);
-DEFINE_MEMORY_OFFSET(UnitHealth__party1, int, 58);
-DEFINE_MEMORY_OFFSET(UnitHealthMax__party1, int, 59);
-DEFINE_MEMORY_OFFSET(UnitExists__party1, bool, 60);
-DEFINE_MEMORY_OFFSET(UnitAffectingCombat__party1, bool, 61);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_player, int, 62);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_target, int, 63);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_party1, int, 64);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_party2, int, 65);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_party3, int, 66);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_party4, int, 67);
-DEFINE_MEMORY_OFFSET(UnitBuff__party1_PowerWordShield, bool, 68);
-DEFINE_MEMORY_OFFSET(UnitBuff__party1_PowerWordFortitude, bool, 69);
-DEFINE_MEMORY_OFFSET(UnitBuff__party1_Renew, bool, 70);
-DEFINE_MEMORY_OFFSET(UnitDebuff__party1_ShadowWordPain, bool, 71);
-DEFINE_MEMORY_OFFSET(UnitDebuff__party1_WeakenedSoul, bool, 72);
-DEFINE_MEMORY_OFFSET(UnitHealth__party2, int, 73);
-DEFINE_MEMORY_OFFSET(UnitHealthMax__party2, int, 74);
-DEFINE_MEMORY_OFFSET(UnitExists__party2, bool, 75);
-DEFINE_MEMORY_OFFSET(UnitAffectingCombat__party2, bool, 76);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_player, int, 77);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_target, int, 78);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_party1, int, 79);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_party2, int, 80);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_party3, int, 81);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_party4, int, 82);
-DEFINE_MEMORY_OFFSET(UnitBuff__party2_PowerWordShield, bool, 83);
-DEFINE_MEMORY_OFFSET(UnitBuff__party2_PowerWordFortitude, bool, 84);
-DEFINE_MEMORY_OFFSET(UnitBuff__party2_Renew, bool, 85);
-DEFINE_MEMORY_OFFSET(UnitDebuff__party2_ShadowWordPain, bool, 86);
-DEFINE_MEMORY_OFFSET(UnitDebuff__party2_WeakenedSoul, bool, 87);
-DEFINE_MEMORY_OFFSET(UnitHealth__party3, int, 88);
-DEFINE_MEMORY_OFFSET(UnitHealthMax__party3, int, 89);
-DEFINE_MEMORY_OFFSET(UnitExists__party3, bool, 90);
-DEFINE_MEMORY_OFFSET(UnitAffectingCombat__party3, bool, 91);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_player, int, 92);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_target, int, 93);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_party1, int, 94);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_party2, int, 95);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_party3, int, 96);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_party4, int, 97);
-DEFINE_MEMORY_OFFSET(UnitBuff__party3_PowerWordShield, bool, 98);
-DEFINE_MEMORY_OFFSET(UnitBuff__party3_PowerWordFortitude, bool, 99);
-DEFINE_MEMORY_OFFSET(UnitBuff__party3_Renew, bool, 100);
-DEFINE_MEMORY_OFFSET(UnitDebuff__party3_ShadowWordPain, bool, 101);
-DEFINE_MEMORY_OFFSET(UnitDebuff__party3_WeakenedSoul, bool, 102);
-DEFINE_MEMORY_OFFSET(UnitHealth__party4, int, 103);
-DEFINE_MEMORY_OFFSET(UnitHealthMax__party4, int, 104);
-DEFINE_MEMORY_OFFSET(UnitExists__party4, bool, 105);
-DEFINE_MEMORY_OFFSET(UnitAffectingCombat__party4, bool, 106);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_player, int, 107);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_target, int, 108);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_party1, int, 109);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_party2, int, 110);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_party3, int, 111);
-DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_party4, int, 112);
-DEFINE_MEMORY_OFFSET(UnitBuff__party4_PowerWordShield, bool, 113);
-DEFINE_MEMORY_OFFSET(UnitBuff__party4_PowerWordFortitude, bool, 114);
-DEFINE_MEMORY_OFFSET(UnitBuff__party4_Renew, bool, 115);
-DEFINE_MEMORY_OFFSET(UnitDebuff__party4_ShadowWordPain, bool, 116);
-DEFINE_MEMORY_OFFSET(UnitDebuff__party4_WeakenedSoul, bool, 117);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__PowerWordShield, int, 118);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__PowerWordShield, bool, 119);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__PowerWordShield, bool, 120);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__MindBlast, int, 121);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__MindBlast, bool, 122);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__MindBlast, bool, 123);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__Renew, int, 124);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__Renew, bool, 125);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__Renew, bool, 126);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__Heal, int, 127);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__Heal, bool, 128);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__Heal, bool, 129);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__Smite, int, 130);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__Smite, bool, 131);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__Smite, bool, 132);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__ShadowWordPain, int, 133);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__ShadowWordPain, bool, 134);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__ShadowWordPain, bool, 135);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__PowerWordFortitude, int, 136);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__PowerWordFortitude, bool, 137);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__PowerWordFortitude, bool, 138);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__LesserHeal, int, 139);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__LesserHeal, bool, 140);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__LesserHeal, bool, 141);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__Shoot, int, 142);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__Shoot, bool, 143);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__Shoot, bool, 144);
-DEFINE_MEMORY_OFFSET(GetSpellCooldown__Attack, int, 145);
-DEFINE_MEMORY_OFFSET(IsSpellKnown__Attack, bool, 146);
-DEFINE_MEMORY_OFFSET(IsSpellInRange__Attack, bool, 147);
-DEFINE_MEMORY_OFFSET(UnitBuff__player_Drink, bool, 148);
-DEFINE_MEMORY_OFFSET(UnitBuff__player_Food, bool, 149);
-DEFINE_MEMORY_OFFSET(HasWandEquipped, bool, 150);
\ No newline at end of file
+// Generated by GenerateOffsets.lua from Offsets.schema.lua. Do not edit.
+DEFINE_MEMORY_OFFSET(Calibration, int, 0, Fast, 0, -1);
+DEFINE_MEMORY_OFFSET(UnitPosition__player_1, int, 1, Fast, 23, -1);
+DEFINE_MEMORY_OFFSET(UnitPosition__player_2, int, 2, Fast, 24, -1);
+DEFINE_MEMORY_OFFSET(UnitPosition__player_3, int, 3, Fast, 25, -1);
+DEFINE_MEMORY_OFFSET(UnitCastingInfo__player, bool, 4, Fast, 3, 0);
+DEFINE_MEMORY_OFFSET(UnitChannelInfo__player, bool, 5, Fast, 3, 1);
+DEFINE_MEMORY_OFFSET(UnitCastingInfo__target, bool, 6, Fast, 3, 2);
+DEFINE_MEMORY_OFFSET(UnitChannelInfo__target, bool, 7, Fast, 3, 3);
+DEFINE_MEMORY_OFFSET(UnitCastingInfo__focus, bool, 8, Fast, 3, 5);
+DEFINE_MEMORY_OFFSET(UnitChannelInfo__focus, bool, 9, Fast, 3, 6);
+DEFINE_MEMORY_OFFSET(UnitPower__player, int, 10, Fast, 4, -1);
+DEFINE_MEMORY_OFFSET(UnitPowerMax__player, int, 11, Slow, 8, -1);
+DEFINE_MEMORY_OFFSET(UnitPower__player_0, int, 12, Fast, 26, -1);
+DEFINE_MEMORY_OFFSET(UnitPower__player_1, int, 13, Fast, 27, -1);
+DEFINE_MEMORY_OFFSET(IsPlayerMoving, bool, 14, Fast, 3, 4);
+DEFINE_MEMORY_OFFSET(IsResting, bool, 15, Slow, 2, 6);
+DEFINE_MEMORY_OFFSET(GetNumQuestLogEntries, int, 16, Slow, 11, -1);
+DEFINE_MEMORY_OFFSET(GetQuestLogCompletionText__3, bool, 17, Slow, 2, 17);
+DEFINE_MEMORY_OFFSET(UnitXP__player, int, 18, Slow, 12, -1);
+DEFINE_MEMORY_OFFSET(UnitXPMax__player, int, 19, Slow, 13, -1);
+DEFINE_MEMORY_OFFSET(GetXPExhaustion, int, 20, Slow, 14, -1);
+DEFINE_MEMORY_OFFSET(IsSwimming, bool, 21, Fast, 29, 5);
+DEFINE_MEMORY_OFFSET(IsFalling, bool, 22, Fast, 29, 6);
+DEFINE_MEMORY_OFFSET(GetMoney, int, 23, Slow, 15, -1);
+DEFINE_MEMORY_OFFSET(GetNumLootItems, int, 24, Fast, 30, -1);
+DEFINE_MEMORY_OFFSET(LootFrame_IsShown, bool, 25, Fast, 29, 7);
+DEFINE_MEMORY_OFFSET(IsControlKeyDown, bool, 26, Fast, 29, 8);
+DEFINE_MEMORY_OFFSET(UnitIsPlayer__target, bool, 27, Fast, 29, 9);
+DEFINE_MEMORY_OFFSET(UnitHealth__player, int, 28, Fast, 5, -1);
+DEFINE_MEMORY_OFFSET(UnitHealthMax__player, int, 29, Slow, 1, -1);
+DEFINE_MEMORY_OFFSET(UnitExists__player, bool, 30, Fast, 3, 7);
+DEFINE_MEMORY_OFFSET(UnitAffectingCombat__player, bool, 31, Fast, 3, 8);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_player, int, 32, Fast, 31, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_target, int, 33, Fast, 32, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_party1, int, 34, Fast, 34, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_party2, int, 35, Fast, 35, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_party3, int, 36, Fast, 36, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__player_party4, int, 37, Fast, 37, -1);
+DEFINE_MEMORY_OFFSET(UnitBuff__player_PowerWordShield, bool, 38, Fast, 3, 9);
+DEFINE_MEMORY_OFFSET(UnitBuff__player_PowerWordFortitude, bool, 39, Slow, 2, 0);
+DEFINE_MEMORY_OFFSET(UnitBuff__player_Renew, bool, 40, Fast, 3, 10);
+DEFINE_MEMORY_OFFSET(UnitDebuff__player_ShadowWordPain, bool, 41, Fast, 3, 11);
+DEFINE_MEMORY_OFFSET(UnitDebuff__player_WeakenedSoul, bool, 42, Fast, 3, 12);
+DEFINE_MEMORY_OFFSET(UnitHealth__target, int, 43, Fast, 6, -1);
+DEFINE_MEMORY_OFFSET(UnitHealthMax__target, int, 44, Slow, 3, -1);
+DEFINE_MEMORY_OFFSET(UnitExists__target, bool, 45, Fast, 3, 13);
+DEFINE_MEMORY_OFFSET(UnitAffectingCombat__target, bool, 46, Fast, 3, 14);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_player, int, 47, Fast, 38, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_target, int, 48, Fast, 39, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_party1, int, 49, Fast, 40, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_party2, int, 50, Fast, 41, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_party3, int, 51, Fast, 42, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__target_party4, int, 52, Fast, 43, -1);
+DEFINE_MEMORY_OFFSET(UnitBuff__target_PowerWordShield, bool, 53, Fast, 3, 15);
+DEFINE_MEMORY_OFFSET(UnitBuff__target_PowerWordFortitude, bool, 54, Slow, 2, 1);
+DEFINE_MEMORY_OFFSET(UnitBuff__target_Renew, bool, 55, Fast, 3, 16);
+DEFINE_MEMORY_OFFSET(UnitDebuff__target_ShadowWordPain, bool, 56, Fast, 3, 17);
+DEFINE_MEMORY_OFFSET(UnitDebuff__target_WeakenedSoul, bool, 57, Fast, 3, 18);
+DEFINE_MEMORY_OFFSET(UnitHealth__party1, int, 58, Fast, 7, -1);
+DEFINE_MEMORY_OFFSET(UnitHealthMax__party1, int, 59, Slow, 4, -1);
+DEFINE_MEMORY_OFFSET(UnitExists__party1, bool, 60, Fast, 3, 19);
+DEFINE_MEMORY_OFFSET(UnitAffectingCombat__party1, bool, 61, Fast, 3, 20);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_player, int, 62, Fast, 44, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_target, int, 63, Fast, 45, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_party1, int, 64, Fast, 46, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_party2, int, 65, Fast, 47, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_party3, int, 66, Fast, 48, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party1_party4, int, 67, Fast, 49, -1);
+DEFINE_MEMORY_OFFSET(UnitBuff__party1_PowerWordShield, bool, 68, Fast, 3, 21);
+DEFINE_MEMORY_OFFSET(UnitBuff__party1_PowerWordFortitude, bool, 69, Slow, 2, 2);
+DEFINE_MEMORY_OFFSET(UnitBuff__party1_Renew, bool, 70, Fast, 3, 22);
+DEFINE_MEMORY_OFFSET(UnitDebuff__party1_ShadowWordPain, bool, 71, Fast, 3, 23);
+DEFINE_MEMORY_OFFSET(UnitDebuff__party1_WeakenedSoul, bool, 72, Fast, 28, 0);
+DEFINE_MEMORY_OFFSET(UnitHealth__party2, int, 73, Fast, 8, -1);
+DEFINE_MEMORY_OFFSET(UnitHealthMax__party2, int, 74, Slow, 5, -1);
+DEFINE_MEMORY_OFFSET(UnitExists__party2, bool, 75, Fast, 28, 1);
+DEFINE_MEMORY_OFFSET(UnitAffectingCombat__party2, bool, 76, Fast, 28, 2);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_player, int, 77, Fast, 51, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_target, int, 78, Fast, 52, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_party1, int, 79, Fast, 53, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_party2, int, 80, Fast, 54, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_party3, int, 81, Fast, 55, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party2_party4, int, 82, Fast, 56, -1);
+DEFINE_MEMORY_OFFSET(UnitBuff__party2_PowerWordShield, bool, 83, Fast, 28, 3);
+DEFINE_MEMORY_OFFSET(UnitBuff__party2_PowerWordFortitude, bool, 84, Slow, 2, 3);
+DEFINE_MEMORY_OFFSET(UnitBuff__party2_Renew, bool, 85, Fast, 28, 4);
+DEFINE_MEMORY_OFFSET(UnitDebuff__party2_ShadowWordPain, bool, 86, Fast, 28, 5);
+DEFINE_MEMORY_OFFSET(UnitDebuff__party2_WeakenedSoul, bool, 87, Fast, 28, 6);
+DEFINE_MEMORY_OFFSET(UnitHealth__party3, int, 88, Fast, 9, -1);
+DEFINE_MEMORY_OFFSET(UnitHealthMax__party3, int, 89, Slow, 6, -1);
+DEFINE_MEMORY_OFFSET(UnitExists__party3, bool, 90, Fast, 28, 7);
+DEFINE_MEMORY_OFFSET(UnitAffectingCombat__party3, bool, 91, Fast, 28, 8);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_player, int, 92, Fast, 57, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_target, int, 93, Fast, 58, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_party1, int, 94, Fast, 59, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_party2, int, 95, Fast, 60, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_party3, int, 96, Fast, 61, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party3_party4, int, 97, Fast, 62, -1);
+DEFINE_MEMORY_OFFSET(UnitBuff__party3_PowerWordShield, bool, 98, Fast, 28, 9);
+DEFINE_MEMORY_OFFSET(UnitBuff__party3_PowerWordFortitude, bool, 99, Slow, 2, 4);
+DEFINE_MEMORY_OFFSET(UnitBuff__party3_Renew, bool, 100, Fast, 28, 10);
+DEFINE_MEMORY_OFFSET(UnitDebuff__party3_ShadowWordPain, bool, 101, Fast, 28, 11);
+DEFINE_MEMORY_OFFSET(UnitDebuff__party3_WeakenedSoul, bool, 102, Fast, 28, 12);
+DEFINE_MEMORY_OFFSET(UnitHealth__party4, int, 103, Fast, 10, -1);
+DEFINE_MEMORY_OFFSET(UnitHealthMax__party4, int, 104, Slow, 7, -1);
+DEFINE_MEMORY_OFFSET(UnitExists__party4, bool, 105, Fast, 28, 13);
+DEFINE_MEMORY_OFFSET(UnitAffectingCombat__party4, bool, 106, Fast, 28, 14);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_player, int, 107, Fast, 63, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_target, int, 108, Fast, 64, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_party1, int, 109, Fast, 65, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_party2, int, 110, Fast, 66, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_party3, int, 111, Fast, 68, -1);
+DEFINE_MEMORY_OFFSET(UnitThreatSituation__party4_party4, int, 112, Fast, 69, -1);
+DEFINE_MEMORY_OFFSET(UnitBuff__party4_PowerWordShield, bool, 113, Fast, 28, 15);
+DEFINE_MEMORY_OFFSET(UnitBuff__party4_PowerWordFortitude, bool, 114, Slow, 2, 5);
+DEFINE_MEMORY_OFFSET(UnitBuff__party4_Renew, bool, 115, Fast, 28, 16);
+DEFINE_MEMORY_OFFSET(UnitDebuff__party4_ShadowWordPain, bool, 116, Fast, 28, 17);
+DEFINE_MEMORY_OFFSET(UnitDebuff__party4_WeakenedSoul, bool, 117, Fast, 28, 18);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__PowerWordShield, int, 118, Fast, 11, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__PowerWordShield, bool, 119, Slow, 2, 7);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__PowerWordShield, bool, 120, Fast, 28, 19);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__MindBlast, int, 121, Fast, 12, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__MindBlast, bool, 122, Slow, 2, 8);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__MindBlast, bool, 123, Fast, 28, 20);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__Renew, int, 124, Fast, 13, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__Renew, bool, 125, Slow, 2, 9);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__Renew, bool, 126, Fast, 28, 21);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__Heal, int, 127, Fast, 14, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__Heal, bool, 128, Slow, 2, 10);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__Heal, bool, 129, Fast, 28, 22);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__Smite, int, 130, Fast, 15, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__Smite, bool, 131, Slow, 2, 11);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__Smite, bool, 132, Fast, 28, 23);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__ShadowWordPain, int, 133, Fast, 17, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__ShadowWordPain, bool, 134, Slow, 2, 12);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__ShadowWordPain, bool, 135, Fast, 29, 0);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__PowerWordFortitude, int, 136, Fast, 18, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__PowerWordFortitude, bool, 137, Slow, 2, 13);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__PowerWordFortitude, bool, 138, Fast, 29, 1);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__LesserHeal, int, 139, Fast, 19, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__LesserHeal, bool, 140, Slow, 2, 14);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__LesserHeal, bool, 141, Fast, 29, 2);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__Shoot, int, 142, Fast, 20, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__Shoot, bool, 143, Slow, 2, 15);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__Shoot, bool, 144, Fast, 29, 3);
+DEFINE_MEMORY_OFFSET(GetSpellCooldown__Attack, int, 145, Fast, 21, -1);
+DEFINE_MEMORY_OFFSET(IsSpellKnown__Attack, bool, 146, Slow, 2, 16);
+DEFINE_MEMORY_OFFSET(IsSpellInRange__Attack, bool, 147, Fast, 29, 4);
+DEFINE_MEMORY_OFFSET(UnitBuff__player_Drink, bool, 148, Fast, 29, 10);
+DEFINE_MEMORY_OFFSET(UnitBuff__player_Food, bool, 149, Fast, 29, 11);
+DEFINE_MEMORY_OFFSET(HasWandEquipped, bool, 150, Slow, 2, 18);
+DEFINE_MEMORY_OFFSET(TickCounter, int, 151, Fast, 2, -1);
+DEFINE_MEMORY_OFFSET(LayoutHash, int, 152, Fast, 1, -1);
+DEFINE_MEMORY_OFFSET(TickCounterTail, int, 153, Fast, 79, -1);
+DEFINE_MEMORY_OFFSET(GameTime, int, 154, Fast, 22, -1);
+DEFINE_MEMORY_OFFSET(GetZoneText, StringId, 155, Slow, 9, -1);
+DEFINE_MEMORY_OFFSET(GetSubZoneText, StringId, 156, Slow, 10, -1);
+DEFINE_MEMORY_OFFSET(UnitName__target, StringId, 157, Fast, 70, -1);
+DEFINE_MEMORY_OFFSET(UnitName__player, StringId, 158, Slow, 16, -1);
+DEFINE_MEMORY_OFFSET(DictionaryGeneration, int, 159, Fast, 71, -1);
+DEFINE_MEMORY_OFFSET(MailboxHeader, int, 160, Fast, 72, -1);
+DEFINE_MEMORY_OFFSET(MailboxData_1, int, 161, Fast, 73, -1);
+DEFINE_MEMORY_OFFSET(MailboxData_2, int, 162, Fast, 74, -1);
+DEFINE_MEMORY_OFFSET(MailboxData_3, int, 163, Fast, 75, -1);
+DEFINE_MEMORY_OFFSET(MailboxData_4, int, 164, Fast, 76, -1);
+DEFINE_MEMORY_OFFSET(MailboxData_5, int, 165, Fast, 77, -1);
+DEFINE_MEMORY_OFFSET(MailboxData_6, int, 166, Fast, 78, -1);
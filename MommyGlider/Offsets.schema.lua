@@ -0,0 +1,136 @@
+-- Offsets.schema.lua
+-- Single source of every offset painted by the addon and decoded by Memory.
+--
+-- GenerateOffsets.lua turns this file into Offsets.h, OffsetLayout.h and the generated encoder
+-- section of Interface/aura.lua. Edit this file, never the generated outputs.
+--
+-- Each entry has:
+--   name   Offset name, the Memory getter and the Lua binding key
+--   fetch  Lua expression evaluated by the addon on every tick of its rate class
+--   codec  "int" (24-bit value in one pixel), "bool" (one bit, packed 24 to a pixel) or "string"
+--          (text, painted as its id in the addon's string dictionary and read back by Memory)
+--   rate   "Fast" (painted and captured every frame) or "Slow" (see Memory::SLOW_FRAME_INTERVAL)
+--   hot    How often scripts read it; hotter pixels are placed first in their panel
+--
+-- Entries keep their position here as their index in Offsets.h, so append new offsets at the end.
+-- Calibration, LayoutHash and TickCounter are laid out first by the generator and TickCounterTail
+-- last, whatever their hotness.
+
+local offsets = {}
+
+local function offset(name, fetch, codec, rate, hot)
+    table.insert(offsets, { name = name, fetch = fetch, codec = codec, rate = rate or "Fast", hot = hot or 1 })
+end
+
+-- Offset names only keep letters and digits of spell and aura names
+local function sanitize(name)
+    return (name:gsub("[^%w]", ""))
+end
+
+local units = { "player", "target", "party1", "party2", "party3", "party4" }
+local buffs = { "Power Word: Shield", "Power Word: Fortitude", "Renew" }
+local debuffs = { "Shadow Word: Pain", "Weakened Soul" }
+-- Buffs lasting long enough to go on the slow panel
+local longBuffs = { ["Power Word: Fortitude"] = true }
+local spells = {
+    "Power Word: Shield",
+    "Mind Blast",
+    "Renew",
+    "Heal",
+    "Smite",
+    "Shadow Word: Pain",
+    "Power Word: Fortitude",
+    "Lesser Heal",
+    "Shoot",
+    "Attack"
+}
+
+local function auraOffset(unit, auraType, auraName, rate, hot)
+    offset("Unit" .. auraType .. "__" .. unit .. "_" .. sanitize(auraName),
+        string.format("unitAuras(%q, %q)[%q] and 1 or 0", unit, auraType, auraName), "bool", rate, hot)
+end
+
+offset("Calibration", "0xFFD904", "int", "Fast", 3)
+offset("UnitPosition__player_1", 'select(1, UnitPosition("player"))', "int", "Fast", 2)
+offset("UnitPosition__player_2", 'select(2, UnitPosition("player"))', "int", "Fast", 2)
+offset("UnitPosition__player_3", 'select(3, UnitPosition("player"))', "int", "Fast", 2)
+offset("UnitCastingInfo__player", 'UnitCastingInfo("player") and 1 or 0', "bool", "Fast", 3)
+offset("UnitChannelInfo__player", 'UnitChannelInfo("player") and 1 or 0', "bool", "Fast", 3)
+offset("UnitCastingInfo__target", 'UnitCastingInfo("target") and 1 or 0', "bool", "Fast", 3)
+offset("UnitChannelInfo__target", 'UnitChannelInfo("target") and 1 or 0', "bool", "Fast", 3)
+offset("UnitCastingInfo__focus", 'UnitCastingInfo("focus") and 1 or 0', "bool", "Fast", 2)
+offset("UnitChannelInfo__focus", 'UnitChannelInfo("focus") and 1 or 0', "bool", "Fast", 2)
+offset("UnitPower__player", 'UnitPower("player")', "int", "Fast", 3)
+offset("UnitPowerMax__player", 'UnitPowerMax("player")', "int", "Slow", 1)
+offset("UnitPower__player_0", 'UnitPower("player", 0)', "int", "Fast", 2)
+offset("UnitPower__player_1", 'UnitPower("player", 1)', "int", "Fast", 2)
+offset("IsPlayerMoving", "IsPlayerMoving() and 1 or 0", "bool", "Fast", 3)
+offset("IsResting", "IsResting() and 1 or 0", "bool", "Slow", 1)
+offset("GetNumQuestLogEntries", "GetNumQuestLogEntries()", "int", "Slow", 0)
+offset("GetQuestLogCompletionText__3", "select(3, GetQuestLogCompletionText()) and 1 or 0", "bool", "Slow", 0)
+offset("UnitXP__player", 'UnitXP("player")', "int", "Slow", 0)
+offset("UnitXPMax__player", 'UnitXPMax("player")', "int", "Slow", 0)
+offset("GetXPExhaustion", "GetXPExhaustion() or 0", "int", "Slow", 0)
+offset("IsSwimming", "IsSwimming() and 1 or 0", "bool", "Fast", 1)
+offset("IsFalling", "IsFalling() and 1 or 0", "bool", "Fast", 1)
+offset("GetMoney", "GetMoney()", "int", "Slow", 0)
+offset("GetNumLootItems", "GetNumLootItems()", "int", "Fast", 1)
+offset("LootFrame_IsShown", "LootFrame:IsShown() and 1 or 0", "bool", "Fast", 1)
+offset("IsControlKeyDown", "IsControlKeyDown() and 1 or 0", "bool", "Fast", 1)
+offset("UnitIsPlayer__target", 'UnitIsPlayer("target") and 1 or 0', "bool", "Fast", 1)
+
+for _, unit in ipairs(units) do
+    offset("UnitHealth__" .. unit, string.format("UnitHealth(%q)", unit), "int", "Fast", 3)
+    offset("UnitHealthMax__" .. unit, string.format("UnitHealthMax(%q)", unit), "int", "Slow", 2)
+    offset("UnitExists__" .. unit, string.format("UnitExists(%q) and 1 or 0", unit), "bool", "Fast", 2)
+    offset("UnitAffectingCombat__" .. unit, string.format("UnitAffectingCombat(%q) and 1 or 0", unit), "bool", "Fast", 2)
+    for _, unit2 in ipairs(units) do
+        offset("UnitThreatSituation__" .. unit .. "_" .. unit2,
+            string.format("UnitThreatSituation(%q, %q) or 0", unit, unit2), "int", "Fast", 1)
+    end
+    for _, buff in ipairs(buffs) do
+        auraOffset(unit, "Buff", buff, longBuffs[buff] and "Slow" or "Fast", 2)
+    end
+    for _, debuff in ipairs(debuffs) do
+        auraOffset(unit, "Debuff", debuff, "Fast", 2)
+    end
+end
+
+-- Spell cooldowns, knowledge and range
+for _, spell in ipairs(spells) do
+    offset("GetSpellCooldown__" .. sanitize(spell), string.format("GetSpellCooldown(%q)", spell), "int", "Fast", 3)
+    offset("IsSpellKnown__" .. sanitize(spell),
+        string.format("select(7, GetSpellInfo(%q)) and IsSpellKnown(select(7, GetSpellInfo(%q))) and 1 or 0", spell, spell),
+        "bool", "Slow", 1)
+    offset("IsSpellInRange__" .. sanitize(spell), string.format("IsSpellInRange(%q) == 1 and 1 or 0", spell), "bool", "Fast", 2)
+end
+
+-- Player-specific buffs
+for _, buff in ipairs({ "Drink", "Food" }) do
+    auraOffset("player", "Buff", buff, "Fast", 1)
+end
+
+offset("HasWandEquipped", "HasWandEquipped() and 1 or 0", "bool", "Slow", 0)
+-- Bumped on every fast tick so Memory can tell a freshly painted frame from a repeat
+offset("TickCounter", "tickCounter", "int", "Fast", 3)
+-- Hash of this layout; Memory rejects frames painted by an addon generated from another schema
+offset("LayoutHash", "LAYOUT_HASH", "int", "Fast", 3)
+-- TickCounter again at the far end of the fast panel; a strip captured mid-repaint disagrees
+offset("TickCounterTail", "tickCounter", "int", "Fast", 0)
+-- GetTime() of the painted game frame in milliseconds, wrapping at 24 bits, for capture latency
+offset("GameTime", "gameTime", "int", "Fast", 3)
+
+-- Text values
+offset("GetZoneText", "GetZoneText()", "string", "Slow", 1)
+offset("GetSubZoneText", "GetSubZoneText()", "string", "Slow", 1)
+offset("UnitName__target", 'UnitName("target")', "string", "Fast", 1)
+offset("UnitName__player", 'UnitName("player")', "string", "Slow", 0)
+
+-- Mailbox streaming the string dictionary: the id and chunk shown, then three bytes per pixel
+offset("DictionaryGeneration", "mailbox.generation", "int", "Fast", 1)
+offset("MailboxHeader", "mailbox.header", "int", "Fast", 1)
+for i = 1, 6 do
+    offset("MailboxData_" .. i, string.format("mailbox.data[%d]", i), "int", "Fast", 1)
+end
+
+return offsets
@@ -0,0 +1,244 @@
+/**
+ * @file PartyQueries.cpp
+ * @brief Implementation of the party-wide SIMD queries.
+ *
+ * Percentages are computed as health * 100 / max in single precision. Lanes with a zero
+ * maximum divide by one instead and are masked out, matching the Lua helpers that never
+ * treat such a unit as hurt.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <cctype>
+#include <limits>
+#include <map>
+#include <string>
+#include "PartyQueries.h"
+#include "Memory.h"
+#ifdef MOMMYGLIDER_SSE2
+#include <emmintrin.h>
+#endif
+
+const char* const PartyView::UNIT_NAMES[PartyView::UNIT_COUNT] = { "player", "party1", "party2", "party3", "party4" };
+
+namespace {
+
+    struct UnitIndices {
+        int health[PartyView::UNIT_COUNT];
+        int healthMax[PartyView::UNIT_COUNT];
+    };
+
+    int offsetIndex(const std::string& key) {
+        auto it = Memory::offsetIndices.find(key);
+        return it == Memory::offsetIndices.end() ? -1 : it->second.index;
+    }
+
+    // Resolved on first use, once Memory has registered its offsets
+    const UnitIndices& unitIndices() {
+        static const UnitIndices indices = [] {
+            UnitIndices resolved;
+            for (int unit = 0; unit < PartyView::UNIT_COUNT; ++unit) {
+                resolved.health[unit] = offsetIndex(std::string("UnitHealth__") + PartyView::UNIT_NAMES[unit]);
+                resolved.healthMax[unit] = offsetIndex(std::string("UnitHealthMax__") + PartyView::UNIT_NAMES[unit]);
+            }
+            return resolved;
+        }();
+        return indices;
+    }
+
+    inline int lowestBit(uint32_t mask) {
+        int bit = 0;
+        while (!(mask & 1u)) {
+            mask >>= 1;
+            ++bit;
+        }
+        return bit;
+    }
+
+    constexpr uint32_t UNIT_MASK = (1u << PartyView::UNIT_COUNT) - 1;
+
+} // namespace
+
+PartyView::PartyView(const Snapshot& snapshot) : frame(snapshot) {
+    const UnitIndices& indices = unitIndices();
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        bool unit = lane < UNIT_COUNT;
+        health[lane] = unit && indices.health[lane] >= 0 ? static_cast<float>(snapshot.values[indices.health[lane]]) : 0.0f;
+        healthMax[lane] = unit && indices.healthMax[lane] >= 0 ? static_cast<float>(snapshot.values[indices.healthMax[lane]]) : 0.0f;
+    }
+}
+
+#ifdef MOMMYGLIDER_SSE2
+
+void PartyView::healthPercents(float* out) const {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 hundred = _mm_set1_ps(100.0f);
+    for (int lane = 0; lane < LANE_COUNT; lane += 4) {
+        __m128 h = _mm_load_ps(health + lane);
+        __m128 m = _mm_load_ps(healthMax + lane);
+        __m128 valid = _mm_and_ps(_mm_cmpgt_ps(h, zero), _mm_cmpneq_ps(m, zero));
+        __m128 divisor = _mm_or_ps(_mm_and_ps(valid, m), _mm_andnot_ps(valid, one));
+        __m128 percent = _mm_div_ps(_mm_mul_ps(h, hundred), divisor);
+        _mm_storeu_ps(out + lane, _mm_and_ps(valid, percent));
+    }
+}
+
+int PartyView::lowestHealthUnit(float& percent) const {
+    alignas(16) float percents[LANE_COUNT];
+    healthPercents(percents);
+
+    // Units that do not exist or have no maximum become +inf so they never win the minimum
+    const __m128 infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    const __m128 zero = _mm_setzero_ps();
+    __m128 low = _mm_load_ps(percents);
+    __m128 high = _mm_load_ps(percents + 4);
+    __m128 lowExists = _mm_and_ps(_mm_cmpgt_ps(_mm_load_ps(health), zero), _mm_cmpneq_ps(_mm_load_ps(healthMax), zero));
+    __m128 highExists = _mm_and_ps(_mm_cmpgt_ps(_mm_load_ps(health + 4), zero), _mm_cmpneq_ps(_mm_load_ps(healthMax + 4), zero));
+    low = _mm_or_ps(_mm_and_ps(lowExists, low), _mm_andnot_ps(lowExists, infinity));
+    high = _mm_or_ps(_mm_and_ps(highExists, high), _mm_andnot_ps(highExists, infinity));
+
+    __m128 minimum = _mm_min_ps(low, high);
+    minimum = _mm_min_ps(minimum, _mm_shuffle_ps(minimum, minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+    minimum = _mm_min_ps(minimum, _mm_shuffle_ps(minimum, minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    uint32_t exists = static_cast<uint32_t>(_mm_movemask_ps(lowExists) | (_mm_movemask_ps(highExists) << 4)) & UNIT_MASK;
+    if (!exists) {
+        return -1;
+    }
+    uint32_t matches = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpeq_ps(low, minimum)) |
+        (_mm_movemask_ps(_mm_cmpeq_ps(high, minimum)) << 4)) & exists;
+    int unit = lowestBit(matches);
+    percent = percents[unit];
+    return unit;
+}
+
+uint32_t PartyView::unitsBelowHealth(float threshold) const {
+    alignas(16) float percents[LANE_COUNT];
+    healthPercents(percents);
+
+    // healthPercents() zeroes invalid lanes, so mask them out again before comparing
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 limit = _mm_set1_ps(threshold);
+    uint32_t mask = 0;
+    for (int lane = 0; lane < LANE_COUNT; lane += 4) {
+        __m128 valid = _mm_and_ps(_mm_cmpgt_ps(_mm_load_ps(health + lane), zero),
+            _mm_cmpneq_ps(_mm_load_ps(healthMax + lane), zero));
+        __m128 below = _mm_and_ps(valid, _mm_cmplt_ps(_mm_load_ps(percents + lane), limit));
+        mask |= static_cast<uint32_t>(_mm_movemask_ps(below)) << lane;
+    }
+    return mask & UNIT_MASK;
+}
+
+uint32_t PartyView::unitsMissingAura(const AuraIndices& aura) const {
+    alignas(16) int32_t present[LANE_COUNT] = {};
+    for (int unit = 0; unit < UNIT_COUNT; ++unit) {
+        present[unit] = aura.index[unit] >= 0 ? frame.values[aura.index[unit]] : 0;
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t mask = 0;
+    for (int lane = 0; lane < LANE_COUNT; lane += 4) {
+        __m128i hasAura = _mm_cmpgt_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(present + lane)), zero);
+        mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(hasAura))) << lane;
+    }
+    return existingUnits() & ~mask;
+}
+
+uint32_t PartyView::existingUnits() const {
+    const __m128 zero = _mm_setzero_ps();
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(_mm_load_ps(health), zero)) |
+        (_mm_movemask_ps(_mm_cmpgt_ps(_mm_load_ps(health + 4), zero)) << 4));
+    return mask & UNIT_MASK;
+}
+
+#else // Scalar fallback
+
+void PartyView::healthPercents(float* out) const {
+    for (int lane = 0; lane < LANE_COUNT; ++lane) {
+        bool valid = health[lane] > 0.0f && healthMax[lane] != 0.0f;
+        out[lane] = valid ? health[lane] * 100.0f / healthMax[lane] : 0.0f;
+    }
+}
+
+int PartyView::lowestHealthUnit(float& percent) const {
+    float percents[LANE_COUNT];
+    healthPercents(percents);
+
+    int lowest = -1;
+    for (int unit = 0; unit < UNIT_COUNT; ++unit) {
+        bool valid = health[unit] > 0.0f && healthMax[unit] != 0.0f;
+        if (valid && (lowest < 0 || percents[unit] < percents[lowest])) {
+            lowest = unit;
+        }
+    }
+    if (lowest >= 0) {
+        percent = percents[lowest];
+    }
+    return lowest;
+}
+
+uint32_t PartyView::unitsBelowHealth(float threshold) const {
+    float percents[LANE_COUNT];
+    healthPercents(percents);
+
+    uint32_t mask = 0;
+    for (int unit = 0; unit < UNIT_COUNT; ++unit) {
+        if (health[unit] > 0.0f && healthMax[unit] != 0.0f && percents[unit] < threshold) {
+            mask |= 1u << unit;
+        }
+    }
+    return mask;
+}
+
+uint32_t PartyView::unitsMissingAura(const AuraIndices& aura) const {
+    uint32_t mask = 0;
+    for (int unit = 0; unit < UNIT_COUNT; ++unit) {
+        if (aura.index[unit] >= 0 && frame.values[aura.index[unit]] > 0) {
+            mask |= 1u << unit;
+        }
+    }
+    return existingUnits() & ~mask;
+}
+
+uint32_t PartyView::existingUnits() const {
+    uint32_t mask = 0;
+    for (int unit = 0; unit < UNIT_COUNT; ++unit) {
+        if (health[unit] > 0.0f) {
+            mask |= 1u << unit;
+        }
+    }
+    return mask;
+}
+
+#endif // MOMMYGLIDER_SSE2
+
+std::vector<int> PartyView::healthIndices() {
+    const UnitIndices& indices = unitIndices();
+    std::vector<int> result(indices.health, indices.health + UNIT_COUNT);
+    result.insert(result.end(), indices.healthMax, indices.healthMax + UNIT_COUNT);
+    return result;
+}
+
+const PartyView::AuraIndices& PartyView::auraIndices(std::string_view aura, bool harmful) {
+    thread_local std::map<std::string, AuraIndices, std::less<>> cache[2];
+    auto& entries = cache[harmful ? 1 : 0];
+
+    auto it = entries.find(aura);
+    if (it != entries.end()) {
+        return it->second;
+    }
+
+    std::string sanitized;
+    for (char c : aura) {
+        if (isalnum(static_cast<unsigned char>(c))) {
+            sanitized += c;
+        }
+    }
+    AuraIndices indices;
+    for (int unit = 0; unit < UNIT_COUNT; ++unit) {
+        indices.index[unit] = offsetIndex(std::string(harmful ? "UnitDebuff__" : "UnitBuff__") + UNIT_NAMES[unit] + "_" + sanitized);
+    }
+    return entries.emplace(std::string(aura), indices).first->second;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file PartyQueries.h
+ * @brief Bulk health and aura queries over the player and party1-4.
+ *
+ * A PartyView gathers the unit fields of one Snapshot into structure-of-arrays lanes and answers
+ * party-wide questions in a single pass, using SSE2 when the target has it and plain loops
+ * otherwise. Unit bit `i` of every mask refers to `PartyView::UNIT_NAMES[i]`.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef PARTYQUERIES_H
+#define PARTYQUERIES_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Snapshot.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MOMMYGLIDER_SSE2 1
+#endif
+
+/**
+ * @class PartyView
+ * @brief Structure-of-arrays view of the party units of one frame.
+ */
+class PartyView {
+public:
+    static constexpr int UNIT_COUNT = 5;   ///< player, party1-4
+    static constexpr int LANE_COUNT = 8;   ///< Two SSE registers; lanes past UNIT_COUNT never exist
+    static const char* const UNIT_NAMES[UNIT_COUNT];
+
+    /**
+     * @brief Offset indices of one aura on every party unit, -1 where the offset is missing.
+     */
+    struct AuraIndices {
+        int index[UNIT_COUNT];
+    };
+
+    /**
+     * @brief Gathers health and maximum health of every party unit.
+     * @param snapshot Frame to read; must outlive the view.
+     */
+    explicit PartyView(const Snapshot& snapshot);
+
+    /**
+     * @brief Health percentages, 0 for units that do not exist.
+     * @param out Receives LANE_COUNT values.
+     */
+    void healthPercents(float* out) const;
+
+    /**
+     * @brief Existing unit with the lowest health percentage; ties go to the earlier unit.
+     *
+     * Units reporting a zero maximum are skipped, as the Lua helpers never treat them as hurt.
+     * @param percent Receives the unit's health percentage.
+     * @return Unit index, or -1 if no unit qualifies.
+     */
+    int lowestHealthUnit(float& percent) const;
+
+    /**
+     * @brief Units that exist and are below the given health percentage.
+     */
+    uint32_t unitsBelowHealth(float threshold) const;
+
+    /**
+     * @brief Units that exist and do not have the aura.
+     */
+    uint32_t unitsMissingAura(const AuraIndices& aura) const;
+
+    /**
+     * @brief Units whose health is above zero.
+     */
+    uint32_t existingUnits() const;
+
+    /**
+     * @brief Resolves the buff or debuff offsets of an aura for every party unit.
+     *
+     * Results are cached per thread, so repeated queries do not rebuild offset names.
+     *
+     * @param aura Aura name as passed to UnitBuff/UnitDebuff.
+     * @param harmful True for debuffs.
+     */
+    static const AuraIndices& auraIndices(std::string_view aura, bool harmful);
+
+    /**
+     * @brief Health and maximum health offset indices every view reads, -1 where missing.
+     */
+    static std::vector<int> healthIndices();
+
+private:
+    alignas(16) float health[LANE_COUNT];
+    alignas(16) float healthMax[LANE_COUNT];
+    const Snapshot& frame;
+};
+
+#endif // PARTYQUERIES_H
@@ -0,0 +1,231 @@
+/**
+ * @file Profiler.cpp
+ * @brief Implementation of the Lua sampling profiler.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "Profiler.h"
+#include "MetricsServer.h"
+
+namespace {
+
+    uint64_t hashStack(const char* stack, size_t length) {
+        uint64_t hash = 1469598103934665603ull; // FNV-1a
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(stack[i])) * 1099511628211ull;
+        }
+        return hash ? hash : 1; // 0 marks a free slot
+    }
+
+} // namespace
+
+Profiler::~Profiler() {
+    stop();
+}
+
+bool Profiler::start(int hz) {
+    if (enabled.load()) {
+        return false;
+    }
+    // stop() waited for in-flight samples, so nothing writes the table while it is cleared
+    if (!table) {
+        table = std::make_unique<Slot[]>(TABLE_SIZE);
+    }
+    else {
+        for (size_t i = 0; i < TABLE_SIZE; ++i) {
+            table[i].ready.store(false, std::memory_order_relaxed);
+            table[i].count.store(0, std::memory_order_relaxed);
+            table[i].hash.store(0, std::memory_order_relaxed);
+        }
+    }
+    samples.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+
+    enabled.store(true);
+    samplerThread = std::thread(&Profiler::sampleLoop, this, 1000000000ll / hz);
+    return true;
+}
+
+void Profiler::stop() {
+    if (!enabled.exchange(false)) {
+        return;
+    }
+    if (samplerThread.joinable()) {
+        samplerThread.join();
+    }
+    pending.store(false, std::memory_order_relaxed);
+    while (samplers.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+void Profiler::sampleLoop(int64_t intervalNs) {
+    while (enabled.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(intervalNs));
+        pending.store(true, std::memory_order_relaxed);
+    }
+}
+
+void Profiler::sample(lua_State* L, const char* leaf) {
+    // Whichever thread sees the flag first takes the sample
+    if (!pending.exchange(false, std::memory_order_relaxed)) {
+        return;
+    }
+    samplers.fetch_add(1);
+    if (!enabled.load()) {
+        samplers.fetch_sub(1);
+        return;
+    }
+
+    char frames[MAX_DEPTH][128];
+    size_t lengths[MAX_DEPTH];
+    int depth = 0;
+    lua_Debug ar;
+    for (int level = 0; depth < MAX_DEPTH && lua_getstack(L, level, &ar); ++level) {
+        lua_getinfo(L, "Sn", &ar);
+        char* frame = frames[depth];
+        int written;
+        if (level == 0 && leaf) {
+            written = snprintf(frame, sizeof(frames[0]), "%s [C]", leaf);
+        }
+        else if (*ar.what == 'C') {
+            written = snprintf(frame, sizeof(frames[0]), "%s [C]", ar.name ? ar.name : "?");
+        }
+        else if (*ar.what == 'm') {
+            written = snprintf(frame, sizeof(frames[0]), "main (%s)", ar.short_src);
+        }
+        else {
+            written = snprintf(frame, sizeof(frames[0]), "%s (%s:%d)", ar.name ? ar.name : "?", ar.short_src, ar.linedefined);
+        }
+        size_t length = written < 0 ? 0 : (written < static_cast<int>(sizeof(frames[0])) ? written : sizeof(frames[0]) - 1);
+        // ';' separates frames in the folded format; chunk names of string scripts may contain one
+        for (size_t i = 0; i < length; ++i) {
+            if (frame[i] == ';') {
+                frame[i] = ',';
+            }
+        }
+        lengths[depth++] = length;
+    }
+
+    if (depth > 0) {
+        // Drop root frames until the rest fits; the leaf end is what the profile is about
+        int root = depth - 1;
+        size_t total = depth - 1;
+        for (int i = 0; i < depth; ++i) {
+            total += lengths[i];
+        }
+        while (total >= STACK_CHARS && root > 0) {
+            total -= lengths[root] + 1;
+            --root;
+        }
+
+        char stack[STACK_CHARS];
+        size_t length = 0;
+        for (int i = root; i >= 0 && length + lengths[i] < STACK_CHARS; --i) {
+            std::memcpy(stack + length, frames[i], lengths[i]);
+            length += lengths[i];
+            if (i > 0) {
+                stack[length++] = ';';
+            }
+        }
+        stack[length] = '\0';
+        record(stack, length);
+    }
+    samplers.fetch_sub(1);
+}
+
+void Profiler::record(const char* stack, size_t length) {
+    static constexpr size_t MAX_PROBES = 64;
+    uint64_t hash = hashStack(stack, length);
+
+    for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+        Slot& slot = table[(hash + probe) & (TABLE_SIZE - 1)];
+        uint64_t current = slot.hash.load(std::memory_order_acquire);
+        if (current == 0 && slot.hash.compare_exchange_strong(current, hash, std::memory_order_acq_rel)) {
+            std::memcpy(slot.stack, stack, length + 1);
+            slot.ready.store(true, std::memory_order_release);
+            current = hash;
+        }
+        // Otherwise `current` holds the hash of whoever owns the slot
+        if (current == hash) {
+            slot.count.fetch_add(1, std::memory_order_relaxed);
+            samples.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::writeFolded(std::ostream& out) const {
+    if (!table) {
+        return;
+    }
+    for (size_t i = 0; i < TABLE_SIZE; ++i) {
+        const Slot& slot = table[i];
+        if (!slot.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+        uint64_t count = slot.count.load(std::memory_order_relaxed);
+        if (count > 0) {
+            out << slot.stack << " " << count << "\n";
+        }
+    }
+}
+
+std::string Profiler::handleCommand(const std::string& arguments) {
+    std::istringstream command(arguments);
+    std::string verb;
+    command >> verb;
+
+    if (verb == "start") {
+        int hz = 1000;
+        command >> hz;
+        if (hz < 1 || hz > 10000) {
+            return "ERR sampling rate must be between 1 and 10000 Hz\n";
+        }
+        return start(hz) ? "OK profiling at " + std::to_string(hz) + " Hz\n" : "ERR profiler already running\n";
+    }
+
+    if (verb == "stop") {
+        stop();
+        return "OK " + std::to_string(samples.load(std::memory_order_relaxed)) + " samples\n";
+    }
+
+    if (verb == "dump") {
+        std::string path;
+        command >> path;
+        if (path.empty()) {
+            std::ostringstream out;
+            writeFolded(out);
+            return out.str();
+        }
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) {
+            return "ERR unable to write " + path + "\n";
+        }
+        writeFolded(file);
+        return "OK wrote " + path + "\n";
+    }
+
+    if (verb == "status") {
+        return std::string(running() ? "running" : "stopped") + " samples " + std::to_string(samples.load(std::memory_order_relaxed)) +
+            " dropped " + std::to_string(dropped.load(std::memory_order_relaxed)) + "\n";
+    }
+
+    return "ERR unknown profile command: " + verb + " (expected start [hz], stop, dump [path] or status)\n";
+}
+
+void Profiler::collectMetrics(MetricsWriter& metrics) const {
+    metrics.gauge("mommyglider_lua_profiler_running", "1 while the Lua sampling profiler is on.", running() ? 1.0 : 0.0);
+    metrics.counter("mommyglider_lua_profiler_samples_total", "Stacks recorded since the profiler was last started.",
+        static_cast<double>(samples.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_lua_profiler_dropped_samples_total", "Samples lost because the stack table was full.",
+        static_cast<double>(dropped.load(std::memory_order_relaxed)));
+}
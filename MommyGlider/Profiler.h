@@ -0,0 +1,108 @@
+/**
+ * @file Profiler.h
+ * @brief Sampling profiler for Lua scripts, producing folded stacks for flamegraph tools.
+ *
+ * A sampler thread raises a flag at the sampling rate; the engine's count hook and the binding
+ * trampoline check it and, when set, record the current Lua + C call stack. Stacks are counted
+ * in a fixed open-addressing table that writers claim with a CAS, so neither the tick thread nor
+ * the reload thread ever blocks on the socket thread dumping it. While stopped, the only cost is
+ * one relaxed load per hook call and binding call.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+extern "C" {
+#include "lua.h"
+}
+
+class MetricsWriter;
+
+/**
+ * @class Profiler
+ * @brief Timer-driven stack sampler with a lock-free aggregation table.
+ */
+class Profiler {
+public:
+    static constexpr size_t TABLE_SIZE = 4096;  ///< Distinct stacks kept; further ones are dropped
+    static constexpr size_t STACK_CHARS = 512;  ///< Longest folded stack; root frames are cut first
+    static constexpr int MAX_DEPTH = 64;        ///< Deepest stack walked
+
+    Profiler() = default;
+    ~Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * @brief Clears the previous profile and starts sampling.
+     * @param hz Samples per second.
+     * @return False if the profiler was already running.
+     */
+    bool start(int hz);
+
+    /**
+     * @brief Stops sampling; the profile stays available to writeFolded().
+     */
+    void stop();
+
+    bool running() const { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief True if a sample period elapsed since the last sample. Cheap enough for every hook call.
+     */
+    bool samplePending() const { return pending.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Drops a sample that came due while no script was running, e.g. while waiting for a frame.
+     */
+    void discardPending() { pending.store(false, std::memory_order_relaxed); }
+
+    /**
+     * @brief Records the stack of L if a sample is pending.
+     * @param leaf Name of the native binding running at level 0, or null inside a Lua function.
+     */
+    void sample(lua_State* L, const char* leaf);
+
+    /**
+     * @brief Writes one `root;...;leaf count` line per recorded stack.
+     */
+    void writeFolded(std::ostream& out) const;
+
+    /**
+     * @brief Executes a `profile` socket command: `start [hz]`, `stop`, `dump [path]` or `status`.
+     * @return Response text, ending in a newline.
+     */
+    std::string handleCommand(const std::string& arguments);
+
+    void collectMetrics(MetricsWriter& metrics) const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> hash{ 0 };        ///< 0 while free; claimed by the first writer
+        std::atomic<bool> ready{ false };       ///< Set once `stack` is written
+        std::atomic<uint64_t> count{ 0 };
+        char stack[STACK_CHARS];
+    };
+
+    void record(const char* stack, size_t length);
+    void sampleLoop(int64_t intervalNs);
+
+    std::unique_ptr<Slot[]> table;              ///< Allocated by the first start()
+    std::atomic<bool> enabled{ false };
+    std::atomic<bool> pending{ false };
+    std::atomic<int> samplers{ 0 };             ///< Threads inside sample(); start() waits for them
+    std::atomic<uint64_t> samples{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };         ///< Samples lost to a full table
+    std::thread samplerThread;
+};
+
+#endif // PROFILER_H
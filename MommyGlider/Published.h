@@ -0,0 +1,154 @@
+/**
+ * @file Published.h
+ * @brief Lock-free pointer to an immutable value that one writer replaces and readers borrow.
+ *
+ * The writer builds a new version and publishes it with a single exchange; readers borrow the
+ * current version through a hazard slot and keep it for as long as they need. Replaced versions
+ * are freed by the writer, on a later publish, once no hazard slot holds them. Neither side takes
+ * a lock, and readers never allocate.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef PUBLISHED_H
+#define PUBLISHED_H
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Published
+ * @brief Single-writer publication of `const T` versions with hazard-slot reclamation.
+ *
+ * Publishes must not overlap; any number of threads may read, at most MAX_READERS of them at
+ * the same time (a further reader waits for a slot).
+ */
+template <typename T>
+class Published {
+    struct Slot {
+        std::atomic<bool> claimed{ false };
+        std::atomic<const T*> pointer{ nullptr };
+    };
+
+public:
+    static constexpr int MAX_READERS = 4;
+
+    /**
+     * @brief Borrowed version; holds its hazard slot until destroyed or released.
+     */
+    class Reader {
+    public:
+        Reader() = default;
+        Reader(Reader&& other) noexcept : slot(other.slot), value(other.value) {
+            other.slot = nullptr;
+            other.value = nullptr;
+        }
+        Reader& operator=(Reader&& other) noexcept {
+            if (this != &other) {
+                release();
+                slot = other.slot;
+                value = other.value;
+                other.slot = nullptr;
+                other.value = nullptr;
+            }
+            return *this;
+        }
+        ~Reader() { release(); }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        const T* get() const { return value; }
+        const T* operator->() const { return value; }
+        const T& operator*() const { return *value; }
+        explicit operator bool() const { return value != nullptr; }
+
+        /**
+         * @brief Gives the version and the slot back; the writer may free the version afterwards.
+         */
+        void release() {
+            if (slot) {
+                slot->pointer.store(nullptr, std::memory_order_release);
+                slot->claimed.store(false, std::memory_order_release);
+                slot = nullptr;
+            }
+            value = nullptr;
+        }
+
+    private:
+        friend class Published;
+        Reader(Slot* readerSlot, const T* readerValue) : slot(readerSlot), value(readerValue) {}
+
+        Slot* slot = nullptr;
+        const T* value = nullptr;
+    };
+
+    Published() = default;
+    explicit Published(std::unique_ptr<const T> initial) : current(initial.release()) {}
+    ~Published() {
+        delete current.load(std::memory_order_relaxed);
+        for (const T* old : retired) {
+            delete old;
+        }
+    }
+    Published(const Published&) = delete;
+    Published& operator=(const Published&) = delete;
+
+    /**
+     * @brief Borrows the current version, which may be null if none was published.
+     */
+    Reader read() const {
+        while (true) {
+            for (Slot& slot : slots) {
+                if (slot.claimed.load(std::memory_order_relaxed) || slot.claimed.exchange(true, std::memory_order_acquire)) {
+                    continue;
+                }
+                // The writer checks the slots after its exchange; either it sees this hazard, or
+                // the check below sees its new version and the hazard moves on to that one
+                const T* value = current.load(std::memory_order_seq_cst);
+                while (true) {
+                    slot.pointer.store(value, std::memory_order_seq_cst);
+                    const T* again = current.load(std::memory_order_seq_cst);
+                    if (again == value) {
+                        return Reader(&slot, value);
+                    }
+                    value = again;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Replaces the current version and frees the replaced ones no reader still holds.
+     */
+    void publish(std::unique_ptr<const T> next) {
+        if (const T* previous = current.exchange(next.release(), std::memory_order_seq_cst)) {
+            retired.push_back(previous);
+        }
+        retired.erase(std::remove_if(retired.begin(), retired.end(), [this](const T* old) {
+            for (const Slot& slot : slots) {
+                if (slot.pointer.load(std::memory_order_seq_cst) == old) {
+                    return false;
+                }
+            }
+            delete old;
+            return true;
+        }), retired.end());
+    }
+
+    /**
+     * @brief Current version without a hazard slot. Only for the writer, which alone frees versions.
+     */
+    const T* latest() const { return current.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<const T*> current{ nullptr };
+    mutable Slot slots[MAX_READERS];
+    std::vector<const T*> retired;      ///< Replaced versions a reader may still hold; writer only
+};
+
+#endif // PUBLISHED_H
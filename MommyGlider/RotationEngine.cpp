@@ -0,0 +1,290 @@
+/**
+ * @file RotationEngine.cpp
+ * @brief Compiler and interpreter for native rotation programs.
+ *
+ * Programs mirror the checks of the Lua `addSpellRotation` closure in the same order and with
+ * the same edge cases: a unit exists when its health is above zero, "party" covers the player
+ * and party1-4, a buff or debuff without an offset never blocks the cast, and power ratios
+ * follow Lua's float division when the maximum is zero. Party rotations flagged `lowestHealth`
+ * try their candidates by ascending health instead of party order.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <cctype>
+#include <iostream>
+#include <limits>
+#include "RotationEngine.h"
+#include "Memory.h"
+#include "PartyQueries.h"
+
+namespace {
+
+    // Units a program can target, indexed by RotationInstruction::unit
+    constexpr const char* UNIT_NAMES[] = { "player", "party1", "party2", "party3", "party4", "target" };
+    constexpr uint8_t UNIT_PLAYER = 0;
+    constexpr uint8_t UNIT_PARTY_LAST = 4;
+    constexpr uint8_t UNIT_TARGET = 5;
+    constexpr size_t UNIT_SLOTS = sizeof(UNIT_NAMES) / sizeof(UNIT_NAMES[0]);
+
+    // Party unit ids double as PartyView lanes
+    static_assert(UNIT_PARTY_LAST + 1 == PartyView::UNIT_COUNT, "Party units must match PartyView");
+
+    std::string sanitize(const std::string& name) {
+        std::string sanitized;
+        for (char c : name) {
+            if (isalnum(static_cast<unsigned char>(c))) {
+                sanitized += c;
+            }
+        }
+        return sanitized;
+    }
+
+    // value / maximum * 100 as Lua computes it, including the zero-maximum cases
+    double percent(int value, int maximum) {
+        if (maximum == 0) {
+            if (value == 0) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            return value > 0 ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity();
+        }
+        return static_cast<double>(value) / maximum * 100.0;
+    }
+
+    bool optionNumber(lua_State* L, int optionsIndex, const char* field, double& value) {
+        lua_getfield(L, optionsIndex, field);
+        bool present = lua_isnumber(L, -1);
+        if (present) {
+            value = lua_tonumber(L, -1);
+        }
+        lua_pop(L, 1);
+        return present;
+    }
+
+    bool optionString(lua_State* L, int optionsIndex, const char* field, std::string& value) {
+        lua_getfield(L, optionsIndex, field);
+        bool present = lua_type(L, -1) == LUA_TSTRING;
+        if (present) {
+            value = lua_tostring(L, -1);
+        }
+        lua_pop(L, 1);
+        return present;
+    }
+
+    bool optionTruthy(lua_State* L, int optionsIndex, const char* field) {
+        lua_getfield(L, optionsIndex, field);
+        bool truthy = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+        return truthy;
+    }
+
+} // namespace
+
+std::vector<int> RotationProgram::offsetsRead() const {
+    std::vector<int> indices;
+    for (const RotationInstruction& instruction : program) {
+        if (instruction.a >= 0) {
+            indices.push_back(instruction.a);
+        }
+        if (instruction.b >= 0) {
+            indices.push_back(instruction.b);
+        }
+    }
+    return indices;
+}
+
+int RotationProgram::offsetIndex(const std::string& key) {
+    auto it = Memory::offsetIndices.find(key);
+    return it == Memory::offsetIndices.end() ? -1 : it->second.index;
+}
+
+void RotationProgram::emit(RotationInstruction::Op op, int a, int b, double threshold, uint8_t unit) {
+    program.push_back({ op, unit, a, b, threshold });
+}
+
+void RotationProgram::compile(lua_State* L, int optionsIndex, const std::string& spellName) {
+    using Op = RotationInstruction::Op;
+
+    optionsIndex = lua_absindex(L, optionsIndex);
+    spell = spellName;
+    program.clear();
+    unitBlocks.clear();
+    unitsBegin = 0;
+    lowestHealthFirst = false;
+
+    // Spell must be known unless the rotation is an item or macro
+    if (!optionTruthy(L, optionsIndex, "notKnownSpell")) {
+        int known = offsetIndex("IsSpellKnown__" + sanitize(spell));
+        if (known < 0) {
+            std::cerr << "Error: Cooldown function not found for IsSpellKnown__" << sanitize(spell) << "\n";
+            emit(Op::Fail);
+            unitsBegin = program.size();
+            return;
+        }
+        emit(Op::RequireSet, known);
+    }
+
+    // Player-specific checks
+    int power = offsetIndex("UnitPower__player");
+    int powerMax = offsetIndex("UnitPowerMax__player");
+    double threshold = 0.0;
+    if (optionTruthy(L, optionsIndex, "isMoving")) {
+        emit(Op::RequireSet, offsetIndex("IsPlayerMoving"));
+    }
+    if (optionNumber(L, optionsIndex, "minPower", threshold)) {
+        emit(Op::MinPercent, power, powerMax, threshold);
+    }
+    if (optionNumber(L, optionsIndex, "maxPower", threshold)) {
+        emit(Op::MaxPercent, power, powerMax, threshold);
+    }
+    if (optionTruthy(L, optionsIndex, "castingCheck")) {
+        emit(Op::RequireClear, offsetIndex("UnitCastingInfo__player"));
+    }
+    lua_getfield(L, optionsIndex, "condition");
+    if (!lua_isnil(L, -1)) {
+        emit(Op::CallCondition);
+    }
+    lua_pop(L, 1);
+    lua_getfield(L, optionsIndex, "notInCombat");
+    if (lua_isboolean(L, -1) && lua_toboolean(L, -1)) {
+        emit(Op::RequireClear, offsetIndex("UnitAffectingCombat__player"));
+    }
+    lua_pop(L, 1);
+
+    unitsBegin = program.size();
+
+    // Candidate units, unrolled so each block carries its own offset indices
+    std::string unit = "player";
+    optionString(L, optionsIndex, "unit", unit);
+    uint8_t firstUnit = UNIT_PLAYER;
+    uint8_t lastUnit = UNIT_PARTY_LAST;
+    if (unit == "player") {
+        lastUnit = UNIT_PLAYER;
+    }
+    else if (unit == "target") {
+        firstUnit = lastUnit = UNIT_TARGET;
+    }
+    else {
+        lowestHealthFirst = optionTruthy(L, optionsIndex, "lowestHealth");
+    }
+
+    double healthThreshold = 0.0;
+    double maxHealthThreshold = 0.0;
+    std::string buff;
+    std::string debuff;
+    bool hasHealthThreshold = optionNumber(L, optionsIndex, "healthThreshold", healthThreshold);
+    bool hasMaxHealthThreshold = optionNumber(L, optionsIndex, "maxHealthThreshold", maxHealthThreshold);
+    bool hasBuff = optionString(L, optionsIndex, "buff", buff);
+    bool hasDebuff = optionString(L, optionsIndex, "debuff", debuff);
+
+    for (uint8_t unitId = firstUnit; unitId <= lastUnit; ++unitId) {
+        std::string name = UNIT_NAMES[unitId];
+        int health = offsetIndex("UnitHealth__" + name);
+        int healthMax = offsetIndex("UnitHealthMax__" + name);
+
+        unitBlocks.push_back(static_cast<uint16_t>(program.size()));
+        emit(Op::BeginUnit, -1, -1, 0.0, unitId);
+        emit(Op::UnitExists, health);
+        if (hasHealthThreshold) {
+            emit(Op::UnitBelow, health, healthMax, healthThreshold);
+        }
+        if (hasMaxHealthThreshold) {
+            emit(Op::UnitAtLeast, health, healthMax, maxHealthThreshold);
+        }
+        // Missing aura offsets read as "not present", so they emit nothing
+        int aura = hasBuff ? offsetIndex("UnitBuff__" + name + "_" + sanitize(buff)) : -1;
+        if (aura >= 0) {
+            emit(Op::UnitClear, aura);
+        }
+        aura = hasDebuff ? offsetIndex("UnitDebuff__" + name + "_" + sanitize(debuff)) : -1;
+        if (aura >= 0) {
+            emit(Op::UnitClear, aura);
+        }
+        emit(Op::AcceptUnit, -1, -1, 0.0, unitId);
+    }
+}
+
+bool RotationProgram::check(const RotationInstruction& instruction, const int* values, lua_State* L, int conditionIndex) const {
+    using Op = RotationInstruction::Op;
+    auto valueAt = [values](int index) { return index >= 0 ? values[index] : 0; };
+
+    switch (instruction.op) {
+    case Op::RequireSet:
+        return valueAt(instruction.a) != 0;
+    case Op::RequireClear:
+        return valueAt(instruction.a) == 0;
+    case Op::MinPercent:
+        return !(percent(valueAt(instruction.a), valueAt(instruction.b)) < instruction.threshold);
+    case Op::MaxPercent:
+        return !(percent(valueAt(instruction.a), valueAt(instruction.b)) > instruction.threshold);
+    case Op::CallCondition:
+        if (conditionIndex != 0 && !lua_isnil(L, conditionIndex)) {
+            lua_pushvalue(L, conditionIndex);
+            lua_call(L, 0, 1);
+            bool passed = lua_toboolean(L, -1);
+            lua_pop(L, 1);
+            return passed;
+        }
+        return true;
+    case Op::UnitExists:
+        return valueAt(instruction.a) > 0;
+    case Op::UnitBelow:
+        return valueAt(instruction.b) != 0 &&
+            percent(valueAt(instruction.a), valueAt(instruction.b)) < instruction.threshold;
+    case Op::UnitAtLeast:
+        return percent(valueAt(instruction.a), valueAt(instruction.b)) >= instruction.threshold;
+    case Op::UnitClear:
+        return valueAt(instruction.a) <= 0;
+    default:
+        return false;
+    }
+}
+
+const char* RotationProgram::evaluate(const Snapshot& snapshot, lua_State* L, int conditionIndex) const {
+    using Op = RotationInstruction::Op;
+
+    // Player checks run up to the first unit block; any failure ends the program
+    for (size_t pc = 0; pc < unitsBegin; ++pc) {
+        if (!check(program[pc], snapshot.values, L, conditionIndex)) {
+            return nullptr;
+        }
+    }
+
+    // Candidate units in party order, or by ascending health for lowestHealth rotations
+    uint8_t order[UNIT_SLOTS];
+    size_t blockCount = unitBlocks.size();
+    for (size_t block = 0; block < blockCount; ++block) {
+        order[block] = static_cast<uint8_t>(block);
+    }
+    if (lowestHealthFirst) {
+        alignas(16) float percents[PartyView::LANE_COUNT];
+        PartyView(snapshot).healthPercents(percents);
+        auto key = [&](uint8_t block) {
+            // healthPercents() reports 0 only for units that cannot be healed; try those last
+            float value = percents[program[unitBlocks[block]].unit];
+            return value > 0.0f ? value : std::numeric_limits<float>::infinity();
+        };
+        for (size_t i = 1; i < blockCount; ++i) {
+            uint8_t block = order[i];
+            size_t j = i;
+            for (; j > 0 && key(order[j - 1]) > key(block); --j) {
+                order[j] = order[j - 1];
+            }
+            order[j] = block;
+        }
+    }
+
+    for (size_t i = 0; i < blockCount; ++i) {
+        for (size_t pc = unitBlocks[order[i]] + 1; pc < program.size(); ++pc) {
+            const RotationInstruction& instruction = program[pc];
+            if (instruction.op == Op::AcceptUnit) {
+                return UNIT_NAMES[instruction.unit];
+            }
+            if (!check(instruction, snapshot.values, L, conditionIndex)) {
+                break; // Next candidate
+            }
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file RotationEngine.h
+ * @brief Native evaluation of CoreRotations spell rotations.
+ *
+ * `CoreRotations:addSpellRotation` describes each rotation with a declarative option table
+ * (unit, healthThreshold, minPower, buff, debuff, notInCombat, castingCheck, lowestHealth...). A
+ * RotationProgram compiles that table once into a flat list of instructions whose offset
+ * indices are already resolved, and evaluates it against a decoded Snapshot without going
+ * through the per-call Lua bindings. Custom `condition` hooks stay in Lua and are called
+ * back at the same point of the check order as before.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef ROTATIONENGINE_H
+#define ROTATIONENGINE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+extern "C" {
+#include "lua.h"
+}
+#include "Snapshot.h"
+
+/**
+ * @brief One predicate of a compiled rotation.
+ */
+struct RotationInstruction {
+    enum class Op : uint8_t {
+        Fail,            ///< Unconditional failure (e.g. spell offset missing)
+        RequireSet,      ///< values[a] != 0
+        RequireClear,    ///< values[a] == 0
+        MinPercent,      ///< values[a] / values[b] * 100 >= threshold
+        MaxPercent,      ///< values[a] / values[b] * 100 <= threshold
+        CallCondition,   ///< Lua condition passed to EvaluateRotation must be truthy
+        BeginUnit,       ///< Start of a candidate unit; failures inside move to the next one
+        UnitExists,      ///< values[a] (health) > 0
+        UnitBelow,       ///< Health percent (a / b) below threshold, false when max is 0
+        UnitAtLeast,     ///< Health percent (a / b) at or above threshold
+        UnitClear,       ///< values[a] == 0, e.g. aura not present
+        AcceptUnit       ///< Success, target is UNIT_NAMES[unit]
+    };
+
+    Op op;
+    uint8_t unit;        ///< Unit id for BeginUnit/AcceptUnit
+    int a;               ///< First offset index
+    int b;               ///< Second offset index
+    double threshold;    ///< Percentage threshold
+};
+
+/**
+ * @class RotationProgram
+ * @brief Compiled form of one `addSpellRotation` option table.
+ */
+class RotationProgram {
+public:
+    /**
+     * @brief Compiles the option table at the given stack index.
+     * @param L Lua state holding the options.
+     * @param optionsIndex Stack index of the option table.
+     * @param spell Spell name the rotation casts.
+     */
+    void compile(lua_State* L, int optionsIndex, const std::string& spell);
+
+    /**
+     * @brief Evaluates the program against a decoded frame.
+     * @param snapshot Frame to read offsets from.
+     * @param L Lua state used to call the custom condition.
+     * @param conditionIndex Stack index of the custom condition, or 0 if none.
+     * @return Target unit name, or nullptr if the rotation is not ready.
+     */
+    const char* evaluate(const Snapshot& snapshot, lua_State* L, int conditionIndex) const;
+
+    /**
+     * @brief Name of the spell this program was compiled for.
+     */
+    const std::string& spellName() const { return spell; }
+
+    /**
+     * @brief Offset indices the program reads, possibly with duplicates.
+     */
+    std::vector<int> offsetsRead() const;
+
+private:
+    void emit(RotationInstruction::Op op, int a = -1, int b = -1, double threshold = 0.0, uint8_t unit = 0);
+    bool check(const RotationInstruction& instruction, const int* values, lua_State* L, int conditionIndex) const;
+    static int offsetIndex(const std::string& key);
+
+    std::string spell;
+    std::vector<RotationInstruction> program;
+    std::vector<uint16_t> unitBlocks;   ///< Index of each BeginUnit
+    size_t unitsBegin = 0;              ///< Instructions before this index are player checks
+    bool lowestHealthFirst = false;     ///< Try party units by ascending health
+};
+
+#endif // ROTATIONENGINE_H
@@ -0,0 +1,357 @@
+/**
+ * @file Scheduler.cpp
+ * @brief Implementation of the Lua coroutine scheduler.
+ *
+ * Tasks are identified by a slot index and a generation; the coroutine (or the periodic
+ * function) and any WaitUntil predicate live in two tables attached to the scheduler's
+ * userdata, which keeps them reachable for the Lua GC. Timers carry the generation they were
+ * created for, so a timer of a cancelled or finished task is simply ignored when it fires.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <iostream>
+#include <new>
+#include "Scheduler.h"
+#include "MetricsServer.h"
+#include "TickBudget.h"
+#include "Util.h"
+extern "C" {
+#include "lauxlib.h"
+}
+
+namespace {
+    // Registry key of the scheduler userdata; its address is the key
+    const char SCHEDULER_KEY = 0;
+
+    // User values of the scheduler userdata
+    constexpr int TASK_OBJECTS = 1;  // id -> coroutine or periodic function
+    constexpr int PREDICATES = 2;    // id -> WaitUntil predicate
+}
+
+Scheduler::Scheduler(SchedulerStats& schedulerStats) : stats(schedulerStats), timers(nowMs()) {
+    tasks.emplace_back(); // Slot 0 is never handed out, so 0 can mean "no task"
+}
+
+Scheduler* Scheduler::install(lua_State* L, SchedulerStats& stats) {
+    void* memoryBlock = lua_newuserdatauv(L, sizeof(Scheduler), 2);
+    Scheduler* scheduler = new (memoryBlock) Scheduler(stats);
+
+    lua_createtable(L, 0, 1);
+    lua_pushcfunction(L, destroy);
+    lua_setfield(L, -2, "__gc");
+    lua_setmetatable(L, -2);
+
+    lua_newtable(L);
+    lua_setiuservalue(L, -2, TASK_OBJECTS);
+    lua_newtable(L);
+    lua_setiuservalue(L, -2, PREDICATES);
+
+    lua_rawsetp(L, LUA_REGISTRYINDEX, &SCHEDULER_KEY);
+    return scheduler;
+}
+
+int Scheduler::destroy(lua_State* L) {
+    static_cast<Scheduler*>(lua_touserdata(L, 1))->~Scheduler();
+    return 0;
+}
+
+Scheduler* Scheduler::from(lua_State* L) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &SCHEDULER_KEY);
+    Scheduler* scheduler = static_cast<Scheduler*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+    return scheduler;
+}
+
+void Scheduler::pushStorage(lua_State* L, int slot) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &SCHEDULER_KEY);
+    lua_getiuservalue(L, -1, slot);
+    lua_remove(L, -2);
+}
+
+uint64_t Scheduler::nowMs() {
+    return static_cast<uint64_t>(monotonicNanos() / 1000000);
+}
+
+uint32_t Scheduler::allocateTask(TaskKind kind) {
+    uint32_t id;
+    if (!freeTasks.empty()) {
+        id = freeTasks.back();
+        freeTasks.pop_back();
+    }
+    else {
+        id = static_cast<uint32_t>(tasks.size());
+        tasks.emplace_back();
+    }
+    tasks[id].kind = kind;
+    tasks[id].waiting = false;
+    tasks[id].intervalMs = 0;
+    return id;
+}
+
+void Scheduler::finish(lua_State* L, uint32_t id) {
+    pushStorage(L, TASK_OBJECTS);
+    lua_pushnil(L);
+    lua_rawseti(L, -2, id);
+    lua_pop(L, 1);
+    pushStorage(L, PREDICATES);
+    lua_pushnil(L);
+    lua_rawseti(L, -2, id);
+    lua_pop(L, 1);
+
+    // Bumping the generation invalidates every timer and handle still pointing at the slot
+    tasks[id].kind = TaskKind::Free;
+    ++tasks[id].generation;
+    freeTasks.push_back(id);
+}
+
+bool Scheduler::spawn(lua_State* L, int nargs, uint64_t* handle) {
+    uint32_t id = allocateTask(TaskKind::Coroutine);
+    if (handle) {
+        *handle = handleFor(id, tasks[id].generation);
+    }
+
+    lua_State* thread = lua_newthread(L);
+    pushStorage(L, TASK_OBJECTS);
+    lua_pushvalue(L, -2);
+    lua_rawseti(L, -2, id);
+    lua_pop(L, 1);
+
+    // Leave the thread under the function while it runs, see resume()
+    lua_insert(L, -(nargs + 2));
+    lua_xmove(L, thread, nargs + 1);
+    bool succeeded = resume(L, thread, id, nargs);
+    lua_pop(L, 1);
+    return succeeded;
+}
+
+/**
+ * @brief Resumes a task. The caller keeps `thread` on the stack of L, so a task that cancels
+ *        itself is not collected while it is still running.
+ */
+bool Scheduler::resume(lua_State* L, lua_State* thread, uint32_t id, int nargs) {
+    uint32_t generation = tasks[id].generation;
+    tasks[id].waiting = false;
+
+    // Tasks may spawn tasks, so the running task is a stack
+    lua_State* previousThread = currentThread;
+    uint32_t previousTask = currentTask;
+    currentThread = thread;
+    currentTask = id;
+    int results = 0;
+    int status = lua_resume(thread, L, nargs, &results);
+    currentThread = previousThread;
+    currentTask = previousTask;
+    stats.resumes.fetch_add(1, std::memory_order_relaxed);
+
+    if (tasks[id].generation != generation) {
+        return true; // Cancelled itself while running
+    }
+    if (status == LUA_YIELD) {
+        lua_pop(thread, results);
+        // A bare coroutine.yield() waits for the next frame
+        if (!tasks[id].waiting) {
+            frameTimers.schedule(frame + 1, id, generation);
+        }
+        return true;
+    }
+
+    bool succeeded = status == LUA_OK;
+    if (!succeeded) {
+        luaL_traceback(L, thread, lua_tostring(thread, -1), 0);
+        std::cerr << "Lua task error: " << lua_tostring(L, -1) << "\n";
+        lua_pop(L, 1);
+        stats.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    finish(L, id);
+    return succeeded;
+}
+
+void Scheduler::run(lua_State* L, bool newFrame) {
+    auto collect = [this](const TimerWheel::Timer& timer) { due.push_back(timer); };
+
+    if (newFrame) {
+        ++frame;
+        frameTimers.advance(frame, collect);
+        wake(L, frameTimers);
+        pollPredicates(L);
+    }
+    timers.advance(nowMs(), collect);
+    wake(L, timers);
+    publishStats();
+}
+
+void Scheduler::wake(lua_State* L, TimerWheel& source) {
+    // Resumed tasks only schedule new timers, which never land in `due`
+    for (size_t i = 0; i < due.size(); ++i) {
+        TimerWheel::Timer timer = due[i];
+        Task& task = tasks[timer.task];
+        if (task.generation != timer.generation || task.kind == TaskKind::Free) {
+            continue; // Stale timer of a finished or cancelled task
+        }
+        if (TickBudget::exhausted()) {
+            // The tick ran out of budget; an expired deadline fires on the next advance
+            source.schedule(timer.deadline, timer.task, timer.generation);
+            continue;
+        }
+
+        pushStorage(L, TASK_OBJECTS);
+        lua_rawgeti(L, -1, timer.task);
+        lua_remove(L, -2);
+
+        if (task.kind == TaskKind::Coroutine) {
+            resume(L, lua_tothread(L, -1), timer.task, 0);
+            lua_pop(L, 1);
+            continue;
+        }
+
+        // Periodic callbacks run to completion on the tick thread; they may Spawn to wait
+        if (lua_pcall(L, 0, 0, 0) != LUA_OK) {
+            std::cerr << "Lua timer error: " << lua_tostring(L, -1) << "\n";
+            lua_pop(L, 1);
+            stats.errors.fetch_add(1, std::memory_order_relaxed);
+            if (tasks[timer.task].generation == timer.generation) {
+                finish(L, timer.task);
+            }
+            continue;
+        }
+        if (tasks[timer.task].generation == timer.generation) {
+            // Keep the period without bursting to catch up after a stall
+            uint64_t next = timer.deadline + tasks[timer.task].intervalMs;
+            uint64_t now = nowMs();
+            timers.schedule(next > now ? next : now + tasks[timer.task].intervalMs, timer.task, timer.generation);
+        }
+    }
+    due.clear();
+}
+
+void Scheduler::pollPredicates(lua_State* L) {
+    polling.swap(predicateWaiters);
+    for (const TimerWheel::Timer& waiter : polling) {
+        if (tasks[waiter.task].generation != waiter.generation) {
+            continue;
+        }
+        if (TickBudget::exhausted()) {
+            predicateWaiters.push_back(waiter);
+            continue;
+        }
+
+        pushStorage(L, PREDICATES);
+        lua_rawgeti(L, -1, waiter.task);
+        lua_remove(L, -2);
+        if (lua_pcall(L, 0, 1, 0) != LUA_OK) {
+            std::cerr << "Lua WaitUntil error: " << lua_tostring(L, -1) << "\n";
+            lua_pop(L, 1);
+            stats.errors.fetch_add(1, std::memory_order_relaxed);
+            if (tasks[waiter.task].generation == waiter.generation) {
+                finish(L, waiter.task);
+            }
+            continue;
+        }
+        bool ready = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+
+        if (tasks[waiter.task].generation != waiter.generation) {
+            continue; // The predicate cancelled its own task
+        }
+        if (!ready) {
+            predicateWaiters.push_back(waiter);
+            continue;
+        }
+
+        pushStorage(L, PREDICATES);
+        lua_pushnil(L);
+        lua_rawseti(L, -2, waiter.task);
+        lua_pop(L, 1);
+        pushStorage(L, TASK_OBJECTS);
+        lua_rawgeti(L, -1, waiter.task);
+        lua_remove(L, -2);
+        resume(L, lua_tothread(L, -1), waiter.task, 0);
+        lua_pop(L, 1);
+    }
+    polling.clear();
+}
+
+int64_t Scheduler::msUntilNextTimer() const {
+    uint64_t next = timers.nextExpiry();
+    if (next == UINT64_MAX) {
+        return -1;
+    }
+    uint64_t now = nowMs();
+    return next > now ? static_cast<int64_t>(next - now) : 0;
+}
+
+uint32_t Scheduler::runningTask(lua_State* L, const char* function) const {
+    if (L != currentThread) {
+        luaL_error(L, "%s must be called from a task started with Spawn", function);
+    }
+    return currentTask;
+}
+
+void Scheduler::waitFrames(lua_State* L, uint64_t frames) {
+    uint32_t id = runningTask(L, "WaitFrames");
+    tasks[id].waiting = true;
+    frameTimers.schedule(frame + (frames > 0 ? frames : 1), id, tasks[id].generation);
+}
+
+void Scheduler::sleep(lua_State* L, uint64_t ms) {
+    uint32_t id = runningTask(L, "Sleep");
+    tasks[id].waiting = true;
+    timers.schedule(nowMs() + ms, id, tasks[id].generation);
+}
+
+void Scheduler::waitUntil(lua_State* L, int predicateIndex) {
+    uint32_t id = runningTask(L, "WaitUntil");
+    predicateIndex = lua_absindex(L, predicateIndex);
+    pushStorage(L, PREDICATES);
+    lua_pushvalue(L, predicateIndex);
+    lua_rawseti(L, -2, id);
+    lua_pop(L, 1);
+
+    tasks[id].waiting = true;
+    predicateWaiters.push_back({ 0, id, tasks[id].generation });
+}
+
+uint64_t Scheduler::every(lua_State* L, uint64_t intervalMs, int functionIndex) {
+    functionIndex = lua_absindex(L, functionIndex);
+    uint32_t id = allocateTask(TaskKind::Repeating);
+    tasks[id].intervalMs = intervalMs > 0 ? intervalMs : 1;
+
+    pushStorage(L, TASK_OBJECTS);
+    lua_pushvalue(L, functionIndex);
+    lua_rawseti(L, -2, id);
+    lua_pop(L, 1);
+
+    timers.schedule(nowMs() + tasks[id].intervalMs, id, tasks[id].generation);
+    return handleFor(id, tasks[id].generation);
+}
+
+bool Scheduler::cancel(lua_State* L, uint64_t handle) {
+    uint32_t id = static_cast<uint32_t>(handle);
+    uint32_t generation = static_cast<uint32_t>(handle >> 32);
+    if (id == 0 || id >= tasks.size() || tasks[id].generation != generation || tasks[id].kind == TaskKind::Free) {
+        return false;
+    }
+    finish(L, id);
+    return true;
+}
+
+void Scheduler::publishStats() {
+    stats.tasks.store(tasks.size() - 1 - freeTasks.size(), std::memory_order_relaxed);
+    stats.timers.store(timers.size() + frameTimers.size(), std::memory_order_relaxed);
+    stats.waiters.store(predicateWaiters.size(), std::memory_order_relaxed);
+}
+
+void SchedulerStats::collectMetrics(MetricsWriter& metrics) const {
+    metrics.gauge("mommyglider_lua_tasks", "Live Lua tasks and periodic timers.",
+        static_cast<double>(tasks.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_lua_pending_timers", "Sleep, Every and WaitFrames timers waiting to fire, including stale ones.",
+        static_cast<double>(timers.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_lua_wait_until_tasks", "Tasks blocked in WaitUntil.",
+        static_cast<double>(waiters.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_lua_task_resumes_total", "Coroutine resumes performed by the scheduler.",
+        static_cast<double>(resumes.load(std::memory_order_relaxed)));
+    metrics.counter("mommyglider_lua_task_errors_total", "Tasks, WaitUntil predicates and Every callbacks that raised an error.",
+        static_cast<double>(errors.load(std::memory_order_relaxed)));
+}
@@ -0,0 +1,253 @@
+/**
+ * @file Scheduler.h
+ * @brief Coroutine scheduler for Lua behaviours.
+ *
+ * Scripts start long-running behaviours with `Spawn(fn)`; inside them `WaitFrames(n)`,
+ * `Sleep(ms)` and `WaitUntil(pred)` suspend the coroutine until the condition fires, and
+ * `Every(ms, fn)` calls a function periodically. Time and frame waits sit in hierarchical timer
+ * wheels, so a tick only touches the tasks that are actually due; `WaitUntil` predicates are
+ * polled once per captured frame, since game state cannot change in between.
+ *
+ * Each Lua state owns its scheduler, so a hot reload drops the old tasks together with the state.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+extern "C" {
+#include "lua.h"
+}
+
+class MetricsWriter;
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timer wheel with 64 slots per level.
+ *
+ * Level `l` holds timers due less than 64 level-`l` slots (of 64^l ticks each) ahead of the
+ * clock; a slot is re-sorted into lower levels when the clock enters it. Four levels cover
+ * 2^24 ticks (4.6 hours at 1 ms); anything further is parked in the top level and re-sorted
+ * when it comes around. The tick unit is up to the owner.
+ */
+class TimerWheel {
+public:
+    struct Timer {
+        uint64_t deadline;
+        uint32_t task;
+        uint32_t generation;
+    };
+
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+
+    explicit TimerWheel(uint64_t now = 0) : current(now) {}
+
+    /**
+     * @brief Adds a timer; deadlines in the past fire on the next advance.
+     */
+    void schedule(uint64_t deadline, uint32_t task, uint32_t generation) {
+        place({ deadline, task, generation }, current + 1);
+        ++count;
+    }
+
+    /**
+     * @brief Moves the clock to `now`, calling `fire(timer)` for every timer that expired.
+     *
+     * `fire` must not schedule into this wheel; collect the timers and handle them afterwards.
+     */
+    template <typename Fire>
+    void advance(uint64_t now, Fire&& fire) {
+        while (current < now) {
+            if (count == 0) {
+                current = now;
+                return;
+            }
+            ++current;
+            for (int level = LEVELS - 1; level > 0; --level) {
+                if ((current & ((1ull << (SLOT_BITS * level)) - 1)) == 0) {
+                    cascade(level);
+                }
+            }
+            std::vector<Timer>& slot = slots[0][current & (SLOTS - 1)];
+            for (const Timer& timer : slot) {
+                fire(timer);
+            }
+            count -= slot.size();
+            slot.clear();
+        }
+    }
+
+    /**
+     * @brief Earliest tick at which advance() may fire or re-sort something; UINT64_MAX if empty.
+     */
+    uint64_t nextExpiry() const {
+        if (count == 0) {
+            return UINT64_MAX;
+        }
+        uint64_t earliest = UINT64_MAX;
+        for (int level = 0; level < LEVELS; ++level) {
+            uint64_t base = current >> (SLOT_BITS * level);
+            for (uint64_t step = 1; step <= SLOTS; ++step) {
+                if (!slots[level][(base + step) & (SLOTS - 1)].empty()) {
+                    uint64_t at = (base + step) << (SLOT_BITS * level);
+                    earliest = at < earliest ? at : earliest;
+                    break;
+                }
+            }
+        }
+        return earliest;
+    }
+
+    size_t size() const { return count; }
+    uint64_t now() const { return current; }
+
+private:
+    void place(const Timer& timer, uint64_t earliest) {
+        uint64_t deadline = timer.deadline > earliest ? timer.deadline : earliest;
+        for (int level = 0; level < LEVELS; ++level) {
+            int shift = SLOT_BITS * level;
+            if ((deadline >> shift) - (current >> shift) < SLOTS) {
+                slots[level][(deadline >> shift) & (SLOTS - 1)].push_back(timer);
+                return;
+            }
+        }
+        // Beyond the top level: park in the slot the clock reaches last and re-sort from there
+        int top = SLOT_BITS * (LEVELS - 1);
+        slots[LEVELS - 1][((current >> top) - 1) & (SLOTS - 1)].push_back(timer);
+    }
+
+    void cascade(int level) {
+        std::vector<Timer>& slot = slots[level][(current >> (SLOT_BITS * level)) & (SLOTS - 1)];
+        if (slot.empty()) {
+            return;
+        }
+        scratch.swap(slot);
+        // Runs before the level-0 slot of `current` fires, so a deadline of `current` still fires now
+        for (const Timer& timer : scratch) {
+            place(timer, current);
+        }
+        scratch.clear();
+    }
+
+    std::vector<Timer> slots[LEVELS][SLOTS];
+    std::vector<Timer> scratch;
+    uint64_t current;
+    size_t count = 0;
+};
+
+/**
+ * @brief Scheduler counters, shared by the schedulers of every state the engine creates.
+ */
+struct SchedulerStats {
+    std::atomic<uint64_t> tasks{ 0 };      ///< Live tasks and periodic timers
+    std::atomic<uint64_t> timers{ 0 };     ///< Pending time and frame waits
+    std::atomic<uint64_t> waiters{ 0 };    ///< Tasks blocked in WaitUntil
+    std::atomic<uint64_t> resumes{ 0 };    ///< Coroutine resumes
+    std::atomic<uint64_t> errors{ 0 };     ///< Tasks, predicates and periodic callbacks that raised an error
+
+    void collectMetrics(MetricsWriter& metrics) const;
+};
+
+/**
+ * @class Scheduler
+ * @brief Runs Lua coroutines woken by time, frame and predicate conditions.
+ */
+class Scheduler {
+public:
+    /**
+     * @brief Creates the scheduler of a Lua state; it is destroyed when the state closes.
+     */
+    static Scheduler* install(lua_State* L, SchedulerStats& stats);
+
+    /**
+     * @brief Scheduler installed in the state (or any of its threads).
+     */
+    static Scheduler* from(lua_State* L);
+
+    /**
+     * @brief Starts the function below `nargs` arguments on top of the stack as a task and runs
+     *        it until its first wait. Pops the function and arguments.
+     * @param handle Receives the task handle, usable with cancel().
+     * @return False if the task raised an error before its first wait; it has been reported.
+     */
+    bool spawn(lua_State* L, int nargs, uint64_t* handle = nullptr);
+
+    /**
+     * @brief Resumes every task whose wait expired. Call once per loop of the tick thread.
+     * @param newFrame True when a new frame was captured since the last call.
+     */
+    void run(lua_State* L, bool newFrame);
+
+    /**
+     * @brief Milliseconds until the next timer may fire, or -1 if none is pending.
+     */
+    int64_t msUntilNextTimer() const;
+
+    /**
+     * @brief Registers a wait for the running task. The caller must then `return lua_yield(L, 0)`.
+     *
+     * Raise a Lua error if L is not the running task.
+     */
+    void waitFrames(lua_State* L, uint64_t frames);
+    void sleep(lua_State* L, uint64_t ms);
+    void waitUntil(lua_State* L, int predicateIndex);
+
+    /**
+     * @brief Calls the function at `functionIndex` every `intervalMs` until cancelled.
+     * @return Handle usable with cancel().
+     */
+    uint64_t every(lua_State* L, uint64_t intervalMs, int functionIndex);
+
+    /**
+     * @brief Stops a task or periodic timer.
+     * @return False if the handle no longer refers to a live task.
+     */
+    bool cancel(lua_State* L, uint64_t handle);
+
+private:
+    enum class TaskKind : uint8_t { Free, Coroutine, Repeating };
+
+    struct Task {
+        uint32_t generation = 1;
+        TaskKind kind = TaskKind::Free;
+        bool waiting = false;       ///< A wait was registered before the last yield
+        uint64_t intervalMs = 0;    ///< Period of Repeating tasks
+    };
+
+    explicit Scheduler(SchedulerStats& stats);
+
+    uint32_t allocateTask(TaskKind kind);
+    void finish(lua_State* L, uint32_t id);
+    bool resume(lua_State* L, lua_State* thread, uint32_t id, int nargs);
+    void wake(lua_State* L, TimerWheel& source);
+    void pollPredicates(lua_State* L);
+    uint32_t runningTask(lua_State* L, const char* function) const;
+    void publishStats();
+
+    static void pushStorage(lua_State* L, int slot);
+    static uint64_t nowMs();
+    static uint64_t handleFor(uint32_t id, uint32_t generation) { return (static_cast<uint64_t>(generation) << 32) | id; }
+
+    SchedulerStats& stats;
+    std::vector<Task> tasks;
+    std::vector<uint32_t> freeTasks;
+    TimerWheel timers;                          ///< Sleep and Every, in milliseconds
+    TimerWheel frameTimers;                     ///< WaitFrames, in captured frames
+    std::vector<TimerWheel::Timer> due;         ///< Timers that expired during this run
+    std::vector<TimerWheel::Timer> predicateWaiters;
+    std::vector<TimerWheel::Timer> polling;
+    uint64_t frame = 0;
+    lua_State* currentThread = nullptr;         ///< Task coroutine being resumed
+    uint32_t currentTask = 0;
+
+    static int destroy(lua_State* L);
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,67 @@
+/**
+ * @file ScriptWatcher.cpp
+ * @brief Implementation of the shared script watcher.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include "LuaEngine.h"
+#include "ScriptWatcher.h"
+
+ScriptWatcher::ScriptWatcher(const std::string& watchedDirectory, std::vector<LuaEngine*> watchedEngines)
+    : directory(watchedDirectory), engines(std::move(watchedEngines)) {
+    thread = std::thread(&ScriptWatcher::watch, this);
+    std::cout << "Watching " << directory << " for script changes.\n";
+}
+
+ScriptWatcher::~ScriptWatcher() {
+    stopping = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void ScriptWatcher::watch() {
+    auto scan = [this]() {
+        std::map<std::string, std::filesystem::file_time_type> files;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+            if (entry.is_regular_file(error) && entry.path().extension() == ".lua") {
+                files[entry.path().generic_string()] = entry.last_write_time(error);
+            }
+        }
+        return files;
+    };
+
+    auto loaded = scan();
+    auto previous = loaded;
+    while (!stopping) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+
+        for (LuaEngine* engine : engines) {
+            engine->closeRetiredState();
+        }
+
+        // Wait for two identical scans so a half-written file is not loaded
+        auto current = scan();
+        bool settled = current == previous;
+        previous = current;
+        if (!settled || current == loaded) {
+            continue;
+        }
+        loaded = current;
+
+        std::cout << "Script change detected, reloading.\n";
+        for (LuaEngine* engine : engines) {
+            if (stopping) {
+                break;
+            }
+            engine->reload();
+        }
+    }
+}
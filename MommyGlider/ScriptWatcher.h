@@ -0,0 +1,49 @@
+/**
+ * @file ScriptWatcher.h
+ * @brief Polls the script directory once for every client and rebuilds their Lua states on a change.
+ *
+ * One thread scans the .lua files below the directory every POLL_INTERVAL_MS. Once a change has
+ * settled for one scan, every engine builds a fresh state on this thread (LuaEngine::reload) and
+ * swaps it in between its ticks. The same thread closes the states the swaps replaced.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef SCRIPTWATCHER_H
+#define SCRIPTWATCHER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LuaEngine;
+
+/**
+ * @class ScriptWatcher
+ * @brief Shared hot-reload thread of the engines of one runtime.
+ */
+class ScriptWatcher {
+public:
+    static constexpr int POLL_INTERVAL_MS = 250;
+
+    /**
+     * @brief Starts watching. The engines must have executed their scripts and outlive the watcher.
+     * @param watchedDirectory Directory to watch, e.g. "Interface".
+     */
+    ScriptWatcher(const std::string& watchedDirectory, std::vector<LuaEngine*> watchedEngines);
+    ~ScriptWatcher();
+    ScriptWatcher(const ScriptWatcher&) = delete;
+    ScriptWatcher& operator=(const ScriptWatcher&) = delete;
+
+private:
+    void watch();
+
+    std::string directory;
+    std::vector<LuaEngine*> engines;
+    std::atomic<bool> stopping{ false };
+    std::thread thread;
+};
+
+#endif // SCRIPTWATCHER_H
@@ -0,0 +1,129 @@
+/**
+ * @file Snapshot.h
+ * @brief Fixed-layout decoded frame and a lock-free store for publishing it between threads.
+ *
+ * Every offset declared in Offsets.h owns one slot of a Snapshot, addressed by its index.
+ * The capture thread is the only writer of a SnapshotStore; any number of readers (Lua
+ * bindings, the metrics server) can read it without ever blocking the writer.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Number of slots required to hold every offset in Offsets.h (highest index + 1).
+ */
+constexpr int countOffsets() {
+    int count = 0;
+#define DEFINE_MEMORY_OFFSET(name, type, index, rate, column, bit) if ((index) + 1 > count) count = (index) + 1
+#include "Offsets.h"
+#undef DEFINE_MEMORY_OFFSET
+    return count;
+}
+
+constexpr int OFFSET_COUNT = countOffsets();
+
+/**
+ * @brief One decoded strip: every offset value plus the frame it came from.
+ */
+struct Snapshot {
+    uint64_t sequence;          ///< Frame number, starting at 1 for the first published frame
+    int64_t captureTimeNs;      ///< monotonicNanos() when the strip was copied from the screen
+    int values[OFFSET_COUNT];   ///< Decoded values, indexed by offset index
+};
+
+/**
+ * @class SnapshotStore
+ * @brief Single-writer sequence lock holding the most recently decoded frame.
+ *
+ * Writers never wait on readers. Single values are read with one relaxed load; full
+ * snapshots are copied and retried if the writer published in the middle of the copy.
+ */
+class SnapshotStore {
+public:
+    SnapshotStore() {
+        for (auto& value : values) {
+            value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Publishes a new frame. Must only be called from the capture thread.
+     * @param frameValues OFFSET_COUNT decoded values.
+     * @param timeNs Capture timestamp in monotonicNanos() units.
+     */
+    void publish(const int* frameValues, int64_t timeNs) {
+        uint64_t seq = sequenceLock.load(std::memory_order_relaxed);
+        sequenceLock.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        captureTimeNs.store(timeNs, std::memory_order_relaxed);
+        for (int i = 0; i < OFFSET_COUNT; ++i) {
+            values[i].store(frameValues[i], std::memory_order_relaxed);
+        }
+
+        sequenceLock.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies a consistent frame.
+     * @param out Destination snapshot.
+     * @return False if nothing has been published yet.
+     */
+    bool read(Snapshot& out) const {
+        for (;;) {
+            uint64_t before = sequenceLock.load(std::memory_order_acquire);
+            if (before == 0) {
+                return false;
+            }
+            if (before & 1) {
+                continue; // Writer is mid-publish
+            }
+
+            out.captureTimeNs = captureTimeNs.load(std::memory_order_relaxed);
+            for (int i = 0; i < OFFSET_COUNT; ++i) {
+                out.values[i] = values[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequenceLock.load(std::memory_order_relaxed) == before) {
+                out.sequence = before / 2;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Reads the latest value of a single offset without retrying.
+     */
+    int value(int index) const {
+        return values[index].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of frames published so far.
+     */
+    uint64_t sequence() const {
+        return sequenceLock.load(std::memory_order_acquire) / 2;
+    }
+
+    /**
+     * @brief Capture timestamp of the latest frame, or 0 if none was published.
+     */
+    int64_t lastCaptureTimeNs() const {
+        return captureTimeNs.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> sequenceLock{ 0 };  ///< Odd while a publish is in progress
+    std::atomic<int64_t> captureTimeNs{ 0 };
+    std::atomic<int> values[OFFSET_COUNT];
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,107 @@
+/**
+ * @file X11CaptureCheck.cpp
+ * @brief Paints known pixels on an X display and checks what X11Capture reads back.
+ *
+ * Run by x11_capture_check.sh against a fresh Xvfb. A window at the top-left corner of the root
+ * window is filled with one color per pixel; the check grabs it and compares every 0x00RRGGBB
+ * value, then grabs a rectangle reaching off screen, which must fail as a dropped frame instead of
+ * killing the process, and grabs the window again.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <X11/Xlib.h>
+#include "../X11Capture.h"
+
+namespace {
+
+    constexpr int WIDTH = 16;
+    constexpr int HEIGHT = 4;
+
+    // Distinct bytes in every channel, so swapped channels or rows show up
+    uint32_t expectedPixel(int x, int y) {
+        return (static_cast<uint32_t>(x * 16 + y) << 16) | (static_cast<uint32_t>(255 - x * 8) << 8)
+            | static_cast<uint32_t>(y * 60 + 3);
+    }
+
+    bool checkPixels(X11Capture& capture) {
+        if (!capture.copy(0, 0, WIDTH, HEIGHT, 0, 0)) {
+            std::cerr << "Error: Grab of the painted window failed.\n";
+            return false;
+        }
+        bool matched = true;
+        for (int y = 0; y < HEIGHT; ++y) {
+            for (int x = 0; x < WIDTH; ++x) {
+                uint32_t pixel = capture.pixels()[y * capture.stride() + x] & 0xFFFFFF;
+                if (pixel != expectedPixel(x, y)) {
+                    std::cerr << "Error: Pixel (" << x << ", " << y << ") is 0x" << std::hex << pixel
+                        << ", expected 0x" << expectedPixel(x, y) << std::dec << ".\n";
+                    matched = false;
+                }
+            }
+        }
+        return matched;
+    }
+
+} // namespace
+
+int main() {
+    Display* display = XOpenDisplay(nullptr);
+    if (!display) {
+        std::cerr << "Error: Unable to open $DISPLAY.\n";
+        return 1;
+    }
+    int screen = DefaultScreen(display);
+    if (DefaultDepth(display, screen) != 24) {
+        std::cerr << "Error: The check needs a 24-bit screen (Xvfb -screen 0 WxHx24).\n";
+        return 1;
+    }
+
+    // Override-redirect, so no window manager moves or decorates it
+    XSetWindowAttributes attributes = {};
+    attributes.override_redirect = True;
+    attributes.background_pixel = 0;
+    Window window = XCreateWindow(display, RootWindow(display, screen), 0, 0, WIDTH, HEIGHT, 0, CopyFromParent,
+        InputOutput, CopyFromParent, CWOverrideRedirect | CWBackPixel, &attributes);
+    XSelectInput(display, window, ExposureMask);
+    XMapRaised(display, window);
+    XEvent event;
+    do {
+        XNextEvent(display, &event);
+    } while (event.type != Expose);
+
+    // A 24-bit TrueColor pixel value is 0x00RRGGBB, the format the strips are decoded from
+    GC gc = XCreateGC(display, window, 0, nullptr);
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+            XSetForeground(display, gc, expectedPixel(x, y));
+            XDrawPoint(display, window, gc, x, y);
+        }
+    }
+    XSync(display, False);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    X11Capture capture;
+    bool passed = capture.open() && capture.resize(WIDTH, HEIGHT) && checkPixels(capture);
+
+    // Half of this rectangle is past the bottom-right corner: BadMatch, reported as a failed copy
+    int offX = DisplayWidth(display, screen) - WIDTH / 2;
+    int offY = DisplayHeight(display, screen) - HEIGHT / 2;
+    if (passed && capture.copy(offX, offY, WIDTH, HEIGHT, 0, 0)) {
+        std::cerr << "Error: An off-screen grab succeeded.\n";
+        passed = false;
+    }
+    // The failed grab must leave the backend usable
+    passed = passed && checkPixels(capture);
+
+    XFreeGC(display, gc);
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+    std::cout << (passed ? "X11 capture check passed.\n" : "X11 capture check FAILED.\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+#!/bin/sh
+# Builds X11CaptureCheck and runs it against a private Xvfb display.
+# Needs g++, Xvfb and the libX11/libXext development files.
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+out=${TMPDIR:-/tmp}/mommyglider-x11-check
+display=${CHECK_DISPLAY:-:97}
+
+g++ -std=c++17 -O2 -DMOMMYGLIDER_X11 -I"$here/.." \
+    "$here/X11CaptureCheck.cpp" "$here/../X11Capture.cpp" -lXext -lX11 -o "$out"
+
+Xvfb "$display" -screen 0 320x240x24 -nolisten tcp &
+xvfb=$!
+trap 'kill $xvfb 2>/dev/null; rm -f "$out"' EXIT
+# Wait for the server's socket
+for _ in 1 2 3 4 5 6 7 8 9 10; do
+    [ -S "/tmp/.X11-unix/X${display#:}" ] && break
+    sleep 0.5
+done
+
+DISPLAY=$display "$out"
@@ -0,0 +1,120 @@
+/**
+ * @file TickBudget.cpp
+ * @brief Implementation of the per-tick Lua budget.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#include <cstdio>
+#include "TickBudget.h"
+#include "MetricsServer.h"
+#include "Util.h"
+extern "C" {
+#include "lauxlib.h"
+}
+
+namespace {
+
+    struct ActiveBudget {
+        bool active = false;
+        bool exceeded = false;
+        uint64_t used = 0;
+        uint64_t instructionLimit = 0;
+        int64_t deadline = 0;
+        BudgetStats* stats = nullptr;
+        char location[256] = {};    ///< Where the overrun happened, repeated by every later abort
+    };
+
+    // The tick thread and the hot-reload watcher each run their own budgets
+    thread_local ActiveBudget budget;
+
+} // namespace
+
+TickBudget::Scope::Scope(const TickBudgetLimits& limits, BudgetStats& stats) : owner(!budget.active) {
+    if (!owner) {
+        return;
+    }
+    budget.active = true;
+    budget.exceeded = false;
+    budget.used = 0;
+    budget.instructionLimit = limits.instructions;
+    budget.deadline = monotonicNanos() + limits.timeNs;
+    budget.stats = &stats;
+}
+
+TickBudget::Scope::~Scope() {
+    if (!owner) {
+        return;
+    }
+    BudgetStats& stats = *budget.stats;
+    stats.lastInstructions.store(budget.used, std::memory_order_relaxed);
+    if (budget.used > stats.maxInstructions.load(std::memory_order_relaxed)) {
+        stats.maxInstructions.store(budget.used, std::memory_order_relaxed);
+    }
+    budget.active = false;
+    budget.exceeded = false;
+}
+
+bool TickBudget::exhausted() {
+    return budget.active && budget.exceeded;
+}
+
+void TickBudget::onCount(lua_State* L, lua_Debug* ar) {
+    int count = lua_gethookcount(L);
+    if (!budget.active || !budget.exceeded) {
+        // A thread left in per-instruction mode by an earlier overrun goes back to normal
+        if (count != HOOK_INTERVAL) {
+            lua_sethook(L, lua_gethook(L), lua_gethookmask(L), HOOK_INTERVAL);
+        }
+        if (!budget.active) {
+            return;
+        }
+    }
+
+    if (budget.exceeded) {
+        luaL_error(L, "tick budget exceeded at %s", budget.location);
+    }
+
+    budget.used += static_cast<uint64_t>(count);
+    if (budget.used <= budget.instructionLimit && monotonicNanos() <= budget.deadline) {
+        return;
+    }
+
+    budget.exceeded = true;
+    lua_getinfo(L, "nSl", ar);
+    snprintf(budget.location, sizeof(budget.location), "%s:%d (%s)", ar->short_src, ar->currentline, ar->name ? ar->name : "?");
+    budget.stats->exceeded.fetch_add(1, std::memory_order_relaxed);
+    budget.stats->recordOffender(budget.location);
+
+    // From here on every instruction raises, so the abort escapes any pcall in the loop
+    lua_sethook(L, lua_gethook(L), lua_gethookmask(L), 1);
+    luaL_error(L, "tick budget exceeded at %s", budget.location);
+}
+
+void BudgetStats::recordOffender(const std::string& location) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++offenders[location];
+}
+
+void BudgetStats::collectMetrics(MetricsWriter& metrics) const {
+    metrics.counter("mommyglider_lua_budget_exceeded_total", "Ticks aborted because scripts exceeded the instruction or time budget.",
+        static_cast<double>(exceeded.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_lua_tick_instructions", "Lua instructions executed by the last budgeted call.",
+        static_cast<double>(lastInstructions.load(std::memory_order_relaxed)));
+    metrics.gauge("mommyglider_lua_tick_instructions_max", "Most Lua instructions executed by one budgeted call.",
+        static_cast<double>(maxInstructions.load(std::memory_order_relaxed)));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& [location, count] : offenders) {
+        std::string escaped;
+        for (char c : location) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        metrics.counter("mommyglider_lua_budget_offender_total", "Budget overruns by the function and line that was running.",
+            static_cast<double>(count), "location=\"" + escaped + "\"");
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file TickBudget.h
+ * @brief Per-tick instruction and time budget for Lua code.
+ *
+ * The engine installs a count hook in every Lua state. While a TickBudget::Scope is open on the
+ * current thread, each hook call charges the executed instructions and checks the clock; once
+ * either limit is crossed the running function is aborted with a Lua error, and the hook fires on
+ * every instruction until the scope closes, so a `pcall` inside the runaway loop cannot swallow
+ * the abort. Outside a scope the hook returns immediately.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef TICKBUDGET_H
+#define TICKBUDGET_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+extern "C" {
+#include "lua.h"
+}
+
+class MetricsWriter;
+
+/**
+ * @brief Limits applied to one tick.
+ */
+struct TickBudgetLimits {
+    uint64_t instructions;  ///< VM instructions, counted in steps of TickBudget::HOOK_INTERVAL
+    int64_t timeNs;         ///< Wall time
+};
+
+/**
+ * @brief Budget usage and the places where scripts overran it.
+ */
+struct BudgetStats {
+    std::atomic<uint64_t> exceeded{ 0 };            ///< Ticks aborted for exceeding the budget
+    std::atomic<uint64_t> lastInstructions{ 0 };    ///< Instructions used by the last budgeted call
+    std::atomic<uint64_t> maxInstructions{ 0 };     ///< Most instructions used by one budgeted call
+
+    /**
+     * @brief Counts an overrun at the given location, e.g. "Interface/main.lua:42 (canDrink)".
+     */
+    void recordOffender(const std::string& location);
+
+    void collectMetrics(MetricsWriter& metrics) const;
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, uint64_t> offenders;
+};
+
+/**
+ * @class TickBudget
+ * @brief Thread-local budget enforcement driven by the engine's count hook.
+ */
+class TickBudget {
+public:
+    static constexpr int HOOK_INTERVAL = 1000; ///< Instructions between count hook calls
+
+    /**
+     * @brief Opens a budget for the current thread. Nested scopes join the outer one.
+     */
+    class Scope {
+    public:
+        Scope(const TickBudgetLimits& limits, BudgetStats& stats);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        bool owner;
+    };
+
+    /**
+     * @brief Called from the engine's hook dispatcher on LUA_HOOKCOUNT. May raise a Lua error.
+     */
+    static void onCount(lua_State* L, lua_Debug* ar);
+
+    /**
+     * @brief True once the open budget has been exceeded; remaining work should be deferred.
+     */
+    static bool exhausted();
+};
+
+#endif // TICKBUDGET_H
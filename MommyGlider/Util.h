@@ -31,6 +31,8 @@
 #include "CalibrationData.h"
 #include <iostream>
 #include <utility>
+#include <chrono>
+#include <cstdint>
 
  // Constants for scaling
 constexpr float UI_SCALE_FACTOR = 0.53333333; // Magic constant for UI scaling
@@ -96,4 +98,14 @@ inline std::pair<float, float> translateToUICoords(int screenX, int screenY, con
     return { uiX, uiY };
 }
 
+/**
+ * @brief Reads a monotonic clock shared by capture, scripting and metrics timestamps.
+ *
+ * @return Nanoseconds since an arbitrary fixed point; only differences are meaningful.
+ */
+inline int64_t monotonicNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 #endif // UTIL_H
@@ -0,0 +1,202 @@
+/**
+ * @file X11Capture.cpp
+ * @brief Implementation of the X11 MIT-SHM capture backend.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifdef MOMMYGLIDER_X11
+
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include "X11Capture.h"
+
+namespace {
+
+    // Xlib sends protocol errors to one process-wide handler whose default exits the process. A
+    // display is only used by its capture thread, which is also the thread its errors arrive on, so
+    // the trap is thread-local; errors of other displays go on to the previous handler.
+    XErrorHandler previousHandler = nullptr;
+    std::once_flag handlerInstalled;
+    thread_local Display* trappedDisplay = nullptr;
+    thread_local int trappedError = Success;
+
+    int recordError(Display* display, XErrorEvent* event) {
+        if (display == trappedDisplay) {
+            trappedError = event->error_code;
+            return 0;
+        }
+        return previousHandler ? previousHandler(display, event) : 0;
+    }
+
+    /**
+     * @brief Records the X errors of `display` raised until it is destroyed, instead of exiting.
+     *
+     * Errors arrive asynchronously: call XSync before failed() so every request sent under the
+     * trap has been answered.
+     */
+    class ErrorTrap {
+    public:
+        explicit ErrorTrap(Display* display) {
+            trappedDisplay = display;
+            trappedError = Success;
+        }
+        ~ErrorTrap() { trappedDisplay = nullptr; }
+        ErrorTrap(const ErrorTrap&) = delete;
+        ErrorTrap& operator=(const ErrorTrap&) = delete;
+
+        bool failed() const { return trappedError != Success; }
+    };
+
+} // namespace
+
+struct X11Capture::State {
+    Display* display = nullptr;
+    Window root = 0;
+    Visual* visual = nullptr;
+    int depth = 0;
+    XShmSegmentInfo segment = {};
+    size_t segmentSize = 0;             ///< Bytes, 0 while no segment is attached
+    std::vector<XImage*> images;        ///< One header per size, all over `segment`
+};
+
+// Constructor
+X11Capture::X11Capture(const std::string& display) : displayName(display), state(std::make_unique<State>()) {}
+
+// Destructor
+X11Capture::~X11Capture() {
+    releaseSegment();
+    if (state->display) {
+        XCloseDisplay(state->display);
+    }
+}
+
+bool X11Capture::open() {
+    state->display = XOpenDisplay(displayName.empty() ? nullptr : displayName.c_str());
+    if (!state->display) {
+        std::cerr << "Error: Unable to open X display " << (displayName.empty() ? "$DISPLAY" : displayName) << ".\n";
+        return false;
+    }
+    if (!XShmQueryExtension(state->display)) {
+        std::cerr << "Error: The X server does not support MIT-SHM.\n";
+        return false;
+    }
+    std::call_once(handlerInstalled, []() { previousHandler = XSetErrorHandler(recordError); });
+    state->root = DefaultRootWindow(state->display);
+    XWindowAttributes attributes;
+    XGetWindowAttributes(state->display, state->root, &attributes);
+    state->visual = attributes.visual;
+    state->depth = attributes.depth;
+    return true;
+}
+
+/**
+ * @brief Attaches a segment of at least width x height 32-bit pixels, keeping the current one if it is large enough.
+ *
+ * @return False if it could not be created or attached; the error has been reported.
+ */
+bool X11Capture::resize(int width, int height) {
+    size_t needed = static_cast<size_t>(width) * height * sizeof(uint32_t);
+    if (state->segmentSize >= needed) {
+        return true;
+    }
+    releaseSegment();
+
+    XShmSegmentInfo& segment = state->segment;
+    segment.shmid = shmget(IPC_PRIVATE, needed, IPC_CREAT | 0600);
+    if (segment.shmid < 0) {
+        std::cerr << "Error: Unable to create a " << width << "x" << height << " shared capture buffer.\n";
+        return false;
+    }
+    segment.shmaddr = static_cast<char*>(shmat(segment.shmid, nullptr, 0));
+    segment.readOnly = False;
+    // A remote X server cannot reach the segment and answers the attach with BadAccess
+    ErrorTrap trap(state->display);
+    bool attached = segment.shmaddr != reinterpret_cast<char*>(-1) && XShmAttach(state->display, &segment);
+    XSync(state->display, False);
+    attached = attached && !trap.failed();
+    // Freed by the system once both this process and the X server have detached
+    shmctl(segment.shmid, IPC_RMID, nullptr);
+    if (!attached) {
+        std::cerr << "Error: Unable to share the capture buffer with the X server.\n";
+        if (segment.shmaddr != reinterpret_cast<char*>(-1)) {
+            shmdt(segment.shmaddr);
+        }
+        segment = {};
+        return false;
+    }
+    state->segmentSize = needed;
+    return true;
+}
+
+bool X11Capture::copy(int x, int y, int width, int height, int bufferX, int bufferY) {
+    if (bufferX != 0 || bufferY != 0 || state->segmentSize < static_cast<size_t>(width) * height * sizeof(uint32_t)) {
+        return false;
+    }
+
+    // Image headers are created once per size; the pixels always land at the start of the segment
+    XImage* image = nullptr;
+    for (XImage* candidate : state->images) {
+        if (candidate->width == width && candidate->height == height) {
+            image = candidate;
+            break;
+        }
+    }
+    if (!image) {
+        if (state->images.size() >= MAX_IMAGE_SIZES) {
+            for (XImage* old : state->images) {
+                XDestroyImage(old);
+            }
+            state->images.clear();
+        }
+        image = XShmCreateImage(state->display, state->visual, state->depth, ZPixmap, state->segment.shmaddr,
+            &state->segment, width, height);
+        if (!image || image->bits_per_pixel != 32) {
+            std::cerr << "Error: The X display is not a 32-bit visual; MIT-SHM capture needs one.\n";
+            if (image) {
+                XDestroyImage(image);
+            }
+            return false;
+        }
+        state->images.push_back(image);
+    }
+
+    // A rectangle reaching outside the root window is a BadMatch; the frame is dropped, not the process
+    ErrorTrap trap(state->display);
+    bool grabbed = XShmGetImage(state->display, state->root, image, x, y, AllPlanes);
+    XSync(state->display, False);
+    if (!grabbed || trap.failed()) {
+        return false;
+    }
+    currentStride = image->bytes_per_line / static_cast<int>(sizeof(uint32_t));
+    return true;
+}
+
+const uint32_t* X11Capture::pixels() const {
+    return state->segmentSize ? reinterpret_cast<const uint32_t*>(state->segment.shmaddr) : nullptr;
+}
+
+void X11Capture::releaseSegment() {
+    // MIT-SHM images only free their header; the segment is detached below
+    for (XImage* image : state->images) {
+        XDestroyImage(image);
+    }
+    state->images.clear();
+    if (state->segmentSize) {
+        XShmDetach(state->display, &state->segment);
+        XSync(state->display, False);
+        shmdt(state->segment.shmaddr);
+        state->segment = {};
+        state->segmentSize = 0;
+    }
+    currentStride = 0;
+}
+
+#endif // MOMMYGLIDER_X11
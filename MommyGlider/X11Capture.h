@@ -0,0 +1,63 @@
+/**
+ * @file X11Capture.h
+ * @brief Capture backend reading an X11 display through a MIT-SHM segment.
+ *
+ * When the game runs under Wine, GDI screen copies go through Wine's emulation of them. This
+ * backend reads the root window straight from the X server with XShmGetImage, into a shared
+ * memory segment attached once and reused for every frame. Built when MOMMYGLIDER_X11 is
+ * defined (a Winelib or native Linux build linked with -lX11 -lXext). Tests/x11_capture_check.sh
+ * checks it against an Xvfb display.
+ *
+ * @license MIT
+ * @author [Your Name]
+ */
+
+#ifndef X11CAPTURE_H
+#define X11CAPTURE_H
+
+#ifdef MOMMYGLIDER_X11
+
+#include <memory>
+#include <string>
+#include "CaptureBackend.h"
+
+/**
+ * @class X11Capture
+ * @brief XShmGetImage of the strip rectangle from the root window of an X display.
+ *
+ * XShmGetImage always fills a whole image, so regions of interest are not copied on their own.
+ * One image header is kept per rectangle size seen (the fast panel alone, or with the slow one),
+ * all of them over the same segment.
+ */
+class X11Capture : public CaptureBackend {
+public:
+    static constexpr size_t MAX_IMAGE_SIZES = 8; ///< Image headers kept before they are recreated
+
+    /**
+     * @param display X display name, or empty for $DISPLAY.
+     */
+    explicit X11Capture(const std::string& display = "");
+    ~X11Capture() override;
+    X11Capture(const X11Capture&) = delete;
+    X11Capture& operator=(const X11Capture&) = delete;
+
+    const char* name() const override { return "x11"; }
+    bool open() override;
+    bool resize(int width, int height) override;
+    bool copy(int x, int y, int width, int height, int bufferX, int bufferY) override;
+    bool copiesRegions() const override { return false; }
+    const uint32_t* pixels() const override;
+    int stride() const override { return currentStride; }
+
+private:
+    struct State;   ///< Xlib handles, kept out of this header so its macros do not leak
+    void releaseSegment();
+
+    std::string displayName;
+    std::unique_ptr<State> state;
+    int currentStride = 0;              ///< Pixels per row of the image copied last
+};
+
+#endif // MOMMYGLIDER_X11
+
+#endif // X11CAPTURE_H